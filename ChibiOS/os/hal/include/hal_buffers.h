@@ -105,6 +105,11 @@ struct io_buffers_queue {
    * @brief   Boundary for R/W sequential access.
    */
   uint8_t               *top;
+  /**
+   * @brief   The current buffer is lent to the application.
+   * @note    A lent output buffer is not flushed by @p obqTryFlushI().
+   */
+  bool                  lent;
   /**
    * @brief   Data notification callback.
    */
@@ -152,6 +157,28 @@ typedef io_buffers_queue_t output_buffers_queue_t;
  */
 #define bqSizeX(bqp) ((bqp)->bn)
 
+/**
+ * @brief   Returns the size of the queue's buffers.
+ *
+ * @param[in] bqp       pointer to an @p io_buffers_queue_t structure
+ * @return              The usable size of each buffer.
+ *
+ * @xclass
+ */
+#define bqBufferSizeX(bqp) ((bqp)->bsize - sizeof (size_t))
+
+/**
+ * @brief   Returns the data pending in the partially filled output buffer.
+ *
+ * @param[in] obqp      pointer to an @p output_buffers_queue_t structure
+ * @return              The amount of data written in the current buffer.
+ *
+ * @iclass
+ */
+#define obqGetPendingI(obqp)                                                \
+  ((obqp)->ptr == NULL ? (size_t)0 :                                        \
+   ((size_t)(obqp)->ptr - (size_t)(obqp)->bwrptr) - sizeof (size_t))
+
 /**
  * @brief   Return the ready buffers number.
  * @details Returns the number of filled buffers if used on an input queue
@@ -292,6 +319,9 @@ extern "C" {
   msg_t ibqGetTimeout(input_buffers_queue_t *ibqp, systime_t timeout);
   size_t ibqReadTimeout(input_buffers_queue_t *ibqp, uint8_t *bp,
                         size_t n, systime_t timeout);
+  size_t ibqBorrowTimeout(input_buffers_queue_t *ibqp, uint8_t **bpp,
+                          systime_t timeout);
+  void ibqReturn(input_buffers_queue_t *ibqp, size_t n);
   void obqObjectInit(output_buffers_queue_t *obqp, bool suspended, uint8_t *bp,
                      size_t size, size_t n, bqnotify_t onfy, void *link);
   void obqResetI(output_buffers_queue_t *obqp);
@@ -308,6 +338,9 @@ extern "C" {
                       systime_t timeout);
   size_t obqWriteTimeout(output_buffers_queue_t *obqp, const uint8_t *bp,
                          size_t n, systime_t timeout);
+  size_t obqBorrowTimeout(output_buffers_queue_t *obqp, uint8_t **bpp,
+                          systime_t timeout);
+  void obqReturn(output_buffers_queue_t *obqp, size_t n);
   bool obqTryFlushI(output_buffers_queue_t *obqp);
   void obqFlush(output_buffers_queue_t *obqp);
 #ifdef __cplusplus
@@ -36,6 +36,33 @@
 #define Q_FULL          MSG_TIMEOUT /**< @brief Queue full,                 */
 /** @} */
 
+/**
+ * @brief   Maximum amount of data moved within a single critical zone.
+ * @details @p iqReadTimeout() and @p oqWriteTimeout() copy contiguous
+ *          segments of at most this size, then give a preemption chance.
+ * @note    Not used in SPSC mode, the copies are done unlocked.
+ */
+#if !defined(HAL_QUEUES_CHUNK_SIZE) || defined(__DOXYGEN__)
+#define HAL_QUEUES_CHUNK_SIZE           64U
+#endif
+
+/**
+ * @brief   Single producer single consumer queues.
+ * @details Each side of a queue only advances its own free running index,
+ *          moving data needs no critical zone. The lock is only taken in
+ *          order to wait, to wake up a waiting thread or to invoke the
+ *          notification callback.
+ * @note    A queue must have exactly one reader and one writer, the buffer
+ *          sizes must be powers of two.
+ * @note    The reader and the writer must run on the same core, for example
+ *          a thread and an ISR. The indexes are only ordered against the
+ *          data by a compiler barrier, there is no memory barrier between
+ *          cores.
+ */
+#if !defined(HAL_QUEUES_USE_SPSC) || defined(__DOXYGEN__)
+#define HAL_QUEUES_USE_SPSC             FALSE
+#endif
+
 /**
  * @brief   Type of a generic I/O queue structure.
  */
@@ -58,12 +85,25 @@ typedef void (*qnotify_t)(io_queue_t *qp);
  */
 struct io_queue {
   threads_queue_t       q_waiting;  /**< @brief Queue of waiting threads.   */
+#if (HAL_QUEUES_USE_SPSC == TRUE) || defined(__DOXYGEN__)
+  volatile size_t       q_added;    /**< @brief Resources added, only
+                                         advanced by the side adding them,
+                                         the difference with @p q_removed
+                                         is the resources counter.          */
+  volatile size_t       q_removed;  /**< @brief Resources removed, only
+                                         advanced by the side removing
+                                         them.                              */
+  volatile unsigned     q_sleepers; /**< @brief Threads in @p q_waiting.    */
+#else
   volatile size_t       q_counter;  /**< @brief Resources counter.          */
+#endif
   uint8_t               *q_buffer;  /**< @brief Pointer to the queue buffer.*/
   uint8_t               *q_top;     /**< @brief Pointer to the first
                                          location after the buffer.         */
+#if (HAL_QUEUES_USE_SPSC == FALSE) || defined(__DOXYGEN__)
   uint8_t               *q_wrptr;   /**< @brief Write pointer.              */
   uint8_t               *q_rdptr;   /**< @brief Read pointer.               */
+#endif
   qnotify_t             q_notify;   /**< @brief Data notification callback. */
   void                  *q_link;    /**< @brief Application defined field.  */
 };
@@ -95,7 +135,11 @@ struct io_queue {
  *
  * @iclass
  */
+#if (HAL_QUEUES_USE_SPSC == TRUE) || defined(__DOXYGEN__)
+#define qSpaceI(qp) ((size_t)((qp)->q_added - (qp)->q_removed))
+#else
 #define qSpaceI(qp) ((qp)->q_counter)
+#endif
 
 /**
  * @brief   Returns the queue application-defined link.
@@ -169,10 +213,14 @@ typedef io_queue_t input_queue_t;
  *
  * @iclass
  */
+#if (HAL_QUEUES_USE_SPSC == TRUE) || defined(__DOXYGEN__)
+#define iqIsFullI(iqp) ((bool)(qSpaceI(iqp) == qSizeX(iqp)))
+#else
 #define iqIsFullI(iqp)                                                      \
   /*lint -save -e9007 [13.5] No side effects, a pointer is passed.*/        \
   ((bool)(((iqp)->q_wrptr == (iqp)->q_rdptr) && ((iqp)->q_counter != 0U)))  \
   /*lint -restore*/
+#endif
 
 /**
  * @brief   Input queue read.
@@ -237,10 +285,14 @@ typedef io_queue_t output_queue_t;
  *
  * @iclass
  */
+#if (HAL_QUEUES_USE_SPSC == TRUE) || defined(__DOXYGEN__)
+#define oqIsEmptyI(oqp) ((bool)(qSpaceI(oqp) == qSizeX(oqp)))
+#else
 #define oqIsEmptyI(oqp)                                                     \
   /*lint -save -e9007 [13.5] No side effects, a pointer is passed.*/        \
   ((bool)(((oqp)->q_wrptr == (oqp)->q_rdptr) && ((oqp)->q_counter != 0U)))  \
   /*lint -restore*/
+#endif
 
 /**
  * @brief   Evaluates to @p true if the specified output queue is full.
@@ -278,6 +330,7 @@ extern "C" {
                     qnotify_t infy, void *link);
   void iqResetI(input_queue_t *iqp);
   msg_t iqPutI(input_queue_t *iqp, uint8_t b);
+  size_t iqWriteI(input_queue_t *iqp, const uint8_t *bp, size_t n);
   msg_t iqGetTimeout(input_queue_t *iqp, systime_t timeout);
   size_t iqReadTimeout(input_queue_t *iqp, uint8_t *bp,
                        size_t n, systime_t timeout);
@@ -287,6 +340,8 @@ extern "C" {
   void oqResetI(output_queue_t *oqp);
   msg_t oqPutTimeout(output_queue_t *oqp, uint8_t b, systime_t timeout);
   msg_t oqGetI(output_queue_t *oqp);
+  uint8_t *oqGetRunI(output_queue_t *oqp, size_t *np);
+  void oqReleaseRunI(output_queue_t *oqp, size_t n);
   size_t oqWriteTimeout(output_queue_t *oqp, const uint8_t *bp,
                         size_t n, systime_t timeout);
 #ifdef __cplusplus
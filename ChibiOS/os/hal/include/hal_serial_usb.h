@@ -54,6 +54,10 @@
 
 /**
  * @brief   Serial over USB number of buffers.
+ * @details Buffers embedded in each driver object and used by
+ *          @p sduObjectInit().
+ * @note    If set to zero the driver objects have no embedded buffers, the
+ *          buffers are supplied per instance using @p sduObjectInitBuffers().
  * @note    The default is 2 buffers.
  */
 #if !defined(SERIAL_USB_BUFFERS_NUMBER) || defined(__DOXYGEN__)
@@ -111,8 +115,46 @@ typedef struct {
    *          present, USB descriptors must be changed accordingly.
    */
   usbep_t                   int_in;
+  /**
+   * @brief   Minimum amount of data flushed from a partially filled output
+   *          buffer on SOF.
+   * @details Smaller amounts are coalesced with the following writes until
+   *          the threshold is reached or @p flush_sofs SOFs have elapsed.
+   * @note    If set to zero any pending data is flushed on the next SOF.
+   */
+  size_t                    flush_size;
+  /**
+   * @brief   Maximum number of SOFs pending data below @p flush_size can
+   *          wait before being flushed anyway.
+   * @note    If set to zero the data waits until @p flush_size is reached or
+   *          @p sduFlush() is called.
+   */
+  unsigned                  flush_sofs;
+  /**
+   * @brief   Low latency transmit mode.
+   * @details If set to @p true the write operations post a partially filled
+   *          output buffer immediately if the IN endpoint is idle, without
+   *          waiting for the next SOF. The data written while a transaction
+   *          is ongoing is coalesced in the following one.
+   */
+  bool                      low_latency;
 } SerialUSBConfig;
 
+/**
+ * @brief   @p SerialDriver embedded buffers.
+ */
+#if (SERIAL_USB_BUFFERS_NUMBER > 0) || defined(__DOXYGEN__)
+#define _serial_usb_driver_buffers                                          \
+  /* Input buffer.*/                                                        \
+  uint8_t                   ib[BQ_BUFFER_SIZE(SERIAL_USB_BUFFERS_NUMBER,    \
+                                              SERIAL_USB_BUFFERS_SIZE)];    \
+  /* Output buffer.*/                                                       \
+  uint8_t                   ob[BQ_BUFFER_SIZE(SERIAL_USB_BUFFERS_NUMBER,    \
+                                              SERIAL_USB_BUFFERS_SIZE)];
+#else
+#define _serial_usb_driver_buffers
+#endif
+
 /**
  * @brief   @p SerialDriver specific data.
  */
@@ -124,15 +166,12 @@ typedef struct {
   input_buffers_queue_t     ibqueue;                                        \
   /* Output queue.*/                                                        \
   output_buffers_queue_t    obqueue;                                        \
-  /* Input buffer.*/                                                        \
-  uint8_t                   ib[BQ_BUFFER_SIZE(SERIAL_USB_BUFFERS_NUMBER,    \
-                                              SERIAL_USB_BUFFERS_SIZE)];    \
-  /* Output buffer.*/                                                       \
-  uint8_t                   ob[BQ_BUFFER_SIZE(SERIAL_USB_BUFFERS_NUMBER,    \
-                                              SERIAL_USB_BUFFERS_SIZE)];    \
+  _serial_usb_driver_buffers                                                \
   /* End of the mandatory fields.*/                                         \
   /* Current configuration data.*/                                          \
-  const SerialUSBConfig     *config;
+  const SerialUSBConfig     *config;                                        \
+  /* SOFs elapsed with coalesced data pending.*/                            \
+  unsigned                  sofs;
 
 /**
  * @brief   @p SerialUSBDriver specific methods.
@@ -175,8 +214,11 @@ extern "C" {
 #endif
   void sduInit(void);
   void sduObjectInit(SerialUSBDriver *sdup);
+  void sduObjectInitBuffers(SerialUSBDriver *sdup, uint8_t *ib, uint8_t *ob,
+                            size_t size, size_t n);
   void sduStart(SerialUSBDriver *sdup, const SerialUSBConfig *config);
   void sduStop(SerialUSBDriver *sdup);
+  void sduFlush(SerialUSBDriver *sdup);
   void sduSuspendHookI(SerialUSBDriver *sdup);
   void sduWakeupHookI(SerialUSBDriver *sdup);
   void sduConfigureHookI(SerialUSBDriver *sdup);
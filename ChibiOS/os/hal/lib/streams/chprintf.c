@@ -27,68 +27,279 @@
  * @{
  */
 
+#include <limits.h>
+#include <string.h>
+
 #include "hal.h"
 #include "chprintf.h"
 #include "memstreams.h"
 
+#if ULONG_MAX > 0xFFFFFFFFUL
+#define MAX_FILLER 22
+#else
 #define MAX_FILLER 11
+#endif
 #define FLOAT_PRECISION 9
+#define MAX_FLOAT_CHARS (1 + 39 + 1 + FLOAT_PRECISION)
+
+/**
+ * @brief   Formatted output state.
+ */
+typedef struct {
+  BaseSequentialStream  *chp;
+#if CHPRINTF_BUFFER_SIZE > 0
+  size_t                n;
+  uint8_t               buf[CHPRINTF_BUFFER_SIZE];
+#endif
+} output_t;
+
+static void out_flush(output_t *op) {
+
+#if CHPRINTF_BUFFER_SIZE > 0
+  if (op->n > 0U) {
+    (void)streamWrite(op->chp, op->buf, op->n);
+    op->n = 0U;
+  }
+#else
+  (void)op;
+#endif
+}
+
+static inline void out_put(output_t *op, char c) {
+
+#if CHPRINTF_BUFFER_SIZE > 0
+  if (op->n >= CHPRINTF_BUFFER_SIZE) {
+    out_flush(op);
+  }
+  op->buf[op->n++] = (uint8_t)c;
+#else
+  (void)streamPut(op->chp, (uint8_t)c);
+#endif
+}
+
+static void out_write(output_t *op, const char *s, size_t n) {
+
+#if CHPRINTF_BUFFER_SIZE > 0
+  if (n >= CHPRINTF_BUFFER_SIZE) {
+    /* Large blocks bypass the buffer.*/
+    out_flush(op);
+    (void)streamWrite(op->chp, (const uint8_t *)s, n);
+    return;
+  }
+  if (CHPRINTF_BUFFER_SIZE - op->n < n) {
+    out_flush(op);
+  }
+  memcpy(&op->buf[op->n], s, n);
+  op->n += n;
+#else
+  while (n-- > 0U) {
+    (void)streamPut(op->chp, (uint8_t)*s++);
+  }
+#endif
+}
+
+#if defined(__ARM_ARCH_6M__)
+/*
+ * Powers of ten for the decimal conversion, the first entry is the largest
+ * power not greater than ULONG_MAX.
+ */
+static const unsigned long pow10_table[] = {
+  1000000000UL, 100000000UL, 10000000UL, 1000000UL, 100000UL,
+  10000UL, 1000UL, 100UL, 10UL, 1UL
+};
+
+#define POW10_DIGITS (int)(sizeof pow10_table / sizeof pow10_table[0])
+
+/*
+ * Decimal conversion without divisions for cores without a long multiply,
+ * where a division by a constant is a library call. Each digit is found
+ * with four compare and subtract steps (8, 4, 2 and 1 times the power of
+ * ten), the shifted comparisons cannot overflow. At least "digits" digits
+ * are produced, zero padded.
+ */
+static char *ch_utoa10(char *p, unsigned long num, int digits) {
+  const unsigned long *pp = pow10_table;
+  int i = POW10_DIGITS;
 
-static char *long_to_string_with_divisor(char *p,
-                                         long num,
-                                         unsigned radix,
-                                         long divisor) {
-  int i;
-  char *q;
-  long l, ll;
-
-  l = num;
-  if (divisor == 0) {
-    ll = num;
-  } else {
-    ll = divisor;
+  while ((i > digits) && (i > 1) && (*pp > num)) {
+    pp++;
+    i--;
   }
+  while (i-- > 0) {
+    unsigned long pw = *pp++;
+    char c = '0';
+
+    if ((num >> 3) >= pw) {
+      num -= pw << 3;
+      c += 8;
+    }
+    if ((num >> 2) >= pw) {
+      num -= pw << 2;
+      c += 4;
+    }
+    if ((num >> 1) >= pw) {
+      num -= pw << 1;
+      c += 2;
+    }
+    if (num >= pw) {
+      num -= pw;
+      c += 1;
+    }
+    *p++ = c;
+  }
+
+  return p;
+}
+#else
+/*
+ * Decimal conversion, the compiler turns the division by a constant into
+ * a multiplication. At least "digits" digits are produced, zero padded.
+ */
+static char *ch_utoa10(char *p, unsigned long num, int digits) {
+  char tmp[MAX_FILLER];
+  char *q = &tmp[MAX_FILLER];
 
-  q = p + MAX_FILLER;
   do {
-    i = (int)(l % radix);
-    i += '0';
-    if (i > '9')
-      i += 'A' - '0' - 10;
-    *--q = i;
-    l /= radix;
-  } while ((ll /= radix) != 0);
-
-  i = (int)(p + MAX_FILLER - q);
+    unsigned long d = num / 10U;
+
+    *--q = (char)('0' + (num - d * 10U));
+    num = d;
+    digits--;
+  } while ((num != 0U) || (digits > 0));
   do
     *p++ = *q++;
-  while (--i);
+  while (q < &tmp[MAX_FILLER]);
 
   return p;
 }
+#endif
+
+static char *ch_ltoa(char *p, unsigned long num, unsigned radix) {
+  char tmp[MAX_FILLER];
+  char *q = &tmp[MAX_FILLER];
+  unsigned shift;
 
-static char *ch_ltoa(char *p, long num, unsigned radix) {
+  if (radix == 10)
+    return ch_utoa10(p, num, 1);
 
-  return long_to_string_with_divisor(p, num, radix, 0);
+  /* Octal and hexadecimal digits are bit fields.*/
+  shift = radix == 16 ? 4 : 3;
+  do {
+    int i = (int)(num & (radix - 1));
+    *--q = (char)(i < 10 ? '0' + i : 'A' + i - 10);
+    num >>= shift;
+  } while (num != 0);
+  do
+    *p++ = *q++;
+  while (q < &tmp[MAX_FILLER]);
+
+  return p;
 }
 
 #if CHPRINTF_USE_FLOAT
-static const long pow10[FLOAT_PRECISION] = {
+static const uint32_t pow10[FLOAT_PRECISION] = {
     10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
 };
 
-static char *ftoa(char *p, double num, unsigned long precision) {
-  long l;
+/*
+ * Integer part of large floats, m * 2^e is rebuilt by doubling in base
+ * 10^9 limbs. At most 104 doublings of 5 limbs, no divisions.
+ */
+static char *ftoa_large(char *p, uint32_t m, unsigned e) {
+  uint32_t limb[5];
+  unsigned i, n = 1;
+
+  limb[0] = m;
+  while (e-- > 0U) {
+    uint32_t carry = 0;
+
+    for (i = 0; i < n; i++) {
+      uint32_t v = (limb[i] << 1) | carry;
+
+      carry = v >= 1000000000U;
+      limb[i] = carry ? v - 1000000000U : v;
+    }
+    if (carry)
+      limb[n++] = 1;
+  }
+  p = ch_utoa10(p, limb[--n], 1);
+  while (n-- > 0U)
+    p = ch_utoa10(p, limb[n], 9);
+
+  return p;
+}
+
+/*
+ * Fixed point conversion working on the IEEE-754 representation, the
+ * result is exact and rounded to nearest, ties to even, like the libc
+ * printf(). Only integer operations are used.
+ */
+static char *ftoa(char *p, float num, unsigned long precision) {
+  uint32_t bits, m, ip, pw;
+  uint64_t prod, q;
+  int e;
 
   if ((precision == 0) || (precision > FLOAT_PRECISION))
     precision = FLOAT_PRECISION;
-  precision = pow10[precision - 1];
+  pw = pow10[precision - 1];
+
+  memcpy(&bits, &num, sizeof bits);
+  if ((bits & 0x80000000U) != 0U)
+    *p++ = '-';
+  m = bits & 0x007FFFFFU;
+  e = (int)((bits >> 23) & 0xFFU);
+  if (e == 0xFF) {
+    memcpy(p, m == 0U ? "inf" : "nan", 3);
+    return p + 3;
+  }
+  if (e == 0)
+    e = -149;
+  else {
+    m |= 0x00800000U;
+    e -= 150;
+  }
 
-  l = (long)num;
-  p = long_to_string_with_divisor(p, l, 10, 0);
+  /* The value is m * 2^e.*/
+  if (e >= 0) {
+    q = 0;
+    if (e > 8)
+      p = ftoa_large(p, m, (unsigned)e);
+    else
+      p = ch_utoa10(p, (unsigned long)(m << e), 1);
+  }
+  else {
+    unsigned k = (unsigned)-e;
+    uint32_t frac;
+
+    if (k < 24U) {
+      ip = m >> k;
+      frac = m & ((1U << k) - 1U);
+    }
+    else {
+      ip = 0;
+      frac = m;
+    }
+    /* The fraction times 10^precision is below 2^54, it rounds to zero
+       when the shift is larger.*/
+    q = 0;
+    if (k <= 54U) {
+      uint64_t rem, half;
+
+      prod = (uint64_t)frac * pw;
+      q = prod >> k;
+      rem = prod & (((uint64_t)1 << k) - 1U);
+      half = (uint64_t)1 << (k - 1U);
+      if ((rem > half) || ((rem == half) && ((q & 1U) != 0U)))
+        q++;
+      if (q == pw) {
+        q = 0;
+        ip++;
+      }
+    }
+    p = ch_utoa10(p, (unsigned long)ip, 1);
+  }
   *p++ = '.';
-  l = (long)((num - l) * precision);
-  return long_to_string_with_divisor(p, l, 10, precision / 10);
+  return ch_utoa10(p, (unsigned long)q, (int)precision);
 }
 #endif
 
@@ -96,6 +307,8 @@ static char *ftoa(char *p, double num, unsigned long precision) {
  * @brief   System formatted output function.
  * @details This function implements a minimal @p vprintf()-like functionality
  *          with output on a @p BaseSequentialStream.
+ *          The output is written in chunks of up to @p CHPRINTF_BUFFER_SIZE
+ *          bytes, it is complete when the function returns.
  *          The general parameters format is: %[-][width|*][.precision|*][l|L]p.
  *          The following parameter types (p) are supported:
  *          - <b>x</b> hexadecimal integer.
@@ -108,6 +321,9 @@ static char *ftoa(char *p, double num, unsigned long precision) {
  *          - <b>U</b> decimal unsigned long.
  *          - <b>c</b> character.
  *          - <b>s</b> string.
+ *          - <b>f</b> float, if @p CHPRINTF_USE_FLOAT is enabled. The
+ *            precision is 1 to 9 decimals, 9 if not specified, the value
+ *            is correctly rounded.
  *          .
  *
  * @param[in] chp       pointer to a @p BaseSequentialStream implementing object
@@ -124,20 +340,33 @@ int chvprintf(BaseSequentialStream *chp, const char *fmt, va_list ap) {
   int n = 0;
   bool is_long, left_align;
   long l;
+  output_t out;
 #if CHPRINTF_USE_FLOAT
   float f;
-  char tmpbuf[2*MAX_FILLER + 1];
+  char tmpbuf[MAX_FLOAT_CHARS + 1];
 #else
   char tmpbuf[MAX_FILLER + 1];
 #endif
 
+  out.chp = chp;
+#if CHPRINTF_BUFFER_SIZE > 0
+  out.n = 0U;
+#endif
+
   while (true) {
     c = *fmt++;
-    if (c == 0)
+    if (c == 0) {
+      out_flush(&out);
       return n;
+    }
     if (c != '%') {
-      streamPut(chp, (uint8_t)c);
-      n++;
+      /* Literal text is copied as a whole run.*/
+      s = (char *)fmt - 1;
+      while ((*fmt != 0) && (*fmt != '%'))
+        fmt++;
+      i = (int)(fmt - s);
+      out_write(&out, s, (size_t)i);
+      n += i;
       continue;
     }
     p = tmpbuf;
@@ -211,17 +440,14 @@ int chvprintf(BaseSequentialStream *chp, const char *fmt, va_list ap) {
         l = va_arg(ap, int);
       if (l < 0) {
         *p++ = '-';
-        l = -l;
+        p = ch_ltoa(p, 0UL - (unsigned long)l, 10);
       }
-      p = ch_ltoa(p, l, 10);
+      else
+        p = ch_ltoa(p, (unsigned long)l, 10);
       break;
 #if CHPRINTF_USE_FLOAT
     case 'f':
       f = (float) va_arg(ap, double);
-      if (f < 0) {
-        *p++ = '-';
-        f = -f;
-      }
       p = ftoa(p, f, precision);
       break;
 #endif
@@ -241,7 +467,7 @@ unsigned_common:
         l = va_arg(ap, unsigned long);
       else
         l = va_arg(ap, unsigned int);
-      p = ch_ltoa(p, l, c);
+      p = ch_ltoa(p, (unsigned long)l, c);
       break;
     default:
       *p++ = c;
@@ -254,22 +480,22 @@ unsigned_common:
       width = -width;
     if (width < 0) {
       if (*s == '-' && filler == '0') {
-        streamPut(chp, (uint8_t)*s++);
+        out_put(&out, *s++);
         n++;
         i--;
       }
       do {
-        streamPut(chp, (uint8_t)filler);
+        out_put(&out, filler);
         n++;
       } while (++width != 0);
     }
-    while (--i >= 0) {
-      streamPut(chp, (uint8_t)*s++);
-      n++;
+    if (i > 0) {
+      out_write(&out, s, (size_t)i);
+      n += i;
     }
 
     while (width) {
-      streamPut(chp, (uint8_t)filler);
+      out_put(&out, filler);
       n++;
       width--;
     }
@@ -34,6 +34,17 @@
 #define CHPRINTF_USE_FLOAT          FALSE
 #endif
 
+/**
+ * @brief   Output buffer size.
+ * @details The formatted output is collected in a stack buffer of this size
+ *          and written to the stream in chunks using @p streamWrite().
+ *          Zero disables the buffer, each character is then written using
+ *          @p streamPut().
+ */
+#if !defined(CHPRINTF_BUFFER_SIZE) || defined(__DOXYGEN__)
+#define CHPRINTF_BUFFER_SIZE        32
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -0,0 +1,725 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    framing.c
+ * @brief   Packet framing code.
+ * @details Frames are decoded in bulk from channel reads or from the
+ *          buffers lent by an input buffers queue, complete frames are
+ *          delivered to a callback. Outgoing frames are encoded directly
+ *          into the destination memory, channel chunk or output queue
+ *          buffers.
+ *
+ * @addtogroup framing
+ * @{
+ */
+
+#include <string.h>
+
+#include "hal.h"
+#include "framing.h"
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   Data discarded up to the next delimiter.
+ */
+#define FRM_SYNC                    0xFFU
+
+/**
+ * @name    COBS decoder states
+ * @{
+ */
+#define COBS_IDLE                   0U
+#define COBS_CODE                   1U
+#define COBS_CODE_ZERO              2U
+#define COBS_DATA                   3U
+#define COBS_DATA_ZERO              4U
+/** @} */
+
+/**
+ * @name    SLIP decoder states
+ * @{
+ */
+#define SLIP_DATA                   0U
+#define SLIP_ESCAPE                 1U
+/** @} */
+
+/**
+ * @name    Length prefixed decoder states
+ * @{
+ */
+#define LEN_LOW                     0U
+#define LEN_HIGH                    1U
+#define LEN_DATA                    2U
+/** @} */
+
+/**
+ * @brief   Maximum data bytes in a COBS block.
+ */
+#define COBS_MAX_BLOCK              254U
+
+/**
+ * @brief   Type of an encoder output.
+ * @details The encoder writes in the window between @p ptr and @p top,
+ *          the @p next function is invoked when the window is full.
+ */
+typedef struct frm_sink frm_sink_t;
+
+struct frm_sink {
+  uint8_t               *base;
+  uint8_t               *ptr;
+  uint8_t               *top;
+  bool                  (*next)(frm_sink_t *skp);
+  void                  *obj;
+  systime_t             timeout;
+};
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Zero implicitly terminating a COBS block.
+ */
+static const uint8_t cobs_zero = 0U;
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+static void frame_append(FrameDecoder *fdp, const uint8_t *bp, size_t n) {
+
+  if (fdp->drop) {
+    return;
+  }
+  if (fdp->size - fdp->len < n) {
+    fdp->drop = true;
+    return;
+  }
+  memcpy(fdp->buffer + fdp->len, bp, n);
+  fdp->len += n;
+}
+
+static unsigned frame_end(FrameDecoder *fdp) {
+  unsigned frames = 0U;
+
+  if (fdp->drop) {
+    fdp->errors++;
+  }
+  else {
+    fdp->cb(fdp, fdp->buffer, fdp->len);
+    frames = 1U;
+  }
+  fdp->len   = 0U;
+  fdp->left  = 0U;
+  fdp->state = 0U;
+  fdp->drop  = false;
+
+  return frames;
+}
+
+static unsigned cobs_decode(FrameDecoder *fdp, const uint8_t *bp, size_t n) {
+  unsigned frames = 0U;
+
+  while (n > 0U) {
+    const uint8_t *zp;
+    size_t k;
+    uint8_t b;
+
+    if ((fdp->state == COBS_DATA) || (fdp->state == COBS_DATA_ZERO)) {
+      /* Copying as much of the current block as possible, a zero inside
+         the block is a delimiter truncating the frame.*/
+      k = fdp->left < n ? fdp->left : n;
+      zp = memchr(bp, 0, k);
+      if (zp != NULL) {
+        k = (size_t)(zp - bp);
+        fdp->drop = true;
+        frames += frame_end(fdp);
+        bp += k + 1U;
+        n  -= k + 1U;
+        continue;
+      }
+      frame_append(fdp, bp, k);
+      bp += k;
+      n  -= k;
+      fdp->left -= k;
+      if (fdp->left == 0U) {
+        fdp->state = fdp->state == COBS_DATA_ZERO ? COBS_CODE_ZERO : COBS_CODE;
+      }
+      continue;
+    }
+
+    if (fdp->state == FRM_SYNC) {
+      zp = memchr(bp, 0, n);
+      if (zp == NULL) {
+        return frames;
+      }
+      fdp->state = COBS_IDLE;
+      n  -= (size_t)(zp - bp) + 1U;
+      bp  = zp + 1;
+      continue;
+    }
+
+    b = *bp++;
+    n--;
+    if (b == 0U) {
+      /* Delimiter, consecutive delimiters are ignored, the implicit zero
+         of the last block is not part of the frame.*/
+      if (fdp->state != COBS_IDLE) {
+        frames += frame_end(fdp);
+      }
+    }
+    else {
+      /* Code byte starting a new block.*/
+      if (fdp->state == COBS_CODE_ZERO) {
+        frame_append(fdp, &cobs_zero, 1U);
+      }
+      fdp->left = (size_t)b - 1U;
+      if (fdp->left == 0U) {
+        fdp->state = COBS_CODE_ZERO;
+      }
+      else {
+        fdp->state = b == 0xFFU ? COBS_DATA : COBS_DATA_ZERO;
+      }
+    }
+  }
+
+  return frames;
+}
+
+static unsigned slip_decode(FrameDecoder *fdp, const uint8_t *bp, size_t n) {
+  unsigned frames = 0U;
+
+  while (n > 0U) {
+    size_t k;
+    uint8_t b;
+
+    if (fdp->state == SLIP_ESCAPE) {
+      b = *bp++;
+      n--;
+      fdp->state = SLIP_DATA;
+      if (b == FRM_SLIP_ESC_END) {
+        b = FRM_SLIP_END;
+      }
+      else if (b == FRM_SLIP_ESC_ESC) {
+        b = FRM_SLIP_ESC;
+      }
+      else {
+        /* Invalid escape sequence, the frame is discarded.*/
+        fdp->drop = true;
+        if (b == FRM_SLIP_END) {
+          frames += frame_end(fdp);
+        }
+        continue;
+      }
+      frame_append(fdp, &b, 1U);
+      continue;
+    }
+
+    /* Scanning the run of ordinary characters.*/
+    k = 0U;
+    while ((k < n) && (bp[k] != FRM_SLIP_END) && (bp[k] != FRM_SLIP_ESC)) {
+      k++;
+    }
+    if (fdp->state != FRM_SYNC) {
+      frame_append(fdp, bp, k);
+    }
+    bp += k;
+    n  -= k;
+
+    if (n > 0U) {
+      b = *bp++;
+      n--;
+      if (b == FRM_SLIP_END) {
+        /* Empty frames are ignored, they are produced by the leading END
+           sent by the encoder.*/
+        if (fdp->state == FRM_SYNC) {
+          fdp->state = SLIP_DATA;
+        }
+        else if ((fdp->len > 0U) || fdp->drop) {
+          frames += frame_end(fdp);
+        }
+      }
+      else if (fdp->state != FRM_SYNC) {
+        fdp->state = SLIP_ESCAPE;
+      }
+    }
+  }
+
+  return frames;
+}
+
+static unsigned len_decode(FrameDecoder *fdp, const uint8_t *bp, size_t n) {
+  unsigned frames = 0U;
+
+  while (n > 0U) {
+    size_t k;
+
+    switch (fdp->state) {
+    case LEN_LOW:
+      fdp->left  = (size_t)*bp++;
+      fdp->state = LEN_HIGH;
+      n--;
+      break;
+    case LEN_HIGH:
+      fdp->left |= (size_t)*bp++ << 8;
+      n--;
+      if (fdp->left > fdp->size) {
+        /* The data is skipped and the frame dropped at its end.*/
+        fdp->drop = true;
+      }
+      if (fdp->left == 0U) {
+        frames += frame_end(fdp);
+      }
+      else {
+        fdp->state = LEN_DATA;
+      }
+      break;
+    default:
+      k = fdp->left < n ? fdp->left : n;
+      frame_append(fdp, bp, k);
+      bp += k;
+      n  -= k;
+      fdp->left -= k;
+      if (fdp->left == 0U) {
+        frames += frame_end(fdp);
+      }
+      break;
+    }
+  }
+
+  return frames;
+}
+
+static bool sink_write(frm_sink_t *skp, const uint8_t *bp, size_t n) {
+
+  while (n > 0U) {
+    size_t k;
+
+    if ((skp->ptr >= skp->top) && !skp->next(skp)) {
+      return false;
+    }
+    k = (size_t)(skp->top - skp->ptr);
+    if (k > n) {
+      k = n;
+    }
+    memcpy(skp->ptr, bp, k);
+    skp->ptr += k;
+    bp += k;
+    n  -= k;
+  }
+
+  return true;
+}
+
+static bool sink_put(frm_sink_t *skp, uint8_t b) {
+
+  if ((skp->ptr >= skp->top) && !skp->next(skp)) {
+    return false;
+  }
+  *skp->ptr++ = b;
+
+  return true;
+}
+
+static bool frame_encode(frmmode_t mode, frm_sink_t *skp,
+                         const uint8_t *fp, size_t n) {
+  const uint8_t *end = fp + n;
+
+  switch (mode) {
+  case FRM_COBS:
+    while (true) {
+      const uint8_t *zp = NULL;
+      size_t k = (size_t)(end - fp);
+
+      if (k > COBS_MAX_BLOCK) {
+        k = COBS_MAX_BLOCK;
+      }
+      if (k > 0U) {
+        zp = memchr(fp, 0, k);
+        if (zp != NULL) {
+          k = (size_t)(zp - fp);
+        }
+      }
+      if (!sink_put(skp, (uint8_t)(k + 1U)) || !sink_write(skp, fp, k)) {
+        return false;
+      }
+      fp += k;
+      if (zp != NULL) {
+        /* The zero is implicit at the end of the block.*/
+        fp++;
+      }
+      else if ((k < COBS_MAX_BLOCK) || (fp >= end)) {
+        break;
+      }
+    }
+    return sink_put(skp, 0U);
+  case FRM_SLIP:
+    if (!sink_put(skp, FRM_SLIP_END)) {
+      return false;
+    }
+    while (fp < end) {
+      const uint8_t *p = fp;
+
+      while ((p < end) && (*p != FRM_SLIP_END) && (*p != FRM_SLIP_ESC)) {
+        p++;
+      }
+      if (!sink_write(skp, fp, (size_t)(p - fp))) {
+        return false;
+      }
+      if (p < end) {
+        if (!sink_put(skp, FRM_SLIP_ESC) ||
+            !sink_put(skp, *p == FRM_SLIP_END ? FRM_SLIP_ESC_END :
+                                                FRM_SLIP_ESC_ESC)) {
+          return false;
+        }
+        p++;
+      }
+      fp = p;
+    }
+    return sink_put(skp, FRM_SLIP_END);
+  default:
+    return sink_put(skp, (uint8_t)n) &&
+           sink_put(skp, (uint8_t)(n >> 8)) &&
+           sink_write(skp, fp, n);
+  }
+}
+
+static bool mem_next(frm_sink_t *skp) {
+
+  (void)skp;
+
+  return false;
+}
+
+static bool chn_next(frm_sink_t *skp) {
+  size_t n = (size_t)(skp->ptr - skp->base);
+
+  if (chnWriteTimeout((BaseChannel *)skp->obj, skp->base,
+                      n, skp->timeout) != n) {
+    return false;
+  }
+  skp->ptr = skp->base;
+
+  return true;
+}
+
+static bool obq_next(frm_sink_t *skp) {
+  size_t n;
+
+  if (skp->base != NULL) {
+    obqReturn((output_buffers_queue_t *)skp->obj,
+              (size_t)(skp->ptr - skp->base));
+  }
+  n = obqBorrowTimeout((output_buffers_queue_t *)skp->obj,
+                       &skp->base, skp->timeout);
+  if (n == 0U) {
+    skp->base = NULL;
+    return false;
+  }
+  skp->ptr = skp->base;
+  skp->top = skp->base + n;
+
+  return true;
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes a frame decoder.
+ *
+ * @param[out] fdp      pointer to the @p FrameDecoder object
+ * @param[in] mode      the framing mode
+ * @param[in] buffer    buffer receiving the decoded frames
+ * @param[in] size      size of the buffer, larger frames are dropped
+ * @param[in] cb        callback invoked for each complete frame
+ * @param[in] link      application defined pointer
+ *
+ * @init
+ */
+void frmObjectInit(FrameDecoder *fdp, frmmode_t mode,
+                   uint8_t *buffer, size_t size,
+                   frmcallback_t cb, void *link) {
+
+  osalDbgCheck((fdp != NULL) && (buffer != NULL) && (cb != NULL));
+
+  fdp->mode   = mode;
+  fdp->buffer = buffer;
+  fdp->size   = size;
+  fdp->len    = 0U;
+  fdp->left   = 0U;
+  fdp->state  = 0U;
+  fdp->drop   = false;
+  fdp->cb     = cb;
+  fdp->errors = 0U;
+  fdp->link   = link;
+}
+
+/**
+ * @brief   Resets a frame decoder.
+ * @details The partially decoded frame is discarded. In COBS and SLIP modes
+ *          the received data is also discarded up to the next delimiter,
+ *          this allows to resynchronize in the middle of a stream.
+ *
+ * @param[in] fdp       pointer to the @p FrameDecoder object
+ *
+ * @api
+ */
+void frmReset(FrameDecoder *fdp) {
+
+  osalDbgCheck(fdp != NULL);
+
+  fdp->len   = 0U;
+  fdp->left  = 0U;
+  fdp->drop  = false;
+  fdp->state = fdp->mode == FRM_LENGTH ? LEN_LOW : FRM_SYNC;
+}
+
+/**
+ * @brief   Decodes a block of received data.
+ * @details The data is consumed in runs, the callback is invoked for each
+ *          frame completed by the data.
+ *
+ * @param[in] fdp       pointer to the @p FrameDecoder object
+ * @param[in] bp        pointer to the received data
+ * @param[in] n         number of bytes
+ * @return              The number of frames delivered.
+ *
+ * @api
+ */
+unsigned frmDecode(FrameDecoder *fdp, const uint8_t *bp, size_t n) {
+
+  osalDbgCheck((fdp != NULL) && ((bp != NULL) || (n == 0U)));
+
+  switch (fdp->mode) {
+  case FRM_COBS:
+    return cobs_decode(fdp, bp, n);
+  case FRM_SLIP:
+    return slip_decode(fdp, bp, n);
+  default:
+    return len_decode(fdp, bp, n);
+  }
+}
+
+/**
+ * @brief   Decodes the data received from a channel.
+ * @details The function waits for one byte then reads all the data already
+ *          available in the channel, up to @p FRAMING_CHUNK_SIZE bytes, in
+ *          a single operation.
+ *
+ * @param[in] fdp       pointer to the @p FrameDecoder object
+ * @param[in] chp       pointer to a @p BaseChannel object
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of frames delivered.
+ *
+ * @api
+ */
+unsigned frmReadTimeout(FrameDecoder *fdp, BaseChannel *chp,
+                        systime_t timeout) {
+  uint8_t buf[FRAMING_CHUNK_SIZE];
+  msg_t msg;
+  size_t n;
+
+  osalDbgCheck((fdp != NULL) && (chp != NULL));
+
+  msg = chnGetTimeout(chp, timeout);
+  if (msg < MSG_OK) {
+    return 0U;
+  }
+  buf[0] = (uint8_t)msg;
+  n = chnReadTimeout(chp, &buf[1], sizeof buf - 1U, TIME_IMMEDIATE);
+
+  return frmDecode(fdp, buf, n + 1U);
+}
+
+/**
+ * @brief   Decodes the data of an input buffers queue.
+ * @details The next filled buffer is borrowed and decoded in place, no
+ *          intermediate copy is made.
+ * @note    The callback is invoked while the buffer is lent, it must not
+ *          read from the queue.
+ *
+ * @param[in] fdp       pointer to the @p FrameDecoder object
+ * @param[in] ibqp      pointer to the @p input_buffers_queue_t object
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of frames delivered.
+ *
+ * @api
+ */
+unsigned frmReadBuffers(FrameDecoder *fdp, input_buffers_queue_t *ibqp,
+                        systime_t timeout) {
+  unsigned frames;
+  uint8_t *bp;
+  size_t n;
+
+  osalDbgCheck((fdp != NULL) && (ibqp != NULL));
+
+  n = ibqBorrowTimeout(ibqp, &bp, timeout);
+  if (n == 0U) {
+    return 0U;
+  }
+  frames = frmDecode(fdp, bp, n);
+  ibqReturn(ibqp, n);
+
+  return frames;
+}
+
+/**
+ * @brief   Encodes a frame into a memory buffer.
+ * @note    A buffer of @p FRM_MAX_ENCODED_SIZE() bytes is always large
+ *          enough.
+ *
+ * @param[in] mode      the framing mode
+ * @param[in] fp        pointer to the frame data
+ * @param[in] n         size of the frame, in length prefixed mode it must
+ *                      not exceed 65535
+ * @param[out] bp       pointer to the output buffer
+ * @param[in] size      size of the output buffer
+ * @return              The size of the encoded frame.
+ * @retval 0            if the output buffer is too small.
+ *
+ * @api
+ */
+size_t frmEncode(frmmode_t mode, const uint8_t *fp, size_t n,
+                 uint8_t *bp, size_t size) {
+  frm_sink_t sink;
+
+  osalDbgCheck(((fp != NULL) || (n == 0U)) && (bp != NULL));
+  osalDbgCheck((mode != FRM_LENGTH) || (n <= 0xFFFFU));
+
+  sink.base = bp;
+  sink.ptr  = bp;
+  sink.top  = bp + size;
+  sink.next = mem_next;
+  if (!frame_encode(mode, &sink, fp, n)) {
+    return 0U;
+  }
+
+  return (size_t)(sink.ptr - sink.base);
+}
+
+/**
+ * @brief   Encodes a frame and writes it to a channel.
+ * @details The frame is encoded into a stack buffer and written in chunks
+ *          of @p FRAMING_CHUNK_SIZE bytes.
+ * @note    On failure a partial frame may have been written, the receiver
+ *          drops it at the next delimiter.
+ *
+ * @param[in] mode      the framing mode
+ * @param[in] chp       pointer to a @p BaseChannel object
+ * @param[in] fp        pointer to the frame data
+ * @param[in] n         size of the frame, in length prefixed mode it must
+ *                      not exceed 65535
+ * @param[in] timeout   the number of ticks before each write operation
+ *                      timeouts, the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if the frame has been written.
+ * @retval MSG_TIMEOUT  if the channel did not accept the whole frame.
+ *
+ * @api
+ */
+msg_t frmWriteTimeout(frmmode_t mode, BaseChannel *chp,
+                      const uint8_t *fp, size_t n, systime_t timeout) {
+  uint8_t buf[FRAMING_CHUNK_SIZE];
+  frm_sink_t sink;
+
+  osalDbgCheck((chp != NULL) && ((fp != NULL) || (n == 0U)));
+  osalDbgCheck((mode != FRM_LENGTH) || (n <= 0xFFFFU));
+
+  sink.base    = buf;
+  sink.ptr     = buf;
+  sink.top     = buf + sizeof buf;
+  sink.next    = chn_next;
+  sink.obj     = chp;
+  sink.timeout = timeout;
+  if (!frame_encode(mode, &sink, fp, n) ||
+      ((sink.ptr > sink.base) && !chn_next(&sink))) {
+    return MSG_TIMEOUT;
+  }
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Encodes a frame into an output buffers queue.
+ * @details The queue buffers are borrowed and the frame is encoded in
+ *          place, no intermediate copy is made. The frame may span several
+ *          buffers.
+ * @note    The last buffer is not flushed, it is transmitted according to
+ *          the queue flush policy or after an explicit @p obqFlush().
+ * @note    On failure a partial frame may have been written, the receiver
+ *          drops it at the next delimiter.
+ *
+ * @param[in] mode      the framing mode
+ * @param[in] obqp      pointer to the @p output_buffers_queue_t object
+ * @param[in] fp        pointer to the frame data
+ * @param[in] n         size of the frame, in length prefixed mode it must
+ *                      not exceed 65535
+ * @param[in] timeout   the number of ticks before each buffer wait
+ *                      timeouts, the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if the frame has been written.
+ * @retval MSG_TIMEOUT  if a buffer was not available in time or the queue
+ *                      has been reset.
+ *
+ * @api
+ */
+msg_t frmWriteBuffers(frmmode_t mode, output_buffers_queue_t *obqp,
+                      const uint8_t *fp, size_t n, systime_t timeout) {
+  frm_sink_t sink;
+  bool ok;
+
+  osalDbgCheck((obqp != NULL) && ((fp != NULL) || (n == 0U)));
+  osalDbgCheck((mode != FRM_LENGTH) || (n <= 0xFFFFU));
+
+  sink.base    = NULL;
+  sink.ptr     = NULL;
+  sink.top     = NULL;
+  sink.next    = obq_next;
+  sink.obj     = obqp;
+  sink.timeout = timeout;
+  ok = frame_encode(mode, &sink, fp, n);
+  if (sink.base != NULL) {
+    obqReturn(obqp, (size_t)(sink.ptr - sink.base));
+  }
+
+  return ok ? MSG_OK : MSG_TIMEOUT;
+}
+
+/** @} */
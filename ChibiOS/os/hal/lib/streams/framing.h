@@ -0,0 +1,199 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    framing.h
+ * @brief   Packet framing structures and macros.
+ *
+ * @addtogroup framing
+ * @{
+ */
+
+#ifndef FRAMING_H
+#define FRAMING_H
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    SLIP special characters
+ * @{
+ */
+#define FRM_SLIP_END                0xC0U
+#define FRM_SLIP_ESC                0xDBU
+#define FRM_SLIP_ESC_END            0xDCU
+#define FRM_SLIP_ESC_ESC            0xDDU
+/** @} */
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Size of the stack buffer used by the channel functions.
+ * @details Data is moved between the channel and the framing layer in
+ *          chunks of this size.
+ */
+#if !defined(FRAMING_CHUNK_SIZE) || defined(__DOXYGEN__)
+#define FRAMING_CHUNK_SIZE          64
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if FRAMING_CHUNK_SIZE < 2
+#error "invalid FRAMING_CHUNK_SIZE value"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Framing modes.
+ */
+typedef enum {
+  FRM_COBS = 0,                     /**< COBS, frames end with a zero.      */
+  FRM_SLIP = 1,                     /**< SLIP (RFC 1055), END delimited.    */
+  FRM_LENGTH = 2                    /**< 16 bits little endian length.      */
+} frmmode_t;
+
+/**
+ * @brief   Type of a frame decoder structure.
+ */
+typedef struct FrameDecoder FrameDecoder;
+
+/**
+ * @brief   Frame received callback type.
+ * @note    The frame data is only valid during the callback.
+ *
+ * @param[in] fdp       pointer to the @p FrameDecoder object
+ * @param[in] fp        pointer to the decoded frame
+ * @param[in] n         size of the decoded frame
+ */
+typedef void (*frmcallback_t)(FrameDecoder *fdp, const uint8_t *fp, size_t n);
+
+/**
+ * @brief   Structure representing a frame decoder.
+ */
+struct FrameDecoder {
+  /**
+   * @brief   Framing mode.
+   */
+  frmmode_t                 mode;
+  /**
+   * @brief   Frame assembly buffer.
+   */
+  uint8_t                   *buffer;
+  /**
+   * @brief   Size of the frame assembly buffer.
+   */
+  size_t                    size;
+  /**
+   * @brief   Decoded bytes of the current frame.
+   */
+  size_t                    len;
+  /**
+   * @brief   Remaining bytes of the current COBS block or length frame.
+   */
+  size_t                    left;
+  /**
+   * @brief   Decoder state, its meaning depends on the mode.
+   */
+  uint8_t                   state;
+  /**
+   * @brief   The current frame is being discarded.
+   */
+  bool                      drop;
+  /**
+   * @brief   Frame received callback.
+   */
+  frmcallback_t             cb;
+  /**
+   * @brief   Number of malformed or oversized frames dropped.
+   */
+  uint32_t                  errors;
+  /**
+   * @brief   Application defined field.
+   */
+  void                      *link;
+};
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Worst case size of an encoded frame.
+ * @details The size includes the delimiters, it is valid for all the
+ *          framing modes.
+ *
+ * @param[in] n         size of the frame
+ * @return              The maximum encoded size.
+ */
+#define FRM_MAX_ENCODED_SIZE(n) ((size_t)(n) * 2U + 2U)
+
+/**
+ * @brief   Returns the number of dropped frames.
+ *
+ * @param[in] fdp       pointer to the @p FrameDecoder object
+ * @return              The errors counter.
+ *
+ * @xclass
+ */
+#define frmGetErrorsX(fdp) ((fdp)->errors)
+
+/**
+ * @brief   Returns the decoder application-defined link.
+ *
+ * @param[in] fdp       pointer to the @p FrameDecoder object
+ * @return              The application-defined link.
+ *
+ * @special
+ */
+#define frmGetLinkX(fdp) ((fdp)->link)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void frmObjectInit(FrameDecoder *fdp, frmmode_t mode,
+                     uint8_t *buffer, size_t size,
+                     frmcallback_t cb, void *link);
+  void frmReset(FrameDecoder *fdp);
+  unsigned frmDecode(FrameDecoder *fdp, const uint8_t *bp, size_t n);
+  unsigned frmReadTimeout(FrameDecoder *fdp, BaseChannel *chp,
+                          systime_t timeout);
+  unsigned frmReadBuffers(FrameDecoder *fdp, input_buffers_queue_t *ibqp,
+                          systime_t timeout);
+  size_t frmEncode(frmmode_t mode, const uint8_t *fp, size_t n,
+                   uint8_t *bp, size_t size);
+  msg_t frmWriteTimeout(frmmode_t mode, BaseChannel *chp,
+                        const uint8_t *fp, size_t n, systime_t timeout);
+  msg_t frmWriteBuffers(frmmode_t mode, output_buffers_queue_t *obqp,
+                        const uint8_t *fp, size_t n, systime_t timeout);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FRAMING_H */
+
+/** @} */
@@ -1,6 +1,7 @@
 # RT Shell files.
 STREAMSSRC = $(CHIBIOS)/os/hal/lib/streams/chprintf.c \
              $(CHIBIOS)/os/hal/lib/streams/memstreams.c \
-             $(CHIBIOS)/os/hal/lib/streams/nullstreams.c
+             $(CHIBIOS)/os/hal/lib/streams/nullstreams.c \
+             $(CHIBIOS)/os/hal/lib/streams/framing.c
 
 STREAMSINC = $(CHIBIOS)/os/hal/lib/streams
@@ -19,7 +19,10 @@
 #ifndef _OSAL_H_
 #define _OSAL_H_
 
+/* Cortex-M parameters, the host simulator has no such thing */
+#if !defined(SIMULATOR)
 #include "cmparams.h"
+#endif
 
 /* Include the OS abstraction layer from libFreeRTOS */
 #include "osal_ch.h"
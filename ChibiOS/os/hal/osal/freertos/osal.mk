@@ -1,3 +1,4 @@
 # Required include directories
 OSALSRC += ${CHIBIOS}/os/hal/osal/freertos/osal.c
+OSALSRC += ${CHIBIOS}/os/hal/osal/freertos/osal_prof.c
 OSALINC += ${CHIBIOS}/os/hal/osal/freertos/
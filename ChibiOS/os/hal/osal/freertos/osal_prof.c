@@ -0,0 +1,58 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+    	      Copyright (C) 2017 Bertold Van den Bergh
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <string.h>
+
+#include "osal_prof.h"
+
+#if (configUSE_CRITICAL_PROFILER == 1) || defined(__DOXYGEN__)
+#include "chprintf.h"
+
+/**
+ * @brief   Prints the critical section profile, one call site per line.
+ * @details The maximum is given in counter units and in microseconds, the
+ *          histogram columns count the sections of every bucket, see
+ *          @p configCRITICAL_PROFILER_SHIFT. Any stream will do, a memory
+ *          stream included.
+ *
+ * @param[in] chp       pointer to a @p BaseSequentialStream object
+ */
+void osalProfDump(BaseSequentialStream *chp) {
+  osal_prof_site_t *site, copy;
+  const char *file;
+  unsigned i;
+
+  chprintf(chp, "site                     count       max     us  <2^%u..."
+                "\r\n", configCRITICAL_PROFILER_SHIFT);
+  for (site = osalProfSites; site != NULL; site = site->next) {
+    taskENTER_CRITICAL();
+    copy = *site;
+    taskEXIT_CRITICAL();
+
+    file = strrchr(copy.file, '/');
+    file = (file != NULL) ? file + 1 : copy.file;
+    chprintf(chp, "%16s:%-5lu %8lu %9lu %6lu ", file,
+             (unsigned long)copy.line, (unsigned long)copy.count,
+             (unsigned long)copy.max,
+             (unsigned long)(copy.max / (configCPU_CLOCK_HZ / 1000000UL)));
+    for (i = 0; i < configCRITICAL_PROFILER_BUCKETS; i++) {
+      chprintf(chp, " %lu", (unsigned long)copy.histogram[i]);
+    }
+    chprintf(chp, "\r\n");
+  }
+}
+#endif
@@ -0,0 +1,33 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+    	      Copyright (C) 2017 Bertold Van den Bergh
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef _OSAL_PROF_H_
+#define _OSAL_PROF_H_
+
+#include "hal.h"
+
+#if (configUSE_CRITICAL_PROFILER == 1) || defined(__DOXYGEN__)
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void osalProfDump(BaseSequentialStream *chp);
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+#endif
@@ -30,6 +30,58 @@
 /* Driver local definitions.                                                 */
 /*===========================================================================*/
 
+#if STM32_SERIAL_USE_RX_DMA || defined(__DOXYGEN__)
+#define USART1_RX_DMA_CHANNEL                                               \
+  STM32_DMA_GETCHANNEL(STM32_UART_USART1_RX_DMA_STREAM,                     \
+                       STM32_USART1_RX_DMA_CHN)
+
+#define USART2_RX_DMA_CHANNEL                                               \
+  STM32_DMA_GETCHANNEL(STM32_UART_USART2_RX_DMA_STREAM,                     \
+                       STM32_USART2_RX_DMA_CHN)
+
+#define USART3_RX_DMA_CHANNEL                                               \
+  STM32_DMA_GETCHANNEL(STM32_UART_USART3_RX_DMA_STREAM,                     \
+                       STM32_USART3_RX_DMA_CHN)
+
+#define UART4_RX_DMA_CHANNEL                                                \
+  STM32_DMA_GETCHANNEL(STM32_UART_UART4_RX_DMA_STREAM,                      \
+                       STM32_UART4_RX_DMA_CHN)
+
+#define UART5_RX_DMA_CHANNEL                                                \
+  STM32_DMA_GETCHANNEL(STM32_UART_UART5_RX_DMA_STREAM,                      \
+                       STM32_UART5_RX_DMA_CHN)
+
+#define USART6_RX_DMA_CHANNEL                                               \
+  STM32_DMA_GETCHANNEL(STM32_UART_USART6_RX_DMA_STREAM,                     \
+                       STM32_USART6_RX_DMA_CHN)
+#endif
+
+#if STM32_SERIAL_USE_TX_DMA || defined(__DOXYGEN__)
+#define USART1_TX_DMA_CHANNEL                                               \
+  STM32_DMA_GETCHANNEL(STM32_UART_USART1_TX_DMA_STREAM,                     \
+                       STM32_USART1_TX_DMA_CHN)
+
+#define USART2_TX_DMA_CHANNEL                                               \
+  STM32_DMA_GETCHANNEL(STM32_UART_USART2_TX_DMA_STREAM,                     \
+                       STM32_USART2_TX_DMA_CHN)
+
+#define USART3_TX_DMA_CHANNEL                                               \
+  STM32_DMA_GETCHANNEL(STM32_UART_USART3_TX_DMA_STREAM,                     \
+                       STM32_USART3_TX_DMA_CHN)
+
+#define UART4_TX_DMA_CHANNEL                                                \
+  STM32_DMA_GETCHANNEL(STM32_UART_UART4_TX_DMA_STREAM,                      \
+                       STM32_UART4_TX_DMA_CHN)
+
+#define UART5_TX_DMA_CHANNEL                                                \
+  STM32_DMA_GETCHANNEL(STM32_UART_UART5_TX_DMA_STREAM,                      \
+                       STM32_UART5_TX_DMA_CHN)
+
+#define USART6_TX_DMA_CHANNEL                                               \
+  STM32_DMA_GETCHANNEL(STM32_UART_USART6_TX_DMA_STREAM,                     \
+                       STM32_USART6_TX_DMA_CHN)
+#endif
+
 /*===========================================================================*/
 /* Driver exported variables.                                                */
 /*===========================================================================*/
@@ -91,6 +143,34 @@ static const SerialConfig default_config =
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+#if STM32_SERIAL_USE_TX_DMA || defined(__DOXYGEN__)
+/**
+ * @brief   Starts transmitting the next run of the output queue, if any.
+ * @details The data stays in the queue until the transfer is complete, so
+ *          the writers keep filling the space after it meanwhile.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver object
+ *
+ * @iclass
+ */
+static void tx_dma_start(SerialDriver *sdp) {
+  uint8_t *bp;
+  size_t n;
+
+  bp = oqGetRunI(&sdp->oqueue, &n);
+  if (bp == NULL)
+    return;
+
+  sdp->txdmasize = n;
+  sdp->usart->SR = ~USART_SR_TC;
+  dmaStreamSetMemory0(sdp->dmatx, bp);
+  dmaStreamSetTransactionSize(sdp->dmatx, n);
+  dmaStreamSetMode(sdp->dmatx, sdp->txdmamode | STM32_DMA_CR_DIR_M2P |
+                               STM32_DMA_CR_MINC | STM32_DMA_CR_TCIE);
+  dmaStreamEnable(sdp->dmatx);
+}
+#endif /* STM32_SERIAL_USE_TX_DMA */
+
 /**
  * @brief   USART initialization.
  * @details This function must be invoked with interrupts disabled.
@@ -100,6 +180,33 @@ static const SerialConfig default_config =
  */
 static void usart_init(SerialDriver *sdp, const SerialConfig *config) {
   USART_TypeDef *u = sdp->usart;
+  uint16_t cr1 = USART_CR1_RXNEIE;
+  uint16_t cr3 = 0;
+
+#if STM32_SERIAL_USE_RX_DMA
+  /* The DMA takes the received data, the line idle interrupt flushes a
+     partially filled buffer.*/
+  if (sdp->dmarx != NULL) {
+    dmaStreamDisable(sdp->dmarx);
+    cr1 = USART_CR1_IDLEIE;
+    cr3 = USART_CR3_DMAR;
+  }
+#endif
+
+#if STM32_SERIAL_USE_TX_DMA
+  /* A run interrupted by a reconfiguration restarts from its first byte
+     not yet transmitted.*/
+  if (sdp->dmatx != NULL) {
+    dmaStreamDisable(sdp->dmatx);
+    if (sdp->txdmasize > 0U) {
+      oqReleaseRunI(&sdp->oqueue, sdp->txdmasize -
+                                  dmaStreamGetTransactionSize(sdp->dmatx));
+      sdp->txdmasize = 0;
+    }
+    dmaStreamSetPeripheral(sdp->dmatx, &u->DR);
+    cr3 |= USART_CR3_DMAT;
+  }
+#endif
 
   /* Baud rate setting.*/
 #if STM32_HAS_USART6
@@ -113,10 +220,9 @@ static void usart_init(SerialDriver *sdp, const SerialConfig *config) {
 
   /* Note that some bits are enforced.*/
   u->CR2 = config->cr2 | USART_CR2_LBDIE;
-  u->CR3 = config->cr3 | USART_CR3_EIE;
-  u->CR1 = config->cr1 | USART_CR1_UE | USART_CR1_PEIE |
-                         USART_CR1_RXNEIE | USART_CR1_TE |
-                         USART_CR1_RE;
+  u->CR3 = config->cr3 | cr3 | USART_CR3_EIE;
+  u->CR1 = config->cr1 | cr1 | USART_CR1_UE | USART_CR1_PEIE |
+                               USART_CR1_TE | USART_CR1_RE;
   u->SR = 0;
   (void)u->SR;  /* SR reset step 1.*/
   (void)u->DR;  /* SR reset step 2.*/
@@ -129,6 +235,26 @@ static void usart_init(SerialDriver *sdp, const SerialConfig *config) {
   else {
     sdp->rxmask = 0xFF;
   }
+
+#if STM32_SERIAL_USE_RX_DMA
+  /* Starting the circular receive, the stream is enabled last so that it
+     picks up any byte already waiting in DR.*/
+  if (sdp->dmarx != NULL) {
+    sdp->rxdmapos = 0;
+    dmaStreamSetPeripheral(sdp->dmarx, &u->DR);
+    dmaStreamSetMemory0(sdp->dmarx, sdp->rxdmabuf);
+    dmaStreamSetTransactionSize(sdp->dmarx, STM32_SERIAL_RX_DMA_BUFFER_SIZE);
+    dmaStreamSetMode(sdp->dmarx, sdp->rxdmamode | STM32_DMA_CR_DIR_P2M |
+                                 STM32_DMA_CR_MINC | STM32_DMA_CR_CIRC |
+                                 STM32_DMA_CR_HTIE | STM32_DMA_CR_TCIE);
+    dmaStreamEnable(sdp->dmarx);
+  }
+#endif
+
+#if STM32_SERIAL_USE_TX_DMA
+  if (sdp->dmatx != NULL)
+    tx_dma_start(sdp);
+#endif
 }
 
 /**
@@ -164,6 +290,166 @@ static void set_error(SerialDriver *sdp, uint16_t sr) {
   chnAddFlagsI(sdp, sts);
 }
 
+#if STM32_SERIAL_USE_RX_DMA || defined(__DOXYGEN__)
+/**
+ * @brief   Moves a contiguous part of the receive DMA buffer to the queue.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver object
+ * @param[in] start     offset of the first byte in the DMA buffer
+ * @param[in] end       offset after the last byte in the DMA buffer
+ */
+static void rx_dma_push(SerialDriver *sdp, size_t start, size_t end) {
+  uint8_t *bp = &sdp->rxdmabuf[start];
+  size_t n = end - start;
+
+  /* The parity bit is stored by the DMA too.*/
+  if (sdp->rxmask != 0xFF) {
+    size_t i;
+
+    for (i = 0; i < n; i++)
+      bp[i] &= sdp->rxmask;
+  }
+  sdIncomingBufferI(sdp, bp, n);
+}
+
+/**
+ * @brief   Moves the data received since the previous call to the queue.
+ * @details Invoked on the half transfer, transfer complete and line idle
+ *          events. The DMA and USART interrupts have the same priority so
+ *          the calls cannot nest.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver object
+ */
+static void rx_dma_drain(SerialDriver *sdp) {
+  size_t pos;
+
+  pos = STM32_SERIAL_RX_DMA_BUFFER_SIZE -
+        dmaStreamGetTransactionSize(sdp->dmarx);
+  if (pos >= STM32_SERIAL_RX_DMA_BUFFER_SIZE)
+    pos = 0;
+  if (pos == sdp->rxdmapos)
+    return;
+
+#if HAL_QUEUES_USE_SPSC == FALSE
+  osalSysLockFromISR();
+#endif
+  if (pos < sdp->rxdmapos) {
+    rx_dma_push(sdp, sdp->rxdmapos, STM32_SERIAL_RX_DMA_BUFFER_SIZE);
+    sdp->rxdmapos = 0;
+  }
+  if (pos > sdp->rxdmapos)
+    rx_dma_push(sdp, sdp->rxdmapos, pos);
+  sdp->rxdmapos = pos;
+#if HAL_QUEUES_USE_SPSC == FALSE
+  osalSysUnlockFromISR();
+#endif
+}
+
+/**
+ * @brief   Receive DMA IRQ handler.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver object
+ * @param[in] flags     pre-shifted content of the ISR register
+ */
+static void serve_rx_dma_interrupt(SerialDriver *sdp, uint32_t flags) {
+
+  /* DMA errors handling.*/
+#if defined(STM32_SERIAL_DMA_ERROR_HOOK)
+  if ((flags & (STM32_DMA_ISR_TEIF | STM32_DMA_ISR_DMEIF)) != 0) {
+    STM32_SERIAL_DMA_ERROR_HOOK(sdp);
+  }
+#else
+  (void)flags;
+#endif
+
+  rx_dma_drain(sdp);
+}
+
+/**
+ * @brief   Allocates the receive DMA stream of a driver.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver object
+ * @param[in] priority  IRQ priority of the USART
+ */
+static void rx_dma_allocate(SerialDriver *sdp, uint32_t priority) {
+  bool b;
+
+  b = dmaStreamAllocate(sdp->dmarx, priority,
+                        (stm32_dmaisr_t)serve_rx_dma_interrupt,
+                        (void *)sdp);
+  osalDbgAssert(!b, "stream already allocated");
+}
+#endif /* STM32_SERIAL_USE_RX_DMA */
+
+#if STM32_SERIAL_USE_TX_DMA || defined(__DOXYGEN__)
+/**
+ * @brief   Transmit DMA IRQ handler.
+ * @details Removes the transmitted run from the output queue and chains
+ *          the next one, the transmission end is detected by the USART
+ *          once the queue is empty.
+ * @note    A DMA error stops the run short, only the bytes actually moved
+ *          are removed, the rest is sent again by the next run and the
+ *          error is reported as @p SD_OVERRUN_ERROR.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver object
+ * @param[in] flags     pre-shifted content of the ISR register
+ */
+static void serve_tx_dma_interrupt(SerialDriver *sdp, uint32_t flags) {
+  size_t sent;
+
+  /* DMA errors handling.*/
+#if defined(STM32_SERIAL_DMA_ERROR_HOOK)
+  if ((flags & (STM32_DMA_ISR_TEIF | STM32_DMA_ISR_DMEIF)) != 0) {
+    STM32_SERIAL_DMA_ERROR_HOOK(sdp);
+  }
+#endif
+
+  osalSysLockFromISR();
+  dmaStreamDisable(sdp->dmatx);
+  sent = sdp->txdmasize - dmaStreamGetTransactionSize(sdp->dmatx);
+  oqReleaseRunI(&sdp->oqueue, sent);
+  sdp->txdmasize = 0;
+  if ((flags & (STM32_DMA_ISR_TEIF | STM32_DMA_ISR_DMEIF)) != 0) {
+    chnAddFlagsI(sdp, SD_OVERRUN_ERROR);
+  }
+  tx_dma_start(sdp);
+  if (sdp->txdmasize == 0U) {
+    chnAddFlagsI(sdp, CHN_OUTPUT_EMPTY);
+    sdp->usart->CR1 |= USART_CR1_TCIE;
+  }
+  osalSysUnlockFromISR();
+}
+
+/**
+ * @brief   Output queue notification in DMA transmit mode.
+ * @note    Invoked with the lock held, a run in progress chains the new
+ *          data when it completes.
+ *
+ * @param[in] qp        pointer to the output queue
+ */
+static void tx_dma_notify(io_queue_t *qp) {
+  SerialDriver *sdp = (SerialDriver *)qp->q_link;
+
+  if (sdp->txdmasize == 0U)
+    tx_dma_start(sdp);
+}
+
+/**
+ * @brief   Allocates the transmit DMA stream of a driver.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver object
+ * @param[in] priority  IRQ priority of the USART
+ */
+static void tx_dma_allocate(SerialDriver *sdp, uint32_t priority) {
+  bool b;
+
+  b = dmaStreamAllocate(sdp->dmatx, priority,
+                        (stm32_dmaisr_t)serve_tx_dma_interrupt,
+                        (void *)sdp);
+  osalDbgAssert(!b, "stream already allocated");
+}
+#endif /* STM32_SERIAL_USE_TX_DMA */
+
 /**
  * @brief   Common IRQ handler.
  *
@@ -182,21 +468,52 @@ static void serve_interrupt(SerialDriver *sdp) {
     osalSysUnlockFromISR();
   }
 
-  /* Data available.*/
-  osalSysLockFromISR();
-  while (sr & (USART_SR_RXNE | USART_SR_ORE | USART_SR_NE | USART_SR_FE |
-               USART_SR_PE)) {
-    uint8_t b;
-
-    /* Error condition detection.*/
-    if (sr & (USART_SR_ORE | USART_SR_NE | USART_SR_FE  | USART_SR_PE))
-      set_error(sdp, sr);
-    b = (uint8_t)u->DR & sdp->rxmask;
-    if (sr & USART_SR_RXNE)
-      sdIncomingDataI(sdp, b);
-    sr = u->SR;
+#if STM32_SERIAL_USE_RX_DMA
+  /* The DMA moves the data, errors and line idle are cleared by reading DR
+     after SR.*/
+  if (sdp->dmarx != NULL) {
+    if (sr & (USART_SR_IDLE | USART_SR_ORE | USART_SR_NE | USART_SR_FE |
+              USART_SR_PE)) {
+      (void)u->DR;
+      if (sr & (USART_SR_ORE | USART_SR_NE | USART_SR_FE | USART_SR_PE)) {
+        osalSysLockFromISR();
+        set_error(sdp, sr);
+        osalSysUnlockFromISR();
+      }
+      if (sr & USART_SR_IDLE)
+        rx_dma_drain(sdp);
+    }
+  }
+  else
+#endif
+  {
+    /* Data available, in SPSC mode the input queue is filled unlocked.*/
+#if HAL_QUEUES_USE_SPSC == FALSE
+    osalSysLockFromISR();
+#endif
+    while (sr & (USART_SR_RXNE | USART_SR_ORE | USART_SR_NE | USART_SR_FE |
+                 USART_SR_PE)) {
+      uint8_t b;
+
+      /* Error condition detection.*/
+      if (sr & (USART_SR_ORE | USART_SR_NE | USART_SR_FE  | USART_SR_PE)) {
+#if HAL_QUEUES_USE_SPSC == TRUE
+        osalSysLockFromISR();
+        set_error(sdp, sr);
+        osalSysUnlockFromISR();
+#else
+        set_error(sdp, sr);
+#endif
+      }
+      b = (uint8_t)u->DR & sdp->rxmask;
+      if (sr & USART_SR_RXNE)
+        sdIncomingDataI(sdp, b);
+      sr = u->SR;
+    }
+#if HAL_QUEUES_USE_SPSC == FALSE
+    osalSysUnlockFromISR();
+#endif
   }
-  osalSysUnlockFromISR();
 
   /* Transmission buffer empty.*/
   if ((cr1 & USART_CR1_TXEIE) && (sr & USART_SR_TXE)) {
@@ -223,7 +540,8 @@ static void serve_interrupt(SerialDriver *sdp) {
   }
 }
 
-#if STM32_SERIAL_USE_USART1 || defined(__DOXYGEN__)
+#if (STM32_SERIAL_USE_USART1 && !STM32_SERIAL_USE_TX_DMA) ||                \
+    defined(__DOXYGEN__)
 static void notify1(io_queue_t *qp) {
 
   (void)qp;
@@ -231,7 +549,8 @@ static void notify1(io_queue_t *qp) {
 }
 #endif
 
-#if STM32_SERIAL_USE_USART2 || defined(__DOXYGEN__)
+#if (STM32_SERIAL_USE_USART2 && !STM32_SERIAL_USE_TX_DMA) ||                \
+    defined(__DOXYGEN__)
 static void notify2(io_queue_t *qp) {
 
   (void)qp;
@@ -239,7 +558,8 @@ static void notify2(io_queue_t *qp) {
 }
 #endif
 
-#if STM32_SERIAL_USE_USART3 || defined(__DOXYGEN__)
+#if (STM32_SERIAL_USE_USART3 && !STM32_SERIAL_USE_TX_DMA) ||                \
+    defined(__DOXYGEN__)
 static void notify3(io_queue_t *qp) {
 
   (void)qp;
@@ -247,7 +567,8 @@ static void notify3(io_queue_t *qp) {
 }
 #endif
 
-#if STM32_SERIAL_USE_UART4 || defined(__DOXYGEN__)
+#if (STM32_SERIAL_USE_UART4 && !STM32_SERIAL_USE_TX_DMA) ||                 \
+    defined(__DOXYGEN__)
 static void notify4(io_queue_t *qp) {
 
   (void)qp;
@@ -255,7 +576,8 @@ static void notify4(io_queue_t *qp) {
 }
 #endif
 
-#if STM32_SERIAL_USE_UART5 || defined(__DOXYGEN__)
+#if (STM32_SERIAL_USE_UART5 && !STM32_SERIAL_USE_TX_DMA) ||                 \
+    defined(__DOXYGEN__)
 static void notify5(io_queue_t *qp) {
 
   (void)qp;
@@ -263,7 +585,8 @@ static void notify5(io_queue_t *qp) {
 }
 #endif
 
-#if STM32_SERIAL_USE_USART6 || defined(__DOXYGEN__)
+#if (STM32_SERIAL_USE_USART6 && !STM32_SERIAL_USE_TX_DMA) ||                \
+    defined(__DOXYGEN__)
 static void notify6(io_queue_t *qp) {
 
   (void)qp;
@@ -455,33 +778,117 @@ OSAL_IRQ_HANDLER(STM32_UART8_HANDLER) {
 void sd_lld_init(void) {
 
 #if STM32_SERIAL_USE_USART1
+#if STM32_SERIAL_USE_TX_DMA
+  sdObjectInit(&SD1, NULL, tx_dma_notify);
+  SD1.dmatx     = STM32_DMA_STREAM(STM32_UART_USART1_TX_DMA_STREAM);
+  SD1.txdmamode = STM32_DMA_CR_CHSEL(USART1_TX_DMA_CHANNEL) |
+                  STM32_DMA_CR_PL(STM32_SERIAL_TX_DMA_PRIORITY) |
+                  STM32_DMA_CR_DMEIE | STM32_DMA_CR_TEIE;
+#else
   sdObjectInit(&SD1, NULL, notify1);
+#endif
   SD1.usart = USART1;
+#if STM32_SERIAL_USE_RX_DMA
+  SD1.dmarx     = STM32_DMA_STREAM(STM32_UART_USART1_RX_DMA_STREAM);
+  SD1.rxdmamode = STM32_DMA_CR_CHSEL(USART1_RX_DMA_CHANNEL) |
+                  STM32_DMA_CR_PL(STM32_SERIAL_RX_DMA_PRIORITY) |
+                  STM32_DMA_CR_DMEIE | STM32_DMA_CR_TEIE;
+#endif
 #endif
 
 #if STM32_SERIAL_USE_USART2
+#if STM32_SERIAL_USE_TX_DMA
+  sdObjectInit(&SD2, NULL, tx_dma_notify);
+  SD2.dmatx     = STM32_DMA_STREAM(STM32_UART_USART2_TX_DMA_STREAM);
+  SD2.txdmamode = STM32_DMA_CR_CHSEL(USART2_TX_DMA_CHANNEL) |
+                  STM32_DMA_CR_PL(STM32_SERIAL_TX_DMA_PRIORITY) |
+                  STM32_DMA_CR_DMEIE | STM32_DMA_CR_TEIE;
+#else
   sdObjectInit(&SD2, NULL, notify2);
+#endif
   SD2.usart = USART2;
+#if STM32_SERIAL_USE_RX_DMA
+  SD2.dmarx     = STM32_DMA_STREAM(STM32_UART_USART2_RX_DMA_STREAM);
+  SD2.rxdmamode = STM32_DMA_CR_CHSEL(USART2_RX_DMA_CHANNEL) |
+                  STM32_DMA_CR_PL(STM32_SERIAL_RX_DMA_PRIORITY) |
+                  STM32_DMA_CR_DMEIE | STM32_DMA_CR_TEIE;
+#endif
 #endif
 
 #if STM32_SERIAL_USE_USART3
+#if STM32_SERIAL_USE_TX_DMA
+  sdObjectInit(&SD3, NULL, tx_dma_notify);
+  SD3.dmatx     = STM32_DMA_STREAM(STM32_UART_USART3_TX_DMA_STREAM);
+  SD3.txdmamode = STM32_DMA_CR_CHSEL(USART3_TX_DMA_CHANNEL) |
+                  STM32_DMA_CR_PL(STM32_SERIAL_TX_DMA_PRIORITY) |
+                  STM32_DMA_CR_DMEIE | STM32_DMA_CR_TEIE;
+#else
   sdObjectInit(&SD3, NULL, notify3);
+#endif
   SD3.usart = USART3;
+#if STM32_SERIAL_USE_RX_DMA
+  SD3.dmarx     = STM32_DMA_STREAM(STM32_UART_USART3_RX_DMA_STREAM);
+  SD3.rxdmamode = STM32_DMA_CR_CHSEL(USART3_RX_DMA_CHANNEL) |
+                  STM32_DMA_CR_PL(STM32_SERIAL_RX_DMA_PRIORITY) |
+                  STM32_DMA_CR_DMEIE | STM32_DMA_CR_TEIE;
+#endif
 #endif
 
 #if STM32_SERIAL_USE_UART4
+#if STM32_SERIAL_USE_TX_DMA
+  sdObjectInit(&SD4, NULL, tx_dma_notify);
+  SD4.dmatx     = STM32_DMA_STREAM(STM32_UART_UART4_TX_DMA_STREAM);
+  SD4.txdmamode = STM32_DMA_CR_CHSEL(UART4_TX_DMA_CHANNEL) |
+                  STM32_DMA_CR_PL(STM32_SERIAL_TX_DMA_PRIORITY) |
+                  STM32_DMA_CR_DMEIE | STM32_DMA_CR_TEIE;
+#else
   sdObjectInit(&SD4, NULL, notify4);
+#endif
   SD4.usart = UART4;
+#if STM32_SERIAL_USE_RX_DMA
+  SD4.dmarx     = STM32_DMA_STREAM(STM32_UART_UART4_RX_DMA_STREAM);
+  SD4.rxdmamode = STM32_DMA_CR_CHSEL(UART4_RX_DMA_CHANNEL) |
+                  STM32_DMA_CR_PL(STM32_SERIAL_RX_DMA_PRIORITY) |
+                  STM32_DMA_CR_DMEIE | STM32_DMA_CR_TEIE;
+#endif
 #endif
 
 #if STM32_SERIAL_USE_UART5
+#if STM32_SERIAL_USE_TX_DMA
+  sdObjectInit(&SD5, NULL, tx_dma_notify);
+  SD5.dmatx     = STM32_DMA_STREAM(STM32_UART_UART5_TX_DMA_STREAM);
+  SD5.txdmamode = STM32_DMA_CR_CHSEL(UART5_TX_DMA_CHANNEL) |
+                  STM32_DMA_CR_PL(STM32_SERIAL_TX_DMA_PRIORITY) |
+                  STM32_DMA_CR_DMEIE | STM32_DMA_CR_TEIE;
+#else
   sdObjectInit(&SD5, NULL, notify5);
+#endif
   SD5.usart = UART5;
+#if STM32_SERIAL_USE_RX_DMA
+  SD5.dmarx     = STM32_DMA_STREAM(STM32_UART_UART5_RX_DMA_STREAM);
+  SD5.rxdmamode = STM32_DMA_CR_CHSEL(UART5_RX_DMA_CHANNEL) |
+                  STM32_DMA_CR_PL(STM32_SERIAL_RX_DMA_PRIORITY) |
+                  STM32_DMA_CR_DMEIE | STM32_DMA_CR_TEIE;
+#endif
 #endif
 
 #if STM32_SERIAL_USE_USART6
+#if STM32_SERIAL_USE_TX_DMA
+  sdObjectInit(&SD6, NULL, tx_dma_notify);
+  SD6.dmatx     = STM32_DMA_STREAM(STM32_UART_USART6_TX_DMA_STREAM);
+  SD6.txdmamode = STM32_DMA_CR_CHSEL(USART6_TX_DMA_CHANNEL) |
+                  STM32_DMA_CR_PL(STM32_SERIAL_TX_DMA_PRIORITY) |
+                  STM32_DMA_CR_DMEIE | STM32_DMA_CR_TEIE;
+#else
   sdObjectInit(&SD6, NULL, notify6);
+#endif
   SD6.usart = USART6;
+#if STM32_SERIAL_USE_RX_DMA
+  SD6.dmarx     = STM32_DMA_STREAM(STM32_UART_USART6_RX_DMA_STREAM);
+  SD6.rxdmamode = STM32_DMA_CR_CHSEL(USART6_RX_DMA_CHANNEL) |
+                  STM32_DMA_CR_PL(STM32_SERIAL_RX_DMA_PRIORITY) |
+                  STM32_DMA_CR_DMEIE | STM32_DMA_CR_TEIE;
+#endif
 #endif
 
 #if STM32_SERIAL_USE_UART7
@@ -513,36 +920,72 @@ void sd_lld_start(SerialDriver *sdp, const SerialConfig *config) {
   if (sdp->state == SD_STOP) {
 #if STM32_SERIAL_USE_USART1
     if (&SD1 == sdp) {
+#if STM32_SERIAL_USE_RX_DMA
+      rx_dma_allocate(sdp, STM32_SERIAL_USART1_PRIORITY);
+#endif
+#if STM32_SERIAL_USE_TX_DMA
+      tx_dma_allocate(sdp, STM32_SERIAL_USART1_PRIORITY);
+#endif
       rccEnableUSART1(FALSE);
       nvicEnableVector(STM32_USART1_NUMBER, STM32_SERIAL_USART1_PRIORITY);
     }
 #endif
 #if STM32_SERIAL_USE_USART2
     if (&SD2 == sdp) {
+#if STM32_SERIAL_USE_RX_DMA
+      rx_dma_allocate(sdp, STM32_SERIAL_USART2_PRIORITY);
+#endif
+#if STM32_SERIAL_USE_TX_DMA
+      tx_dma_allocate(sdp, STM32_SERIAL_USART2_PRIORITY);
+#endif
       rccEnableUSART2(FALSE);
       nvicEnableVector(STM32_USART2_NUMBER, STM32_SERIAL_USART2_PRIORITY);
     }
 #endif
 #if STM32_SERIAL_USE_USART3
     if (&SD3 == sdp) {
+#if STM32_SERIAL_USE_RX_DMA
+      rx_dma_allocate(sdp, STM32_SERIAL_USART3_PRIORITY);
+#endif
+#if STM32_SERIAL_USE_TX_DMA
+      tx_dma_allocate(sdp, STM32_SERIAL_USART3_PRIORITY);
+#endif
       rccEnableUSART3(FALSE);
       nvicEnableVector(STM32_USART3_NUMBER, STM32_SERIAL_USART3_PRIORITY);
     }
 #endif
 #if STM32_SERIAL_USE_UART4
     if (&SD4 == sdp) {
+#if STM32_SERIAL_USE_RX_DMA
+      rx_dma_allocate(sdp, STM32_SERIAL_UART4_PRIORITY);
+#endif
+#if STM32_SERIAL_USE_TX_DMA
+      tx_dma_allocate(sdp, STM32_SERIAL_UART4_PRIORITY);
+#endif
       rccEnableUART4(FALSE);
       nvicEnableVector(STM32_UART4_NUMBER, STM32_SERIAL_UART4_PRIORITY);
     }
 #endif
 #if STM32_SERIAL_USE_UART5
     if (&SD5 == sdp) {
+#if STM32_SERIAL_USE_RX_DMA
+      rx_dma_allocate(sdp, STM32_SERIAL_UART5_PRIORITY);
+#endif
+#if STM32_SERIAL_USE_TX_DMA
+      tx_dma_allocate(sdp, STM32_SERIAL_UART5_PRIORITY);
+#endif
       rccEnableUART5(FALSE);
       nvicEnableVector(STM32_UART5_NUMBER, STM32_SERIAL_UART5_PRIORITY);
     }
 #endif
 #if STM32_SERIAL_USE_USART6
     if (&SD6 == sdp) {
+#if STM32_SERIAL_USE_RX_DMA
+      rx_dma_allocate(sdp, STM32_SERIAL_USART6_PRIORITY);
+#endif
+#if STM32_SERIAL_USE_TX_DMA
+      tx_dma_allocate(sdp, STM32_SERIAL_USART6_PRIORITY);
+#endif
       rccEnableUSART6(FALSE);
       nvicEnableVector(STM32_USART6_NUMBER, STM32_SERIAL_USART6_PRIORITY);
     }
@@ -576,6 +1019,19 @@ void sd_lld_stop(SerialDriver *sdp) {
 
   if (sdp->state == SD_READY) {
     usart_deinit(sdp->usart);
+#if STM32_SERIAL_USE_RX_DMA
+    if (sdp->dmarx != NULL) {
+      dmaStreamDisable(sdp->dmarx);
+      dmaStreamRelease(sdp->dmarx);
+    }
+#endif
+#if STM32_SERIAL_USE_TX_DMA
+    if (sdp->dmatx != NULL) {
+      dmaStreamDisable(sdp->dmatx);
+      dmaStreamRelease(sdp->dmatx);
+      sdp->txdmasize = 0;
+    }
+#endif
 #if STM32_SERIAL_USE_USART1
     if (&SD1 == sdp) {
       rccDisableUSART1(FALSE);
@@ -166,6 +166,56 @@
 #if !defined(STM32_SERIAL_UART8_PRIORITY) || defined(__DOXYGEN__)
 #define STM32_SERIAL_UART8_PRIORITY         12
 #endif
+
+/**
+ * @brief   DMA receive mode switch.
+ * @details If set to @p TRUE the USART1...USART6 drivers receive through a
+ *          circular DMA buffer which is moved into the input queue in blocks
+ *          on half transfer, transfer complete and line idle events, instead
+ *          of taking an interrupt for each received byte.
+ * @note    UART7 and UART8 are always interrupt driven.
+ * @note    The DMA streams are the ones assigned to the UART driver, the
+ *          two drivers cannot share an USART anyway.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(STM32_SERIAL_USE_RX_DMA) || defined(__DOXYGEN__)
+#define STM32_SERIAL_USE_RX_DMA             FALSE
+#endif
+
+/**
+ * @brief   Size of the receive DMA buffer of each driver.
+ * @details The buffer is drained every half, it must be able to hold the
+ *          data received while the interrupts are masked.
+ */
+#if !defined(STM32_SERIAL_RX_DMA_BUFFER_SIZE) || defined(__DOXYGEN__)
+#define STM32_SERIAL_RX_DMA_BUFFER_SIZE     64
+#endif
+
+/**
+ * @brief   Receive DMA streams priority level setting.
+ */
+#if !defined(STM32_SERIAL_RX_DMA_PRIORITY) || defined(__DOXYGEN__)
+#define STM32_SERIAL_RX_DMA_PRIORITY        0
+#endif
+
+/**
+ * @brief   DMA transmit mode switch.
+ * @details If set to @p TRUE the USART1...USART6 drivers transmit the
+ *          contiguous runs of the output queue buffer using a DMA, instead
+ *          of taking an interrupt for each transmitted byte.
+ * @note    UART7 and UART8 are always interrupt driven.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(STM32_SERIAL_USE_TX_DMA) || defined(__DOXYGEN__)
+#define STM32_SERIAL_USE_TX_DMA             FALSE
+#endif
+
+/**
+ * @brief   Transmit DMA streams priority level setting.
+ */
+#if !defined(STM32_SERIAL_TX_DMA_PRIORITY) || defined(__DOXYGEN__)
+#define STM32_SERIAL_TX_DMA_PRIORITY        0
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -251,6 +301,161 @@
 #error "Invalid IRQ priority assigned to UART8"
 #endif
 
+#if STM32_SERIAL_USE_RX_DMA
+#if (STM32_SERIAL_RX_DMA_BUFFER_SIZE < 2) ||                                \
+    ((STM32_SERIAL_RX_DMA_BUFFER_SIZE & 1) != 0)
+#error "STM32_SERIAL_RX_DMA_BUFFER_SIZE must be an even number"
+#endif
+
+#if !STM32_DMA_IS_VALID_PRIORITY(STM32_SERIAL_RX_DMA_PRIORITY)
+#error "Invalid DMA priority assigned to the serial RX streams"
+#endif
+
+/* The following checks are only required when there is a DMA able to
+   reassign streams to different channels.*/
+#if STM32_ADVANCED_DMA
+/* Check on the presence of the DMA streams settings in mcuconf.h.*/
+#if STM32_SERIAL_USE_USART1 && !defined(STM32_UART_USART1_RX_DMA_STREAM)
+#error "USART1 RX DMA stream not defined"
+#endif
+
+#if STM32_SERIAL_USE_USART2 && !defined(STM32_UART_USART2_RX_DMA_STREAM)
+#error "USART2 RX DMA stream not defined"
+#endif
+
+#if STM32_SERIAL_USE_USART3 && !defined(STM32_UART_USART3_RX_DMA_STREAM)
+#error "USART3 RX DMA stream not defined"
+#endif
+
+#if STM32_SERIAL_USE_UART4 && !defined(STM32_UART_UART4_RX_DMA_STREAM)
+#error "UART4 RX DMA stream not defined"
+#endif
+
+#if STM32_SERIAL_USE_UART5 && !defined(STM32_UART_UART5_RX_DMA_STREAM)
+#error "UART5 RX DMA stream not defined"
+#endif
+
+#if STM32_SERIAL_USE_USART6 && !defined(STM32_UART_USART6_RX_DMA_STREAM)
+#error "USART6 RX DMA stream not defined"
+#endif
+
+/* Check on the validity of the assigned DMA channels.*/
+#if STM32_SERIAL_USE_USART1 &&                                              \
+    !STM32_DMA_IS_VALID_ID(STM32_UART_USART1_RX_DMA_STREAM,                 \
+                           STM32_USART1_RX_DMA_MSK)
+#error "invalid DMA stream associated to USART1 RX"
+#endif
+
+#if STM32_SERIAL_USE_USART2 &&                                              \
+    !STM32_DMA_IS_VALID_ID(STM32_UART_USART2_RX_DMA_STREAM,                 \
+                           STM32_USART2_RX_DMA_MSK)
+#error "invalid DMA stream associated to USART2 RX"
+#endif
+
+#if STM32_SERIAL_USE_USART3 &&                                              \
+    !STM32_DMA_IS_VALID_ID(STM32_UART_USART3_RX_DMA_STREAM,                 \
+                           STM32_USART3_RX_DMA_MSK)
+#error "invalid DMA stream associated to USART3 RX"
+#endif
+
+#if STM32_SERIAL_USE_UART4 &&                                               \
+    !STM32_DMA_IS_VALID_ID(STM32_UART_UART4_RX_DMA_STREAM,                  \
+                           STM32_UART4_RX_DMA_MSK)
+#error "invalid DMA stream associated to UART4 RX"
+#endif
+
+#if STM32_SERIAL_USE_UART5 &&                                               \
+    !STM32_DMA_IS_VALID_ID(STM32_UART_UART5_RX_DMA_STREAM,                  \
+                           STM32_UART5_RX_DMA_MSK)
+#error "invalid DMA stream associated to UART5 RX"
+#endif
+
+#if STM32_SERIAL_USE_USART6 &&                                              \
+    !STM32_DMA_IS_VALID_ID(STM32_UART_USART6_RX_DMA_STREAM,                 \
+                           STM32_USART6_RX_DMA_MSK)
+#error "invalid DMA stream associated to USART6 RX"
+#endif
+#endif /* STM32_ADVANCED_DMA */
+#endif /* STM32_SERIAL_USE_RX_DMA */
+
+#if STM32_SERIAL_USE_TX_DMA
+#if !STM32_DMA_IS_VALID_PRIORITY(STM32_SERIAL_TX_DMA_PRIORITY)
+#error "Invalid DMA priority assigned to the serial TX streams"
+#endif
+
+/* The following checks are only required when there is a DMA able to
+   reassign streams to different channels.*/
+#if STM32_ADVANCED_DMA
+/* Check on the presence of the DMA streams settings in mcuconf.h.*/
+#if STM32_SERIAL_USE_USART1 && !defined(STM32_UART_USART1_TX_DMA_STREAM)
+#error "USART1 TX DMA stream not defined"
+#endif
+
+#if STM32_SERIAL_USE_USART2 && !defined(STM32_UART_USART2_TX_DMA_STREAM)
+#error "USART2 TX DMA stream not defined"
+#endif
+
+#if STM32_SERIAL_USE_USART3 && !defined(STM32_UART_USART3_TX_DMA_STREAM)
+#error "USART3 TX DMA stream not defined"
+#endif
+
+#if STM32_SERIAL_USE_UART4 && !defined(STM32_UART_UART4_TX_DMA_STREAM)
+#error "UART4 TX DMA stream not defined"
+#endif
+
+#if STM32_SERIAL_USE_UART5 && !defined(STM32_UART_UART5_TX_DMA_STREAM)
+#error "UART5 TX DMA stream not defined"
+#endif
+
+#if STM32_SERIAL_USE_USART6 && !defined(STM32_UART_USART6_TX_DMA_STREAM)
+#error "USART6 TX DMA stream not defined"
+#endif
+
+/* Check on the validity of the assigned DMA channels.*/
+#if STM32_SERIAL_USE_USART1 &&                                              \
+    !STM32_DMA_IS_VALID_ID(STM32_UART_USART1_TX_DMA_STREAM,                 \
+                           STM32_USART1_TX_DMA_MSK)
+#error "invalid DMA stream associated to USART1 TX"
+#endif
+
+#if STM32_SERIAL_USE_USART2 &&                                              \
+    !STM32_DMA_IS_VALID_ID(STM32_UART_USART2_TX_DMA_STREAM,                 \
+                           STM32_USART2_TX_DMA_MSK)
+#error "invalid DMA stream associated to USART2 TX"
+#endif
+
+#if STM32_SERIAL_USE_USART3 &&                                              \
+    !STM32_DMA_IS_VALID_ID(STM32_UART_USART3_TX_DMA_STREAM,                 \
+                           STM32_USART3_TX_DMA_MSK)
+#error "invalid DMA stream associated to USART3 TX"
+#endif
+
+#if STM32_SERIAL_USE_UART4 &&                                               \
+    !STM32_DMA_IS_VALID_ID(STM32_UART_UART4_TX_DMA_STREAM,                  \
+                           STM32_UART4_TX_DMA_MSK)
+#error "invalid DMA stream associated to UART4 TX"
+#endif
+
+#if STM32_SERIAL_USE_UART5 &&                                               \
+    !STM32_DMA_IS_VALID_ID(STM32_UART_UART5_TX_DMA_STREAM,                  \
+                           STM32_UART5_TX_DMA_MSK)
+#error "invalid DMA stream associated to UART5 TX"
+#endif
+
+#if STM32_SERIAL_USE_USART6 &&                                              \
+    !STM32_DMA_IS_VALID_ID(STM32_UART_USART6_TX_DMA_STREAM,                 \
+                           STM32_USART6_TX_DMA_MSK)
+#error "invalid DMA stream associated to USART6 TX"
+#endif
+#endif /* STM32_ADVANCED_DMA */
+#endif /* STM32_SERIAL_USE_TX_DMA */
+
+#if STM32_SERIAL_USE_RX_DMA || STM32_SERIAL_USE_TX_DMA
+#if !defined(STM32_DMA_REQUIRED)
+#define STM32_DMA_REQUIRED
+#endif
+#endif
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -283,6 +488,38 @@ typedef struct {
   uint16_t                  cr3;
 } SerialConfig;
 
+/**
+ * @brief   @p SerialDriver receive DMA data.
+ */
+#if STM32_SERIAL_USE_RX_DMA || defined(__DOXYGEN__)
+#define _serial_driver_rx_dma_data                                          \
+  /* Receive DMA stream, NULL for an interrupt driven receiver.*/           \
+  const stm32_dma_stream_t  *dmarx;                                         \
+  /* Receive DMA mode bit mask.*/                                           \
+  uint32_t                  rxdmamode;                                      \
+  /* Position of the first byte not yet moved to the input queue.*/         \
+  size_t                    rxdmapos;                                       \
+  /* Receive DMA circular buffer.*/                                         \
+  uint8_t                   rxdmabuf[STM32_SERIAL_RX_DMA_BUFFER_SIZE];
+#else
+#define _serial_driver_rx_dma_data
+#endif
+
+/**
+ * @brief   @p SerialDriver transmit DMA data.
+ */
+#if STM32_SERIAL_USE_TX_DMA || defined(__DOXYGEN__)
+#define _serial_driver_tx_dma_data                                          \
+  /* Transmit DMA stream, NULL for an interrupt driven transmitter.*/       \
+  const stm32_dma_stream_t  *dmatx;                                         \
+  /* Transmit DMA mode bit mask.*/                                          \
+  uint32_t                  txdmamode;                                      \
+  /* Size of the output queue run being transmitted, zero if idle.*/        \
+  size_t                    txdmasize;
+#else
+#define _serial_driver_tx_dma_data
+#endif
+
 /**
  * @brief   @p SerialDriver specific data.
  */
@@ -302,7 +539,9 @@ typedef struct {
   /* Pointer to the USART registers block.*/                                \
   USART_TypeDef             *usart;                                         \
   /* Mask to be applied on received frames.*/                               \
-  uint8_t                   rxmask;
+  uint8_t                   rxmask;                                         \
+  _serial_driver_rx_dma_data                                                \
+  _serial_driver_tx_dma_data
 
 /*===========================================================================*/
 /* Driver macros.                                                            */
@@ -312,11 +312,15 @@ static void serve_interrupt(SerialDriver *sdp) {
     osalSysUnlockFromISR();
   }
 
-  /* Data available.*/
+  /* Data available, in SPSC mode the input queue is filled unlocked.*/
   if (isr & USART_ISR_RXNE) {
+#if HAL_QUEUES_USE_SPSC == TRUE
+    sdIncomingDataI(sdp, (uint8_t)u->RDR & sdp->rxmask);
+#else
     osalSysLockFromISR();
     sdIncomingDataI(sdp, (uint8_t)u->RDR & sdp->rxmask);
     osalSysUnlockFromISR();
+#endif
   }
 
   /* Transmission buffer empty.*/
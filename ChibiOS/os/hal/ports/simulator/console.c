@@ -21,8 +21,10 @@
  */
 
 #include <stdio.h>
+#if !defined(WIN32)
+#include <poll.h>
+#endif
 
-#include "ch.h"
 #include "hal.h"
 #include "console.h"
 
@@ -43,74 +45,98 @@ BaseChannel CD1;
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
-static size_t _write(void *ip, const uint8_t *bp, size_t n) {
+/*
+ * Reads a character without blocking the whole simulator, the calling task
+ * sleeps a tick at a time until input is available.
+ */
+static msg_t getc_timeout(systime_t time) {
+#if !defined(WIN32)
+  struct pollfd pfd = {0, POLLIN, 0};
+  uint8_t b;
+
+  while (poll(&pfd, 1, 0) <= 0) {
+    if (time == TIME_IMMEDIATE)
+      return MSG_TIMEOUT;
+    osalThreadSleep(1);
+    if (time != TIME_INFINITE)
+      time--;
+  }
+  if (read(0, &b, 1) != 1)
+    return MSG_RESET;
+  return b;
+#else
+  (void)time;
+
+  return fgetc(stdin);
+#endif
+}
+
+static size_t _writet(void *ip, const uint8_t *bp, size_t n, systime_t time) {
   size_t ret;
 
   (void)ip;
+  (void)time;
 
+  /* stdio is not reentrant, the tick could switch to another writer.*/
+  osalSysLock();
   ret = fwrite(bp, 1, n, stdout);
   fflush(stdout);
+  osalSysUnlock();
   return ret;
 }
 
-static size_t _read(void *ip, uint8_t *bp, size_t n) {
+static size_t _readt(void *ip, uint8_t *bp, size_t n, systime_t time) {
+  size_t i;
+  msg_t b;
 
   (void)ip;
 
-  return fread(bp, 1, n, stdin);
+  for (i = 0; i < n; i++) {
+    b = getc_timeout(time);
+    if (b < MSG_OK)
+      break;
+    bp[i] = (uint8_t)b;
+  }
+  return i;
 }
 
-static msg_t _put(void *ip, uint8_t b) {
+static msg_t _putt(void *ip, uint8_t b, systime_t time) {
 
   (void)ip;
+  (void)time;
 
+  osalSysLock();
   fputc(b, stdout);
   fflush(stdout);
+  osalSysUnlock();
   return MSG_OK;
 }
 
-static msg_t _get(void *ip) {
+static msg_t _gett(void *ip, systime_t time) {
 
   (void)ip;
 
-  return fgetc(stdin);
+  return getc_timeout(time);
 }
 
-static msg_t _putt(void *ip, uint8_t b, systime_t time) {
-
-  (void)ip;
-  (void)time;
+static size_t _write(void *ip, const uint8_t *bp, size_t n) {
 
-  fputc(b, stdout);
-  fflush(stdout);
-  return MSG_OK;
+  return _writet(ip, bp, n, TIME_INFINITE);
 }
 
-static msg_t _gett(void *ip, systime_t time) {
-
-  (void)ip;
-  (void)time;
+static size_t _read(void *ip, uint8_t *bp, size_t n) {
 
-  return fgetc(stdin);
+  return _readt(ip, bp, n, TIME_INFINITE);
 }
 
-static size_t _writet(void *ip, const uint8_t *bp, size_t n, systime_t time) {
-  size_t ret;
-
-  (void)ip;
-  (void)time;
+static msg_t _put(void *ip, uint8_t b) {
 
-  ret = fwrite(bp, 1, n, stdout);
-  fflush(stdout);
-  return ret;
+  return _putt(ip, b, TIME_INFINITE);
 }
 
-static size_t _readt(void *ip, uint8_t *bp, size_t n, systime_t time) {
-
-  (void)ip;
-  (void)time;
+static msg_t _get(void *ip) {
 
-  return fread(bp, 1, n, stdin);
+  return _gett(ip, TIME_INFINITE);
 }
 
 static const struct BaseChannelVMT vmt = {
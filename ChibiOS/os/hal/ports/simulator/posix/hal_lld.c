@@ -24,7 +24,6 @@
 
 #include <stdio.h>
 #include <stdlib.h>
-#include <sys/time.h>
 
 #include "hal.h"
 
@@ -36,9 +35,6 @@
 /* Driver local variables and types.                                         */
 /*===========================================================================*/
 
-static struct timeval nextcnt;
-static struct timeval tick = {0UL, 1000000UL / OSAL_ST_FREQUENCY};
-
 /*===========================================================================*/
 /* Driver local functions.                                                   */
 /*===========================================================================*/
@@ -53,51 +49,35 @@ static struct timeval tick = {0UL, 1000000UL / OSAL_ST_FREQUENCY};
 
 /**
  * @brief Low level HAL driver initialization.
+ * @note  The system tick is generated by the FreeRTOS port, only the
+ *        simulated peripherals are polled from here.
  */
 void hal_lld_init(void) {
 
 #if defined(__APPLE__)
-  puts("ChibiOS/RT simulator (OS X)\n");
+  puts("FreeRTOS/HAL simulator (OS X)\n");
 #else
-  puts("ChibiOS/RT simulator (Linux)\n");
+  puts("FreeRTOS/HAL simulator (Linux)\n");
 #endif
-  gettimeofday(&nextcnt, NULL);
-  timeradd(&nextcnt, &tick, &nextcnt);
+  vPortSetInterruptHandler(_sim_check_for_interrupts);
 }
 
 /**
  * @brief   Interrupt simulation.
+ * @note    Called by the port in interrupt context, once per tick and when
+ *          the idle task wakes up.
  */
 void _sim_check_for_interrupts(void) {
-  struct timeval tv;
 
 #if HAL_USE_SERIAL
-  if (sd_lld_interrupt_pending()) {
-    _dbg_check_lock();
-    if (chSchIsPreemptionRequired())
-      chSchDoReschedule();
-    _dbg_check_unlock();
-    return;
-  }
-#endif
-
-  gettimeofday(&tv, NULL);
-  if (timercmp(&tv, &nextcnt, >=)) {
-    timeradd(&nextcnt, &tick, &nextcnt);
+  unsigned i;
 
-    CH_IRQ_PROLOGUE();
-
-    chSysLockFromISR();
-    chSysTimerHandlerI();
-    chSysUnlockFromISR();
-
-    CH_IRQ_EPILOGUE();
-
-    _dbg_check_lock();
-    if (chSchIsPreemptionRequired())
-      chSchDoReschedule();
-    _dbg_check_unlock();
+  /* Bounded, a peer flooding a socket must not starve the tasks.*/
+  for (i = 0; i < SIM_MAX_IRQ_PER_TICK; i++) {
+    if (!sd_lld_interrupt_pending())
+      break;
   }
+#endif
 }
 
 /** @} */
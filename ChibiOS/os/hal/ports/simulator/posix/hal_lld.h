@@ -53,6 +53,13 @@
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Maximum number of simulated peripheral events served per tick.
+ */
+#if !defined(SIM_MAX_IRQ_PER_TICK) || defined(__DOXYGEN__)
+#define SIM_MAX_IRQ_PER_TICK                64
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
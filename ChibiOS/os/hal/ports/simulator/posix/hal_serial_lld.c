@@ -169,11 +169,16 @@ static bool inint(SerialDriver *sdp) {
       sdp->com_data = -1;
       return false;
     }
-    for (i = 0; i < n; i++) {
-      osalSysLockFromISR();
+#if HAL_QUEUES_USE_SPSC == TRUE
+    /* The input queue is filled unlocked.*/
+    for (i = 0; i < n; i++)
       sdIncomingDataI(sdp, data[i]);
-      osalSysUnlockFromISR();
-    }
+#else
+    osalSysLockFromISR();
+    for (i = 0; i < n; i++)
+      sdIncomingDataI(sdp, data[i]);
+    osalSysUnlockFromISR();
+#endif
     return true;
   }
   return false;
@@ -183,18 +188,24 @@ static bool outint(SerialDriver *sdp) {
 
   if (sdp->com_data != -1) {
     int n;
-    uint8_t data[1];
+    size_t i;
+    msg_t b;
+    uint8_t data[32];
 
     /*
-     * Input.
+     * Output, whatever is in the queue goes out with a single send().
      */
     osalSysLockFromISR();
-    n = sdRequestDataI(sdp);
+    for (i = 0; i < sizeof(data); i++) {
+      b = sdRequestDataI(sdp);
+      if (b < MSG_OK)
+        break;
+      data[i] = (uint8_t)b;
+    }
     osalSysUnlockFromISR();
-    if (n < 0)
+    if (i == 0)
       return false;
-    data[0] = (uint8_t)n;
-    n = send(sdp->com_data, data, sizeof(data), 0);
+    n = send(sdp->com_data, data, i, 0);
     switch (n) {
     case 0:
       close(sdp->com_data);
@@ -279,14 +290,23 @@ void sd_lld_stop(SerialDriver *sdp) {
   (void)sdp;
 }
 
+/**
+ * @brief   Serves the simulated serial interrupts.
+ * @note    Called from the port interrupt simulation.
+ *
+ * @return              @p true if any event was served.
+ */
 bool sd_lld_interrupt_pending(void) {
-  bool b;
+  bool b = false;
 
   OSAL_IRQ_PROLOGUE();
 
-  b =  connint(&SD1) || connint(&SD2) ||
-       inint(&SD1)   || inint(&SD2)   ||
-       outint(&SD1)  || outint(&SD2);
+#if USE_SIM_SERIAL1
+  b = connint(&SD1) || inint(&SD1) || outint(&SD1);
+#endif
+#if USE_SIM_SERIAL2
+  b = connint(&SD2) || inint(&SD2) || outint(&SD2) || b;
+#endif
 
   OSAL_IRQ_EPILOGUE();
 
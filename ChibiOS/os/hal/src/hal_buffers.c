@@ -89,6 +89,7 @@ void ibqObjectInit(input_buffers_queue_t *ibqp, bool suspended, uint8_t *bp,
   ibqp->buffers   = bp;
   ibqp->ptr       = NULL;
   ibqp->top       = NULL;
+  ibqp->lent      = false;
   ibqp->notify    = infy;
   ibqp->link      = link;
 }
@@ -113,6 +114,7 @@ void ibqResetI(input_buffers_queue_t *ibqp) {
   ibqp->bwrptr    = ibqp->buffers;
   ibqp->ptr       = NULL;
   ibqp->top       = NULL;
+  ibqp->lent      = false;
   osalThreadDequeueAllI(&ibqp->waiting, MSG_RESET);
 }
 
@@ -435,6 +437,88 @@ size_t ibqReadTimeout(input_buffers_queue_t *ibqp, uint8_t *bp,
   }
 }
 
+/**
+ * @brief   Lends the unread data of the next filled buffer.
+ * @details The application gets direct access to the data in the queue
+ *          buffer, which avoids the copy made by @p ibqReadTimeout(). The
+ *          data must be returned using @p ibqReturn() before any other read
+ *          operation on the queue.
+ * @note    If the current buffer has been partially read then only the
+ *          remaining data is lent.
+ *
+ * @param[in] ibqp      pointer to the @p input_buffers_queue_t object
+ * @param[out] bpp      pointer to a variable receiving the data pointer
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The size of the lent data.
+ * @retval 0            if a timeout occurred or the queue has been reset,
+ *                      nothing has to be returned in this case.
+ *
+ * @api
+ */
+size_t ibqBorrowTimeout(input_buffers_queue_t *ibqp, uint8_t **bpp,
+                        systime_t timeout) {
+  size_t size;
+
+  osalDbgCheck(bpp != NULL);
+
+  osalSysLock();
+
+  osalDbgAssert(!ibqp->lent, "already lent");
+
+  /* This condition indicates that a new buffer must be acquired.*/
+  if (ibqp->ptr == NULL) {
+    if (ibqGetFullBufferTimeoutS(ibqp, timeout) != MSG_OK) {
+      osalSysUnlock();
+      return 0U;
+    }
+  }
+
+  ibqp->lent = true;
+  *bpp = ibqp->ptr;
+  size = (size_t)ibqp->top - (size_t)ibqp->ptr;
+
+  osalSysUnlock();
+
+  return size;
+}
+
+/**
+ * @brief   Returns the data lent by @p ibqBorrowTimeout().
+ * @details The first @p n bytes are consumed, the buffer is released in the
+ *          queue once all its data has been consumed. The data not consumed
+ *          is lent again by the next @p ibqBorrowTimeout() or read by the
+ *          other read functions.
+ * @note    If the queue has been reset meanwhile then the function does
+ *          nothing.
+ *
+ * @param[in] ibqp      pointer to the @p input_buffers_queue_t object
+ * @param[in] n         number of consumed bytes, it can be zero
+ *
+ * @api
+ */
+void ibqReturn(input_buffers_queue_t *ibqp, size_t n) {
+
+  osalSysLock();
+
+  if (ibqp->lent) {
+    osalDbgCheck(n <= ((size_t)ibqp->top - (size_t)ibqp->ptr));
+
+    ibqp->lent = false;
+    ibqp->ptr += n;
+
+    /* Has the current data buffer been finished? if so then release it.*/
+    if (ibqp->ptr >= ibqp->top) {
+      ibqReleaseEmptyBufferS(ibqp);
+    }
+  }
+
+  osalSysUnlock();
+}
+
 /**
  * @brief   Initializes an output buffers queue object.
  *
@@ -464,6 +548,7 @@ void obqObjectInit(output_buffers_queue_t *obqp, bool suspended, uint8_t *bp,
   obqp->buffers   = bp;
   obqp->ptr       = NULL;
   obqp->top       = NULL;
+  obqp->lent      = false;
   obqp->notify    = onfy;
   obqp->link      = link;
 }
@@ -488,6 +573,7 @@ void obqResetI(output_buffers_queue_t *obqp) {
   obqp->bwrptr    = obqp->buffers;
   obqp->ptr       = NULL;
   obqp->top       = NULL;
+  obqp->lent      = false;
   osalThreadDequeueAllI(&obqp->waiting, MSG_RESET);
 }
 
@@ -836,7 +922,7 @@ bool obqTryFlushI(output_buffers_queue_t *obqp) {
 
   /* If queue is empty and there is a buffer partially filled and
      it is not being written.*/
-  if (obqIsEmptyI(obqp) && (obqp->ptr != NULL)) {
+  if (obqIsEmptyI(obqp) && (obqp->ptr != NULL) && !obqp->lent) {
     size_t size = (size_t)obqp->ptr - ((size_t)obqp->bwrptr + sizeof (size_t));
 
     if (size > 0U) {
@@ -872,7 +958,7 @@ void obqFlush(output_buffers_queue_t *obqp) {
   osalSysLock();
 
   /* If there is a buffer partially filled and not being written.*/
-  if (obqp->ptr != NULL) {
+  if ((obqp->ptr != NULL) && !obqp->lent) {
     size_t size = ((size_t)obqp->ptr - (size_t)obqp->bwrptr) - sizeof (size_t);
 
     if (size > 0U) {
@@ -882,4 +968,89 @@ void obqFlush(output_buffers_queue_t *obqp) {
 
   osalSysUnlock();
 }
+
+/**
+ * @brief   Lends the free space of the next empty buffer.
+ * @details The application fills the queue buffer directly, which avoids
+ *          the copy made by @p obqWriteTimeout(). The space must be
+ *          returned using @p obqReturn() before any other write operation
+ *          on the queue.
+ * @note    If the current buffer has been partially written then only the
+ *          remaining space is lent.
+ * @note    A lent buffer is not flushed by @p obqTryFlushI(), a partially
+ *          filled buffer can be flushed using @p obqFlush() after returning
+ *          it.
+ *
+ * @param[in] obqp      pointer to the @p output_buffers_queue_t object
+ * @param[out] bpp      pointer to a variable receiving the space pointer
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The size of the lent space.
+ * @retval 0            if a timeout occurred or the queue has been reset,
+ *                      nothing has to be returned in this case.
+ *
+ * @api
+ */
+size_t obqBorrowTimeout(output_buffers_queue_t *obqp, uint8_t **bpp,
+                        systime_t timeout) {
+  size_t size;
+
+  osalDbgCheck(bpp != NULL);
+
+  osalSysLock();
+
+  osalDbgAssert(!obqp->lent, "already lent");
+
+  /* This condition indicates that a new buffer must be acquired.*/
+  if (obqp->ptr == NULL) {
+    if (obqGetEmptyBufferTimeoutS(obqp, timeout) != MSG_OK) {
+      osalSysUnlock();
+      return 0U;
+    }
+  }
+
+  obqp->lent = true;
+  *bpp = obqp->ptr;
+  size = (size_t)obqp->top - (size_t)obqp->ptr;
+
+  osalSysUnlock();
+
+  return size;
+}
+
+/**
+ * @brief   Returns the space lent by @p obqBorrowTimeout().
+ * @details The first @p n bytes are committed, the buffer is posted in the
+ *          queue once it is full. The space not used is lent again by the
+ *          next @p obqBorrowTimeout() or filled by the other write
+ *          functions.
+ * @note    If the queue has been reset meanwhile then the function does
+ *          nothing.
+ *
+ * @param[in] obqp      pointer to the @p output_buffers_queue_t object
+ * @param[in] n         number of written bytes, it can be zero
+ *
+ * @api
+ */
+void obqReturn(output_buffers_queue_t *obqp, size_t n) {
+
+  osalSysLock();
+
+  if (obqp->lent) {
+    osalDbgCheck(n <= ((size_t)obqp->top - (size_t)obqp->ptr));
+
+    obqp->lent = false;
+    obqp->ptr += n;
+
+    /* Has the current data buffer been finished? if so then post it.*/
+    if (obqp->ptr >= obqp->top) {
+      obqPostFullBufferS(obqp, obqp->bsize - sizeof (size_t));
+    }
+  }
+
+  osalSysUnlock();
+}
 /** @} */
@@ -35,8 +35,213 @@
  * @{
  */
 
+#include <string.h>
+
 #include "hal.h"
 
+#if (HAL_QUEUES_USE_SPSC == TRUE) || defined(__DOXYGEN__)
+/* The data must be in place before the index publishing it, and read before
+   the index releasing its slot. Both sides run on the same core, see
+   HAL_QUEUES_USE_SPSC, so keeping the compiler from reordering the accesses
+   is enough.*/
+#define q_barrier() __asm__ volatile ("" : : : "memory")
+
+/**
+ * @brief   Waits on a queue.
+ * @details The sleeping threads are counted so that the ISR side can skip
+ *          the lock when nobody has to be woken up.
+ *
+ * @param[in] qp        pointer to an @p io_queue_t structure
+ * @param[in] timeout   the number of ticks before the operation timeouts
+ * @return              The wake up message.
+ *
+ * @sclass
+ */
+static msg_t q_enqueue_s(io_queue_t *qp, systime_t timeout) {
+  msg_t msg;
+
+  qp->q_sleepers++;
+  msg = osalThreadEnqueueTimeoutS(&qp->q_waiting, timeout);
+  qp->q_sleepers--;
+
+  return msg;
+}
+
+/**
+ * @brief   Wakes up the thread waiting on a queue, if any.
+ * @note    The lock is only taken when there is a thread to wake up, the
+ *          caller may already hold it.
+ *
+ * @param[in] qp        pointer to an @p io_queue_t structure
+ *
+ * @xclass
+ */
+static void q_wakeup(io_queue_t *qp) {
+
+  if (qp->q_sleepers > 0U) {
+    syssts_t sts = osalSysGetStatusAndLockX();
+    osalThreadDequeueNextI(&qp->q_waiting, MSG_OK);
+    osalSysRestoreStatusX(sts);
+  }
+}
+#else
+#define q_enqueue_s(qp, timeout) osalThreadEnqueueTimeoutS(&(qp)->q_waiting, timeout)
+#endif
+
+/**
+ * @brief   Waits until the queue space is not zero.
+ * @details The space is the data available on an input queue and the free
+ *          slots on an output queue.
+ *
+ * @param[in] qp        pointer to an @p io_queue_t structure
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @param[in] deadline  time deadline for the whole operation, not used
+ *                      with the special timeout values
+ * @return              The operation status.
+ * @retval MSG_OK       if there is space in the queue.
+ * @retval MSG_TIMEOUT  if the specified time expired.
+ * @retval MSG_RESET    if the queue has been reset.
+ *
+ * @sclass
+ */
+static msg_t q_wait_s(io_queue_t *qp, systime_t timeout, systime_t deadline) {
+
+  while (qSpaceI(qp) == 0U) {
+    msg_t msg;
+
+    /* TIME_INFINITE and TIME_IMMEDIATE are handled differently, no
+       deadline.*/
+    if ((timeout == TIME_INFINITE) || (timeout == TIME_IMMEDIATE)) {
+      msg = q_enqueue_s(qp, timeout);
+    }
+    else {
+      systime_t next_timeout = deadline - osalOsGetSystemTimeX();
+
+      /* Handling the case where the system time went past the deadline,
+         in this case next becomes a very high number because the system
+         time is an unsigned type.*/
+      if (next_timeout > timeout) {
+        return MSG_TIMEOUT;
+      }
+
+      msg = q_enqueue_s(qp, next_timeout);
+    }
+
+    /* Anything except MSG_OK causes the operation to stop.*/
+    if (msg != MSG_OK) {
+      return msg;
+    }
+  }
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Takes a contiguous chunk of data from a non empty input queue.
+ * @note    In SPSC mode this is called without the lock.
+ *
+ * @param[in] iqp       pointer to an @p input_queue_t structure
+ * @param[out] bp       pointer to the data buffer
+ * @param[in] n         the maximum amount of data to be transferred
+ * @return              The number of bytes transferred.
+ */
+static size_t iq_read(input_queue_t *iqp, uint8_t *bp, size_t n) {
+  size_t size;
+#if HAL_QUEUES_USE_SPSC == TRUE
+  size_t removed = iqp->q_removed;
+  size_t full = iqp->q_added - removed;
+  size_t offset = removed & (qSizeX(iqp) - 1U);
+
+  /* The chunk ends at the buffer top at most, there is no critical zone
+     to keep short.*/
+  size = qSizeX(iqp) - offset;
+  if (size > full) {
+    size = full;
+  }
+  if (size > n) {
+    size = n;
+  }
+  memcpy(bp, iqp->q_buffer + offset, size);
+  q_barrier();
+  iqp->q_removed = removed + size;
+#else
+  /* The chunk ends at the buffer top at most.*/
+  size = (size_t)(iqp->q_top - iqp->q_rdptr);
+  if (size > iqp->q_counter) {
+    size = iqp->q_counter;
+  }
+  if (size > n) {
+    size = n;
+  }
+  if (size > HAL_QUEUES_CHUNK_SIZE) {
+    size = HAL_QUEUES_CHUNK_SIZE;
+  }
+  memcpy(bp, iqp->q_rdptr, size);
+  iqp->q_counter -= size;
+  iqp->q_rdptr   += size;
+  if (iqp->q_rdptr >= iqp->q_top) {
+    iqp->q_rdptr = iqp->q_buffer;
+  }
+#endif
+
+  return size;
+}
+
+/**
+ * @brief   Puts a contiguous chunk of data into a non full output queue.
+ * @note    In SPSC mode this is called without the lock.
+ *
+ * @param[in] oqp       pointer to an @p output_queue_t structure
+ * @param[in] bp        pointer to the data buffer
+ * @param[in] n         the maximum amount of data to be transferred
+ * @return              The number of bytes transferred.
+ */
+static size_t oq_write(output_queue_t *oqp, const uint8_t *bp, size_t n) {
+  size_t size;
+#if HAL_QUEUES_USE_SPSC == TRUE
+  size_t removed = oqp->q_removed;
+  size_t empty = oqp->q_added - removed;
+  size_t offset = removed & (qSizeX(oqp) - 1U);
+
+  /* The chunk ends at the buffer top at most, there is no critical zone
+     to keep short.*/
+  size = qSizeX(oqp) - offset;
+  if (size > empty) {
+    size = empty;
+  }
+  if (size > n) {
+    size = n;
+  }
+  memcpy(oqp->q_buffer + offset, bp, size);
+  q_barrier();
+  oqp->q_removed = removed + size;
+#else
+  /* The chunk ends at the buffer top at most.*/
+  size = (size_t)(oqp->q_top - oqp->q_wrptr);
+  if (size > oqp->q_counter) {
+    size = oqp->q_counter;
+  }
+  if (size > n) {
+    size = n;
+  }
+  if (size > HAL_QUEUES_CHUNK_SIZE) {
+    size = HAL_QUEUES_CHUNK_SIZE;
+  }
+  memcpy(oqp->q_wrptr, bp, size);
+  oqp->q_counter -= size;
+  oqp->q_wrptr   += size;
+  if (oqp->q_wrptr >= oqp->q_top) {
+    oqp->q_wrptr = oqp->q_buffer;
+  }
+#endif
+
+  return size;
+}
+
 /**
  * @brief   Initializes an input queue.
  * @details A Semaphore is internally initialized and works as a counter of
@@ -45,7 +250,8 @@
  *
  * @param[out] iqp      pointer to an @p input_queue_t structure
  * @param[in] bp        pointer to a memory area allocated as queue buffer
- * @param[in] size      size of the queue buffer
+ * @param[in] size      size of the queue buffer, a power of two in SPSC
+ *                      mode
  * @param[in] infy      pointer to a callback function that is invoked when
  *                      data is read from the queue. The value can be @p NULL.
  * @param[in] link      application defined pointer
@@ -56,10 +262,18 @@ void iqObjectInit(input_queue_t *iqp, uint8_t *bp, size_t size,
                   qnotify_t infy, void *link) {
 
   osalThreadQueueObjectInit(&iqp->q_waiting);
+#if HAL_QUEUES_USE_SPSC == TRUE
+  osalDbgCheck((size & (size - 1U)) == 0U);
+
+  iqp->q_added    = 0;
+  iqp->q_removed  = 0;
+  iqp->q_sleepers = 0;
+#else
   iqp->q_counter = 0;
-  iqp->q_buffer  = bp;
   iqp->q_rdptr   = bp;
   iqp->q_wrptr   = bp;
+#endif
+  iqp->q_buffer  = bp;
   iqp->q_top     = bp + size;
   iqp->q_notify  = infy;
   iqp->q_link    = link;
@@ -71,6 +285,8 @@ void iqObjectInit(input_queue_t *iqp, uint8_t *bp, size_t size,
  *          thread is resumed with status @p MSG_RESET.
  * @note    A reset operation can be used by a low level driver in order to
  *          obtain immediate attention from the high level layers.
+ * @note    In SPSC mode the reset must not race with a thread reading the
+ *          queue, it is meant for a stopped driver.
  *
  * @param[in] iqp       pointer to an @p input_queue_t structure
  *
@@ -80,9 +296,13 @@ void iqResetI(input_queue_t *iqp) {
 
   osalDbgCheckClassI();
 
+#if HAL_QUEUES_USE_SPSC == TRUE
+  iqp->q_added = iqp->q_removed;
+#else
   iqp->q_rdptr = iqp->q_buffer;
   iqp->q_wrptr = iqp->q_buffer;
   iqp->q_counter = 0;
+#endif
   osalThreadDequeueAllI(&iqp->q_waiting, MSG_RESET);
 }
 
@@ -96,10 +316,25 @@ void iqResetI(input_queue_t *iqp) {
  * @retval MSG_OK       if the operation has been completed with success.
  * @retval MSG_TIMEOUT  if the queue is full and the operation cannot be
  *                      completed.
+ * @note    In SPSC mode this function can also be called from an ISR without
+ *          the lock, it is only taken if a thread has to be woken up.
  *
  * @iclass
  */
 msg_t iqPutI(input_queue_t *iqp, uint8_t b) {
+#if HAL_QUEUES_USE_SPSC == TRUE
+  size_t added = iqp->q_added;
+
+  if ((size_t)(added - iqp->q_removed) >= qSizeX(iqp)) {
+    return MSG_TIMEOUT;
+  }
+
+  iqp->q_buffer[added & (qSizeX(iqp) - 1U)] = b;
+  q_barrier();
+  iqp->q_added = added + 1U;
+
+  q_wakeup(iqp);
+#else
 
   osalDbgCheckClassI();
 
@@ -114,10 +349,92 @@ msg_t iqPutI(input_queue_t *iqp, uint8_t b) {
   }
 
   osalThreadDequeueNextI(&iqp->q_waiting, MSG_OK);
+#endif
 
   return MSG_OK;
 }
 
+/**
+ * @brief   Input queue bulk write.
+ * @details A block of data is written into the low end of an input queue,
+ *          the data that does not fit in the queue is discarded.
+ * @note    This is meant for drivers receiving data in blocks, for example
+ *          from a DMA buffer, the waiting threads are only woken up once.
+ * @note    In SPSC mode this function can also be called from an ISR without
+ *          the lock, it is only taken if a thread has to be woken up.
+ *
+ * @param[in] iqp       pointer to an @p input_queue_t structure
+ * @param[in] bp        pointer to the data buffer
+ * @param[in] n         the number of bytes to be written
+ * @return              The number of bytes effectively written.
+ *
+ * @iclass
+ */
+size_t iqWriteI(input_queue_t *iqp, const uint8_t *bp, size_t n) {
+  size_t done = 0;
+#if HAL_QUEUES_USE_SPSC == TRUE
+  size_t added = iqp->q_added;
+  size_t empty = qSizeX(iqp) - (size_t)(added - iqp->q_removed);
+
+  if (n > empty) {
+    n = empty;
+  }
+
+  /* At most two chunks, the second one starts at the buffer base.*/
+  while (done < n) {
+    size_t offset = (added + done) & (qSizeX(iqp) - 1U);
+    size_t size = qSizeX(iqp) - offset;
+
+    if (size > n - done) {
+      size = n - done;
+    }
+    memcpy(iqp->q_buffer + offset, bp + done, size);
+    done += size;
+  }
+
+  if (done > 0U) {
+    q_barrier();
+    iqp->q_added = added + done;
+
+    q_wakeup(iqp);
+  }
+#else
+  size_t empty;
+
+  osalDbgCheckClassI();
+
+  empty = qSizeX(iqp) - iqp->q_counter;
+  if (n > empty) {
+    n = empty;
+  }
+
+  /* At most two chunks, the second one starts at the buffer base.*/
+  while (done < n) {
+    size_t size = (size_t)(iqp->q_top - iqp->q_wrptr);
+
+    if (size > n - done) {
+      size = n - done;
+    }
+    memcpy(iqp->q_wrptr, bp + done, size);
+    iqp->q_wrptr += size;
+    if (iqp->q_wrptr >= iqp->q_top) {
+      iqp->q_wrptr = iqp->q_buffer;
+    }
+    done += size;
+  }
+
+  if (done > 0U) {
+    iqp->q_counter += done;
+
+    /* The readers check the queue again after waking up, so all of them
+       can be released at once.*/
+    osalThreadDequeueAllI(&iqp->q_waiting, MSG_OK);
+  }
+#endif
+
+  return done;
+}
+
 /**
  * @brief   Input queue read with timeout.
  * @details This function reads a byte value from an input queue. If the queue
@@ -141,11 +458,36 @@ msg_t iqPutI(input_queue_t *iqp, uint8_t b) {
 msg_t iqGetTimeout(input_queue_t *iqp, systime_t timeout) {
   uint8_t b;
 
+#if HAL_QUEUES_USE_SPSC == TRUE
+  /* Only waiting needs the lock, the producer never takes data back.*/
+  if (iqIsEmptyI(iqp)) {
+    osalSysLock();
+    while (iqIsEmptyI(iqp)) {
+      msg_t msg = q_enqueue_s(iqp, timeout);
+      if (msg < MSG_OK) {
+        osalSysUnlock();
+        return msg;
+      }
+    }
+    osalSysUnlock();
+  }
+
+  (void)iq_read(iqp, &b, 1U);
+
+  /* Inform the low side that the queue has at least one slot available.*/
+  if (iqp->q_notify != NULL) {
+    osalSysLock();
+    iqp->q_notify(iqp);
+    osalSysUnlock();
+  }
+
+  return (msg_t)b;
+#else
   osalSysLock();
 
   /* Waiting until there is a character available or a timeout occurs.*/
   while (iqIsEmptyI(iqp)) {
-    msg_t msg = osalThreadEnqueueTimeoutS(&iqp->q_waiting, timeout);
+    msg_t msg = q_enqueue_s(iqp, timeout);
     if (msg < MSG_OK) {
       osalSysUnlock();
       return msg;
@@ -167,6 +509,7 @@ msg_t iqGetTimeout(input_queue_t *iqp, systime_t timeout) {
   osalSysUnlock();
 
   return (msg_t)b;
+#endif
 }
 
 /**
@@ -177,8 +520,9 @@ msg_t iqGetTimeout(input_queue_t *iqp, systime_t timeout) {
  *          been reset.
  * @note    The function is not atomic, if you need atomicity it is suggested
  *          to use a semaphore or a mutex for mutual exclusion.
- * @note    The callback is invoked after removing each character from the
- *          queue.
+ * @note    The data is moved in contiguous chunks of at most
+ *          @p HAL_QUEUES_CHUNK_SIZE bytes, the callback is invoked after
+ *          removing each chunk from the queue.
  *
  * @param[in] iqp       pointer to an @p input_queue_t structure
  * @param[out] bp       pointer to the data buffer
@@ -197,55 +541,50 @@ size_t iqReadTimeout(input_queue_t *iqp, uint8_t *bp,
                      size_t n, systime_t timeout) {
   systime_t deadline;
   qnotify_t nfy = iqp->q_notify;
-  size_t r = 0;
+  size_t r = 0, size;
+  msg_t msg;
 
   osalDbgCheck(n > 0U);
 
-  osalSysLock();
-
   /* Time deadline for the whole operation, note the result is invalid
      when timeout is TIME_INFINITE or TIME_IMMEDIATE but in that case
      the deadline is not used.*/
   deadline = osalOsGetSystemTimeX() + timeout;
 
   while (true) {
-    /* Waiting until there is a character available or a timeout occurs.*/
-    while (iqIsEmptyI(iqp)) {
-      msg_t msg;
-
-      /* TIME_INFINITE and TIME_IMMEDIATE are handled differently, no
-         deadline.*/
-      if ((timeout == TIME_INFINITE) || (timeout == TIME_IMMEDIATE)) {
-        msg = osalThreadEnqueueTimeoutS(&iqp->q_waiting, timeout);
-      }
-      else {
-        systime_t next_timeout = deadline - osalOsGetSystemTimeX();
-
-        /* Handling the case where the system time went past the deadline,
-           in this case next becomes a very high number because the system
-           time is an unsigned type.*/
-        if (next_timeout > timeout) {
-          osalSysUnlock();
-          return r;
-        }
-
-        msg = osalThreadEnqueueTimeoutS(&iqp->q_waiting, next_timeout);
-      }
-
-      /* Anything except MSG_OK causes the operation to stop.*/
+#if HAL_QUEUES_USE_SPSC == TRUE
+    /* Only waiting needs the lock, the producer never takes data back.*/
+    if (iqIsEmptyI(iqp)) {
+      osalSysLock();
+      msg = q_wait_s(iqp, timeout, deadline);
+      osalSysUnlock();
       if (msg != MSG_OK) {
-        osalSysUnlock();
         return r;
       }
     }
 
-    /* Getting the character from the queue.*/
-    iqp->q_counter--;
-    *bp++ = *iqp->q_rdptr++;
-    if (iqp->q_rdptr >= iqp->q_top) {
-      iqp->q_rdptr = iqp->q_buffer;
+    /* Getting a contiguous chunk from the queue.*/
+    size = iq_read(iqp, bp, n);
+
+    /* Inform the low side that the queue has at least one slot available.*/
+    if (nfy != NULL) {
+      osalSysLock();
+      nfy(iqp);
+      osalSysUnlock();
+    }
+#else
+    osalSysLock();
+
+    /* Waiting until there is a character available or a timeout occurs.*/
+    msg = q_wait_s(iqp, timeout, deadline);
+    if (msg != MSG_OK) {
+      osalSysUnlock();
+      return r;
     }
 
+    /* Getting a contiguous chunk from the queue.*/
+    size = iq_read(iqp, bp, n);
+
     /* Inform the low side that the queue has at least one slot available.*/
     if (nfy != NULL) {
       nfy(iqp);
@@ -253,13 +592,14 @@ size_t iqReadTimeout(input_queue_t *iqp, uint8_t *bp,
 
     /* Giving a preemption chance in a controlled point.*/
     osalSysUnlock();
+#endif
 
-    r++;
-    if (--n == 0U) {
+    bp += size;
+    r  += size;
+    n  -= size;
+    if (n == 0U) {
       return r;
     }
-
-    osalSysLock();
   }
 }
 
@@ -271,7 +611,8 @@ size_t iqReadTimeout(input_queue_t *iqp, uint8_t *bp,
  *
  * @param[out] oqp      pointer to an @p output_queue_t structure
  * @param[in] bp        pointer to a memory area allocated as queue buffer
- * @param[in] size      size of the queue buffer
+ * @param[in] size      size of the queue buffer, a power of two in SPSC
+ *                      mode
  * @param[in] onfy      pointer to a callback function that is invoked when
  *                      data is written to the queue. The value can be @p NULL.
  * @param[in] link      application defined pointer
@@ -282,10 +623,18 @@ void oqObjectInit(output_queue_t *oqp, uint8_t *bp, size_t size,
                   qnotify_t onfy, void *link) {
 
   osalThreadQueueObjectInit(&oqp->q_waiting);
+#if HAL_QUEUES_USE_SPSC == TRUE
+  osalDbgCheck((size & (size - 1U)) == 0U);
+
+  oqp->q_added    = size;
+  oqp->q_removed  = 0;
+  oqp->q_sleepers = 0;
+#else
   oqp->q_counter = size;
-  oqp->q_buffer  = bp;
   oqp->q_rdptr   = bp;
   oqp->q_wrptr   = bp;
+#endif
+  oqp->q_buffer  = bp;
   oqp->q_top     = bp + size;
   oqp->q_notify  = onfy;
   oqp->q_link    = link;
@@ -297,6 +646,8 @@ void oqObjectInit(output_queue_t *oqp, uint8_t *bp, size_t size,
  *          thread is resumed with status @p MSG_RESET.
  * @note    A reset operation can be used by a low level driver in order to
  *          obtain immediate attention from the high level layers.
+ * @note    In SPSC mode the reset must not race with a thread writing the
+ *          queue, it is meant for a stopped driver.
  *
  * @param[in] oqp       pointer to an @p output_queue_t structure
  *
@@ -306,9 +657,13 @@ void oqResetI(output_queue_t *oqp) {
 
   osalDbgCheckClassI();
 
+#if HAL_QUEUES_USE_SPSC == TRUE
+  oqp->q_added = oqp->q_removed + qSizeX(oqp);
+#else
   oqp->q_rdptr = oqp->q_buffer;
   oqp->q_wrptr = oqp->q_buffer;
   oqp->q_counter = qSizeX(oqp);
+#endif
   osalThreadDequeueAllI(&oqp->q_waiting, MSG_RESET);
 }
 
@@ -336,11 +691,36 @@ void oqResetI(output_queue_t *oqp) {
  */
 msg_t oqPutTimeout(output_queue_t *oqp, uint8_t b, systime_t timeout) {
 
+#if HAL_QUEUES_USE_SPSC == TRUE
+  /* Only waiting needs the lock, the consumer never takes slots back.*/
+  if (oqIsFullI(oqp)) {
+    osalSysLock();
+    while (oqIsFullI(oqp)) {
+      msg_t msg = q_enqueue_s(oqp, timeout);
+      if (msg < MSG_OK) {
+        osalSysUnlock();
+        return msg;
+      }
+    }
+    osalSysUnlock();
+  }
+
+  (void)oq_write(oqp, &b, 1U);
+
+  /* Inform the low side that the queue has at least one character available.*/
+  if (oqp->q_notify != NULL) {
+    osalSysLock();
+    oqp->q_notify(oqp);
+    osalSysUnlock();
+  }
+
+  return MSG_OK;
+#else
   osalSysLock();
 
   /* Waiting until there is a slot available or a timeout occurs.*/
   while (oqIsFullI(oqp)) {
-    msg_t msg = osalThreadEnqueueTimeoutS(&oqp->q_waiting, timeout);
+    msg_t msg = q_enqueue_s(oqp, timeout);
     if (msg < MSG_OK) {
       osalSysUnlock();
       return msg;
@@ -362,6 +742,7 @@ msg_t oqPutTimeout(output_queue_t *oqp, uint8_t b, systime_t timeout) {
   osalSysUnlock();
 
   return MSG_OK;
+#endif
 }
 
 /**
@@ -371,11 +752,26 @@ msg_t oqPutTimeout(output_queue_t *oqp, uint8_t b, systime_t timeout) {
  * @param[in] oqp       pointer to an @p output_queue_t structure
  * @return              The byte value from the queue.
  * @retval MSG_TIMEOUT  if the queue is empty.
+ * @note    In SPSC mode this function can also be called from an ISR without
+ *          the lock, it is only taken if a thread has to be woken up.
  *
  * @iclass
  */
 msg_t oqGetI(output_queue_t *oqp) {
   uint8_t b;
+#if HAL_QUEUES_USE_SPSC == TRUE
+  size_t added = oqp->q_added;
+
+  if ((size_t)(added - oqp->q_removed) >= qSizeX(oqp)) {
+    return MSG_TIMEOUT;
+  }
+
+  b = oqp->q_buffer[added & (qSizeX(oqp) - 1U)];
+  q_barrier();
+  oqp->q_added = added + 1U;
+
+  q_wakeup(oqp);
+#else
 
   osalDbgCheckClassI();
 
@@ -390,10 +786,97 @@ msg_t oqGetI(output_queue_t *oqp) {
   }
 
   osalThreadDequeueNextI(&oqp->q_waiting, MSG_OK);
+#endif
 
   return (msg_t)b;
 }
 
+/**
+ * @brief   Output queue contiguous data.
+ * @details Returns the longest run of contiguous data at the low end of an
+ *          output queue, the data is not removed from the queue. This is
+ *          meant for drivers transmitting directly from the queue buffer,
+ *          for example using a DMA.
+ * @note    The data must be removed using @p oqReleaseRunI() once it has
+ *          been transmitted, the queue must not be reset meanwhile.
+ * @note    In SPSC mode this function can also be called from an ISR without
+ *          the lock.
+ *
+ * @param[in] oqp       pointer to an @p output_queue_t structure
+ * @param[out] np       pointer to a variable receiving the run size
+ * @return              Pointer to the first byte of the run.
+ * @retval NULL         if the queue is empty.
+ *
+ * @iclass
+ */
+uint8_t *oqGetRunI(output_queue_t *oqp, size_t *np) {
+  size_t full, size;
+  uint8_t *bp;
+#if HAL_QUEUES_USE_SPSC == TRUE
+  size_t added = oqp->q_added;
+  size_t offset = added & (qSizeX(oqp) - 1U);
+
+  full = qSizeX(oqp) - (size_t)(added - oqp->q_removed);
+  size = qSizeX(oqp) - offset;
+  bp = oqp->q_buffer + offset;
+#else
+
+  osalDbgCheckClassI();
+
+  full = qSizeX(oqp) - oqp->q_counter;
+  size = (size_t)(oqp->q_top - oqp->q_rdptr);
+  bp = oqp->q_rdptr;
+#endif
+
+  /* The run ends at the buffer top at most.*/
+  if (size > full) {
+    size = full;
+  }
+  *np = size;
+
+  return size > 0U ? bp : NULL;
+}
+
+/**
+ * @brief   Removes transmitted data from an output queue.
+ * @details Frees the first @p n bytes of the run returned by
+ *          @p oqGetRunI(), the threads waiting for space are woken up.
+ * @note    In SPSC mode this function can also be called from an ISR without
+ *          the lock, it is only taken if a thread has to be woken up.
+ *
+ * @param[in] oqp       pointer to an @p output_queue_t structure
+ * @param[in] n         number of bytes to be removed
+ *
+ * @iclass
+ */
+void oqReleaseRunI(output_queue_t *oqp, size_t n) {
+
+  if (n == 0U) {
+    return;
+  }
+
+#if HAL_QUEUES_USE_SPSC == TRUE
+  q_barrier();
+  oqp->q_added += n;
+
+  q_wakeup(oqp);
+#else
+
+  osalDbgCheckClassI();
+  osalDbgAssert(n <= qSizeX(oqp) - oqp->q_counter, "queue underflow");
+
+  oqp->q_counter += n;
+  oqp->q_rdptr   += n;
+  if (oqp->q_rdptr >= oqp->q_top) {
+    oqp->q_rdptr = oqp->q_buffer;
+  }
+
+  /* The writers check the queue again after waking up, so all of them
+     can be released at once.*/
+  osalThreadDequeueAllI(&oqp->q_waiting, MSG_OK);
+#endif
+}
+
 /**
  * @brief   Output queue write with timeout.
  * @details The function writes data from a buffer to an output queue. The
@@ -402,8 +885,9 @@ msg_t oqGetI(output_queue_t *oqp) {
  *          been reset.
  * @note    The function is not atomic, if you need atomicity it is suggested
  *          to use a semaphore or a mutex for mutual exclusion.
- * @note    The callback is invoked after putting each character into the
- *          queue.
+ * @note    The data is moved in contiguous chunks of at most
+ *          @p HAL_QUEUES_CHUNK_SIZE bytes, the callback is invoked after
+ *          putting each chunk into the queue.
  *
  * @param[in] oqp       pointer to an @p output_queue_t structure
  * @param[in] bp        pointer to the data buffer
@@ -422,54 +906,50 @@ size_t oqWriteTimeout(output_queue_t *oqp, const uint8_t *bp,
                       size_t n, systime_t timeout) {
   systime_t deadline;
   qnotify_t nfy = oqp->q_notify;
-  size_t w = 0;
+  size_t w = 0, size;
+  msg_t msg;
 
   osalDbgCheck(n > 0U);
 
-  osalSysLock();
-
   /* Time deadline for the whole operation, note the result is invalid
      when timeout is TIME_INFINITE or TIME_IMMEDIATE but in that case
      the deadline is not used.*/
   deadline = osalOsGetSystemTimeX() + timeout;
 
   while (true) {
-    msg_t msg;
-
-    while (oqIsFullI(oqp)) {
-      /* TIME_INFINITE and TIME_IMMEDIATE are handled differently, no
-         deadline.*/
-      if ((timeout == TIME_INFINITE) || (timeout == TIME_IMMEDIATE)) {
-        msg = osalThreadEnqueueTimeoutS(&oqp->q_waiting, timeout);
-      }
-      else {
-        systime_t next_timeout = deadline - osalOsGetSystemTimeX();
-
-        /* Handling the case where the system time went past the deadline,
-           in this case next becomes a very high number because the system
-           time is an unsigned type.*/
-        if (next_timeout > timeout) {
-          osalSysUnlock();
-          return w;
-        }
-
-        msg = osalThreadEnqueueTimeoutS(&oqp->q_waiting, next_timeout);
-      }
-
-      /* Anything except MSG_OK causes the operation to stop.*/
+#if HAL_QUEUES_USE_SPSC == TRUE
+    /* Only waiting needs the lock, the consumer never takes slots back.*/
+    if (oqIsFullI(oqp)) {
+      osalSysLock();
+      msg = q_wait_s(oqp, timeout, deadline);
+      osalSysUnlock();
       if (msg != MSG_OK) {
-        osalSysUnlock();
         return w;
       }
     }
 
-    /* Putting the character into the queue.*/
-    oqp->q_counter--;
-    *oqp->q_wrptr++ = *bp++;
-    if (oqp->q_wrptr >= oqp->q_top) {
-      oqp->q_wrptr = oqp->q_buffer;
+    /* Putting a contiguous chunk into the queue.*/
+    size = oq_write(oqp, bp, n);
+
+    /* Inform the low side that the queue has at least one character available.*/
+    if (nfy != NULL) {
+      osalSysLock();
+      nfy(oqp);
+      osalSysUnlock();
+    }
+#else
+    osalSysLock();
+
+    /* Waiting until there is a slot available or a timeout occurs.*/
+    msg = q_wait_s(oqp, timeout, deadline);
+    if (msg != MSG_OK) {
+      osalSysUnlock();
+      return w;
     }
 
+    /* Putting a contiguous chunk into the queue.*/
+    size = oq_write(oqp, bp, n);
+
     /* Inform the low side that the queue has at least one character available.*/
     if (nfy != NULL) {
       nfy(oqp);
@@ -477,13 +957,14 @@ size_t oqWriteTimeout(output_queue_t *oqp, const uint8_t *bp,
 
     /* Giving a preemption chance in a controlled point.*/
     osalSysUnlock();
+#endif
 
-    w++;
-    if (--n == 0U) {
+    bp += size;
+    w  += size;
+    n  -= size;
+    if (n == 0U) {
       return w;
     }
-
-    osalSysLock();
   }
 }
 
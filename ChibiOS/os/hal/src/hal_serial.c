@@ -204,6 +204,8 @@ void sdStop(SerialDriver *sdp) {
  * @note    In order to gain some performance it is suggested to not use
  *          this function directly but copy this code directly into the
  *          interrupt service routine.
+ * @note    With @p HAL_QUEUES_USE_SPSC the function can be called without
+ *          the lock, it is only taken when events have to be generated.
  *
  * @param[in] sdp       pointer to a @p SerialDriver structure
  * @param[in] b         the byte to be written in the driver's Input Queue
@@ -211,6 +213,23 @@ void sdStop(SerialDriver *sdp) {
  * @iclass
  */
 void sdIncomingDataI(SerialDriver *sdp, uint8_t b) {
+#if HAL_QUEUES_USE_SPSC == TRUE
+  eventflags_t flags = 0;
+
+  osalDbgCheck(sdp != NULL);
+
+  /* The byte is published first, checking for an empty queue before would
+     miss the event if the reader drained the queue in between.*/
+  if (iqPutI(&sdp->iqueue, b) < MSG_OK)
+    flags |= SD_QUEUE_FULL_ERROR;
+  else if (iqGetFullI(&sdp->iqueue) <= 1U)
+    flags |= CHN_INPUT_AVAILABLE;
+  if (flags != 0U) {
+    syssts_t sts = osalSysGetStatusAndLockX();
+    chnAddFlagsI(sdp, flags);
+    osalSysRestoreStatusX(sts);
+  }
+#else
 
   osalDbgCheckClassI();
   osalDbgCheck(sdp != NULL);
@@ -219,6 +238,61 @@ void sdIncomingDataI(SerialDriver *sdp, uint8_t b) {
     chnAddFlagsI(sdp, CHN_INPUT_AVAILABLE);
   if (iqPutI(&sdp->iqueue, b) < MSG_OK)
     chnAddFlagsI(sdp, SD_QUEUE_FULL_ERROR);
+#endif
+}
+
+/**
+ * @brief   Handles a block of incoming data.
+ * @details This function can be called from the input interrupt service
+ *          routine of drivers receiving data in blocks, the events are
+ *          generated once for the whole block.
+ * @note    The incoming data event is only generated when the input queue
+ *          becomes non-empty.
+ * @note    With @p HAL_QUEUES_USE_SPSC the function can be called without
+ *          the lock, it is only taken when events have to be generated.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver structure
+ * @param[in] bp        pointer to the received data
+ * @param[in] n         number of received bytes
+ *
+ * @iclass
+ */
+void sdIncomingBufferI(SerialDriver *sdp, const uint8_t *bp, size_t n) {
+  eventflags_t flags = 0;
+
+#if HAL_QUEUES_USE_SPSC == FALSE
+  osalDbgCheckClassI();
+#endif
+  osalDbgCheck((sdp != NULL) && (bp != NULL));
+
+  if (n == 0U)
+    return;
+
+#if HAL_QUEUES_USE_SPSC == TRUE
+  {
+    size_t done = iqWriteI(&sdp->iqueue, bp, n);
+
+    /* Checked after publishing the data, see sdIncomingDataI().*/
+    if ((done > 0U) && (iqGetFullI(&sdp->iqueue) <= done))
+      flags |= CHN_INPUT_AVAILABLE;
+    if (done < n)
+      flags |= SD_QUEUE_FULL_ERROR;
+  }
+#else
+  if (iqIsEmptyI(&sdp->iqueue))
+    flags |= CHN_INPUT_AVAILABLE;
+  if (iqWriteI(&sdp->iqueue, bp, n) < n)
+    flags |= SD_QUEUE_FULL_ERROR;
+#endif
+  if (flags != 0U) {
+#if HAL_QUEUES_USE_SPSC == TRUE
+    syssts_t sts = osalSysGetStatusAndLockX();
+    chnAddFlagsI(sdp, flags);
+    osalSysRestoreStatusX(sts);
+#else
+    chnAddFlagsI(sdp, flags);
+#endif
+  }
 }
 
 /**
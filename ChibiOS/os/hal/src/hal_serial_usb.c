@@ -73,19 +73,75 @@ static bool sdu_start_receive(SerialUSBDriver *sdup) {
 
   /* Buffer found, starting a new transaction.*/
   usbStartReceiveI(sdup->config->usbp, sdup->config->bulk_out,
-                   buf, SERIAL_USB_BUFFERS_SIZE);
+                   buf, bqBufferSizeX(&sdup->ibqueue));
 
   return false;
 }
 
+/**
+ * @brief   Transmits the partially filled output buffer, if any.
+ * @details Nothing is done if the IN endpoint is busy, the data is flushed
+ *          later.
+ *
+ * @param[in] sdup      pointer to a @p SerialUSBDriver object
+ *
+ * @iclass
+ */
+static void sdu_flush_pending(SerialUSBDriver *sdup) {
+
+  /* If the USB driver is not in the appropriate state then transactions
+     must not be started.*/
+  if ((sdup->state != SDU_READY) ||
+      (usbGetDriverStateI(sdup->config->usbp) != USB_ACTIVE)) {
+    return;
+  }
+
+  /* If there is already a transaction ongoing then another one cannot be
+     started.*/
+  if (usbGetTransmitStatusI(sdup->config->usbp, sdup->config->bulk_in)) {
+    return;
+  }
+
+  /* Checking if there only a buffer partially filled, if so then it is
+     enforced in the queue and transmitted.*/
+  if (obqTryFlushI(&sdup->obqueue)) {
+    size_t n;
+    uint8_t *buf = obqGetFullBufferI(&sdup->obqueue, &n);
+
+    osalDbgAssert(buf != NULL, "queue is empty");
+
+    sdup->sofs = 0;
+    usbStartTransmitI(sdup->config->usbp, sdup->config->bulk_in, buf, n);
+  }
+}
+
+/**
+ * @brief   Completes a write operation.
+ * @details In low latency mode the written data is transmitted immediately
+ *          if the IN endpoint is idle.
+ *
+ * @param[in] sdup      pointer to a @p SerialUSBDriver object
+ */
+static void sdu_write_done(SerialUSBDriver *sdup) {
+
+  osalSysLock();
+  if ((sdup->state == SDU_READY) && sdup->config->low_latency) {
+    sdu_flush_pending(sdup);
+  }
+  osalSysUnlock();
+}
+
 /*
  * Interface implementation.
  */
 
 static size_t _write(void *ip, const uint8_t *bp, size_t n) {
 
-  return obqWriteTimeout(&((SerialUSBDriver *)ip)->obqueue, bp,
-                         n, TIME_INFINITE);
+  n = obqWriteTimeout(&((SerialUSBDriver *)ip)->obqueue, bp,
+                      n, TIME_INFINITE);
+  sdu_write_done((SerialUSBDriver *)ip);
+
+  return n;
 }
 
 static size_t _read(void *ip, uint8_t *bp, size_t n) {
@@ -95,8 +151,12 @@ static size_t _read(void *ip, uint8_t *bp, size_t n) {
 }
 
 static msg_t _put(void *ip, uint8_t b) {
+  msg_t msg;
 
-  return obqPutTimeout(&((SerialUSBDriver *)ip)->obqueue, b, TIME_INFINITE);
+  msg = obqPutTimeout(&((SerialUSBDriver *)ip)->obqueue, b, TIME_INFINITE);
+  sdu_write_done((SerialUSBDriver *)ip);
+
+  return msg;
 }
 
 static msg_t _get(void *ip) {
@@ -105,8 +165,12 @@ static msg_t _get(void *ip) {
 }
 
 static msg_t _putt(void *ip, uint8_t b, systime_t timeout) {
+  msg_t msg;
+
+  msg = obqPutTimeout(&((SerialUSBDriver *)ip)->obqueue, b, timeout);
+  sdu_write_done((SerialUSBDriver *)ip);
 
-  return obqPutTimeout(&((SerialUSBDriver *)ip)->obqueue, b, timeout);
+  return msg;
 }
 
 static msg_t _gett(void *ip, systime_t timeout) {
@@ -116,7 +180,10 @@ static msg_t _gett(void *ip, systime_t timeout) {
 
 static size_t _writet(void *ip, const uint8_t *bp, size_t n, systime_t timeout) {
 
-  return obqWriteTimeout(&((SerialUSBDriver *)ip)->obqueue, bp, n, timeout);
+  n = obqWriteTimeout(&((SerialUSBDriver *)ip)->obqueue, bp, n, timeout);
+  sdu_write_done((SerialUSBDriver *)ip);
+
+  return n;
 }
 
 static size_t _readt(void *ip, uint8_t *bp, size_t n, systime_t timeout) {
@@ -180,10 +247,13 @@ static void obnotify(io_buffers_queue_t *bqp) {
 void sduInit(void) {
 }
 
+#if (SERIAL_USB_BUFFERS_NUMBER > 0) || defined(__DOXYGEN__)
 /**
  * @brief   Initializes a generic full duplex driver object.
  * @details The HW dependent part of the initialization has to be performed
  *          outside, usually in the hardware initialization code.
+ * @note    The embedded buffers are used, their number and size are set by
+ *          @p SERIAL_USB_BUFFERS_NUMBER and @p SERIAL_USB_BUFFERS_SIZE.
  *
  * @param[out] sdup     pointer to a @p SerialUSBDriver structure
  *
@@ -191,15 +261,37 @@ void sduInit(void) {
  */
 void sduObjectInit(SerialUSBDriver *sdup) {
 
+  sduObjectInitBuffers(sdup, sdup->ib, sdup->ob,
+                       SERIAL_USB_BUFFERS_SIZE, SERIAL_USB_BUFFERS_NUMBER);
+}
+#endif
+
+/**
+ * @brief   Initializes a generic full duplex driver object with its own
+ *          buffers.
+ * @details The HW dependent part of the initialization has to be performed
+ *          outside, usually in the hardware initialization code.
+ *
+ * @param[out] sdup     pointer to a @p SerialUSBDriver structure
+ * @param[in] ib        input buffers area, it must be
+ *                      <tt>BQ_BUFFER_SIZE(n, size)</tt> bytes large
+ * @param[in] ob        output buffers area, it must be
+ *                      <tt>BQ_BUFFER_SIZE(n, size)</tt> bytes large
+ * @param[in] size      size of each buffer, it must be a multiple of the
+ *                      USB data endpoints maximum packet size
+ * @param[in] n         number of input and output buffers
+ *
+ * @init
+ */
+void sduObjectInitBuffers(SerialUSBDriver *sdup, uint8_t *ib, uint8_t *ob,
+                          size_t size, size_t n) {
+
   sdup->vmt = &vmt;
   osalEventObjectInit(&sdup->event);
   sdup->state = SDU_STOP;
-  ibqObjectInit(&sdup->ibqueue, true, sdup->ib,
-                SERIAL_USB_BUFFERS_SIZE, SERIAL_USB_BUFFERS_NUMBER,
-                ibnotify, sdup);
-  obqObjectInit(&sdup->obqueue, true, sdup->ob,
-                SERIAL_USB_BUFFERS_SIZE, SERIAL_USB_BUFFERS_NUMBER,
-                obnotify, sdup);
+  sdup->sofs = 0;
+  ibqObjectInit(&sdup->ibqueue, true, ib, size, n, ibnotify, sdup);
+  obqObjectInit(&sdup->obqueue, true, ob, size, n, obnotify, sdup);
 }
 
 /**
@@ -224,6 +316,7 @@ void sduStart(SerialUSBDriver *sdup, const SerialUSBConfig *config) {
     usbp->in_params[config->int_in - 1U]  = sdup;
   }
   sdup->config = config;
+  sdup->sofs = 0;
   sdup->state = SDU_READY;
   osalSysUnlock();
 }
@@ -265,6 +358,22 @@ void sduStop(SerialUSBDriver *sdup) {
   osalSysUnlock();
 }
 
+/**
+ * @brief   Flushes the output data.
+ * @details The partially filled output buffer, if any, is posted for
+ *          transmission without waiting for the flush policy.
+ *
+ * @param[in] sdup      pointer to a @p SerialUSBDriver object
+ *
+ * @api
+ */
+void sduFlush(SerialUSBDriver *sdup) {
+
+  osalDbgCheck(sdup != NULL);
+
+  obqFlush(&sdup->obqueue);
+}
+
 /**
  * @brief   USB device suspend handler.
  * @details Generates a @p CHN_DISCONNECT event and puts queues in
@@ -359,37 +468,36 @@ bool sduRequestsHook(USBDriver *usbp) {
 /**
  * @brief   SOF handler.
  * @details The SOF interrupt is used for automatic flushing of incomplete
- *          buffers pending in the output queue.
+ *          buffers pending in the output queue, according to the
+ *          @p flush_size and @p flush_sofs configuration fields.
  *
  * @param[in] sdup      pointer to a @p SerialUSBDriver object
  *
  * @iclass
  */
 void sduSOFHookI(SerialUSBDriver *sdup) {
+  size_t pending;
 
-  /* If the USB driver is not in the appropriate state then transactions
-     must not be started.*/
-  if ((usbGetDriverStateI(sdup->config->usbp) != USB_ACTIVE) ||
-      (sdup->state != SDU_READY)) {
+  if (sdup->state != SDU_READY) {
     return;
   }
 
-  /* If there is already a transaction ongoing then another one cannot be
-     started.*/
-  if (usbGetTransmitStatusI(sdup->config->usbp, sdup->config->bulk_in)) {
+  /* Small amounts of data are coalesced with the following writes, up to
+     a time limit.*/
+  pending = obqGetPendingI(&sdup->obqueue);
+  if (pending == 0U) {
+    sdup->sofs = 0;
     return;
   }
-
-  /* Checking if there only a buffer partially filled, if so then it is
-     enforced in the queue and transmitted.*/
-  if (obqTryFlushI(&sdup->obqueue)) {
-    size_t n;
-    uint8_t *buf = obqGetFullBufferI(&sdup->obqueue, &n);
-
-    osalDbgAssert(buf != NULL, "queue is empty");
-
-    usbStartTransmitI(sdup->config->usbp, sdup->config->bulk_in, buf, n);
+  if (pending < sdup->config->flush_size) {
+    sdup->sofs++;
+    if ((sdup->config->flush_sofs == 0U) ||
+        (sdup->sofs < sdup->config->flush_sofs)) {
+      return;
+    }
   }
+
+  sdu_flush_pending(sdup);
 }
 
 /**
@@ -0,0 +1,197 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    binlog.c
+ * @brief   Deferred binary logging code.
+ * @details Log calls store a format string identifier and the raw argument
+ *          words in a RAM ring, no formatting is done on target. The ring
+ *          is drained to a stream and decoded on the host.
+ *          Each record is a sequence of little endian 32 bits words:
+ *          - header: bits 31..8 format string offset in the
+ *            @p binlog_fmt section, bits 7..4 record type, bits 3..0
+ *            arguments number.
+ *          - system time, if @p BINLOG_USE_TIMESTAMP is enabled.
+ *          - the arguments.
+ *          .
+ *
+ * @addtogroup BINLOG
+ * @{
+ */
+
+#include "hal.h"
+#include "binlog.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+#define BINLOG_MASK                 ((uint32_t)BINLOG_BUFFER_SIZE - 1U)
+
+#if BINLOG_USE_TIMESTAMP == TRUE
+#define BINLOG_HEADER_SIZE          2U
+#else
+#define BINLOG_HEADER_SIZE          1U
+#endif
+
+#define BINLOG_HEADER(id, type, n)                                          \
+  (((uint32_t)(id) << 8) | ((uint32_t)(type) << 4) | (uint32_t)(n))
+
+/**
+ * @brief   Start of the format strings section.
+ * @note    Defined by the linker.
+ */
+extern const char __start_binlog_fmt[];
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Log ring.
+ */
+binlog_t binlog;
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Log ring initialization.
+ * @note    The ring is statically zeroed, calling this function is only
+ *          required to discard the logged records.
+ *
+ * @api
+ */
+void blogInit(void) {
+  syssts_t sts;
+
+  sts = osalSysGetStatusAndLockX();
+  binlog.head = 0U;
+  binlog.tail = 0U;
+  binlog.lost = 0U;
+  osalSysRestoreStatusX(sts);
+}
+
+/**
+ * @brief   Writes a record in the log ring.
+ * @details The record is copied in the ring within a critical zone of a
+ *          few instructions, the function can be called from any context.
+ * @note    This function is meant to be invoked through @p BLOG().
+ *
+ * @param[in] fmt       pointer to the format string
+ * @param[in] args      pointer to the arguments
+ * @param[in] n         number of arguments
+ *
+ * @special
+ */
+void blogWriteX(const char *fmt, const uint32_t *args, size_t n) {
+  uint32_t hdr, head, size;
+  syssts_t sts;
+#if BINLOG_USE_TIMESTAMP == TRUE
+  uint32_t time = (uint32_t)osalOsGetSystemTimeX();
+#endif
+
+  osalDbgCheck(n <= BINLOG_MAX_ARGS);
+
+  hdr  = BINLOG_HEADER(fmt - __start_binlog_fmt, BINLOG_TYPE_MESSAGE, n);
+  size = BINLOG_HEADER_SIZE + (uint32_t)n;
+
+  sts = osalSysGetStatusAndLockX();
+  head = binlog.head;
+  if ((uint32_t)BINLOG_BUFFER_SIZE - (head - binlog.tail) < size) {
+    binlog.lost++;
+    osalSysRestoreStatusX(sts);
+    return;
+  }
+  binlog.buffer[head++ & BINLOG_MASK] = hdr;
+#if BINLOG_USE_TIMESTAMP == TRUE
+  binlog.buffer[head++ & BINLOG_MASK] = time;
+#endif
+  while (n-- > 0U) {
+    binlog.buffer[head++ & BINLOG_MASK] = *args++;
+  }
+  binlog.head = head;
+  osalSysRestoreStatusX(sts);
+}
+
+/**
+ * @brief   Drains the log ring.
+ * @details The logged records are written to the stream as raw words, in
+ *          at most two operations. If records have been dropped since the
+ *          previous call then a @p BINLOG_TYPE_LOST record carrying their
+ *          number is written after them.
+ * @note    Only one thread can drain the ring.
+ *
+ * @param[in] chp       pointer to a @p BaseSequentialStream object
+ * @return              The number of bytes written.
+ *
+ * @api
+ */
+size_t blogDrain(BaseSequentialStream *chp) {
+  uint32_t head, tail, lost;
+  size_t n, total = 0U;
+  syssts_t sts;
+
+  osalDbgCheck(chp != NULL);
+
+  sts = osalSysGetStatusAndLockX();
+  head = binlog.head;
+  lost = binlog.lost;
+  binlog.lost = 0U;
+  osalSysRestoreStatusX(sts);
+
+  tail = binlog.tail;
+  while (tail != head) {
+    /* Contiguous part of the ring.*/
+    n = (size_t)(head - tail);
+    if (n > (size_t)BINLOG_BUFFER_SIZE - (size_t)(tail & BINLOG_MASK)) {
+      n = (size_t)BINLOG_BUFFER_SIZE - (size_t)(tail & BINLOG_MASK);
+    }
+    total += streamWrite(chp,
+                         (const uint8_t *)&binlog.buffer[tail & BINLOG_MASK],
+                         n * sizeof (uint32_t));
+    tail += (uint32_t)n;
+    binlog.tail = tail;
+  }
+
+  if (lost > 0U) {
+    uint32_t rec[BINLOG_HEADER_SIZE + 1U];
+
+    rec[0] = BINLOG_HEADER(0U, BINLOG_TYPE_LOST, 1U);
+#if BINLOG_USE_TIMESTAMP == TRUE
+    rec[1] = (uint32_t)osalOsGetSystemTimeX();
+#endif
+    rec[BINLOG_HEADER_SIZE] = lost;
+    total += streamWrite(chp, (const uint8_t *)rec, sizeof rec);
+  }
+
+  return total;
+}
+
+/** @} */
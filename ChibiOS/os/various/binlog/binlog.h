@@ -0,0 +1,184 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    binlog.h
+ * @brief   Deferred binary logging macros and structures.
+ *
+ * @addtogroup BINLOG
+ * @{
+ */
+
+#ifndef BINLOG_H
+#define BINLOG_H
+
+#if defined(BINLOG_CONFIG_FILE)
+#include "binlogconf.h"
+#endif
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Record types
+ * @{
+ */
+#define BINLOG_TYPE_MESSAGE         0U
+#define BINLOG_TYPE_LOST            1U
+/** @} */
+
+/**
+ * @brief   Name of the section containing the format strings.
+ * @note    The section is not loaded on target, see @p rules_code.ld.
+ */
+#define BINLOG_SECTION              "binlog_fmt"
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Enables the logging.
+ * @details If disabled the logging macros produce no code and the format
+ *          strings are not stored.
+ */
+#if !defined(BINLOG_ENABLE) || defined(__DOXYGEN__)
+#define BINLOG_ENABLE               TRUE
+#endif
+
+/**
+ * @brief   Size of the log ring in 32 bits words.
+ * @note    Must be a power of two.
+ */
+#if !defined(BINLOG_BUFFER_SIZE) || defined(__DOXYGEN__)
+#define BINLOG_BUFFER_SIZE          256
+#endif
+
+/**
+ * @brief   Maximum number of arguments of a log record.
+ */
+#if !defined(BINLOG_MAX_ARGS) || defined(__DOXYGEN__)
+#define BINLOG_MAX_ARGS             8
+#endif
+
+/**
+ * @brief   Records carry the system time of the log call.
+ */
+#if !defined(BINLOG_USE_TIMESTAMP) || defined(__DOXYGEN__)
+#define BINLOG_USE_TIMESTAMP        TRUE
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (BINLOG_BUFFER_SIZE < 16) ||                                            \
+    ((BINLOG_BUFFER_SIZE & (BINLOG_BUFFER_SIZE - 1)) != 0)
+#error "BINLOG_BUFFER_SIZE must be a power of two not lower than 16"
+#endif
+
+#if (BINLOG_MAX_ARGS < 1) || (BINLOG_MAX_ARGS > 15)
+#error "BINLOG_MAX_ARGS must be in the range 1..15"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Log ring structure.
+ * @details The ring is written by the logging macros from any context and
+ *          read by a single drain thread.
+ */
+typedef struct {
+  /**
+   * @brief   Write index, free running.
+   */
+  volatile uint32_t         head;
+  /**
+   * @brief   Read index, free running.
+   */
+  volatile uint32_t         tail;
+  /**
+   * @brief   Records dropped because the ring was full.
+   */
+  volatile uint32_t         lost;
+  /**
+   * @brief   Ring storage.
+   */
+  uint32_t                  buffer[BINLOG_BUFFER_SIZE];
+} binlog_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+#if (BINLOG_ENABLE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Logs a message.
+ * @details The format string is stored in the @p binlog_fmt section and
+ *          only its identifier and the arguments are written in the ring,
+ *          the text is rebuilt on the host by @p binlog_decode.py.
+ * @note    The format string must be a literal using the @p chprintf()
+ *          syntax, the arguments are converted to @p uint32_t so strings
+ *          and floating point values are not supported.
+ * @note    If the ring is full the record is dropped and counted.
+ * @note    More than @p BINLOG_MAX_ARGS arguments fail to compile, the
+ *          count is a 4 bits field of the record header.
+ *
+ * @param[in] fmt       the format string literal
+ * @param[in] ...       up to @p BINLOG_MAX_ARGS integer arguments
+ *
+ * @special
+ */
+#define BLOG(fmt, ...) do {                                                 \
+  __attribute__((section(BINLOG_SECTION), used))                            \
+  static const char blog_fmt[] = fmt;                                       \
+  const uint32_t blog_args[] = {0U, ##__VA_ARGS__};                         \
+  typedef char blog_too_many_args[((sizeof blog_args /                      \
+                                    sizeof blog_args[0]) - 1U <=            \
+                                   BINLOG_MAX_ARGS) ? 1 : -1]               \
+                                   __attribute__((unused));                 \
+                                                                            \
+  blogWriteX(blog_fmt, &blog_args[1],                                       \
+             (sizeof blog_args / sizeof blog_args[0]) - 1U);                \
+} while (false)
+#else
+#define BLOG(fmt, ...) do {} while (false)
+#endif
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if !defined(__DOXYGEN__)
+extern binlog_t binlog;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void blogInit(void);
+  void blogWriteX(const char *fmt, const uint32_t *args, size_t n);
+  size_t blogDrain(BaseSequentialStream *chp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BINLOG_H */
+
+/** @} */
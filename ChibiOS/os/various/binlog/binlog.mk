@@ -0,0 +1,4 @@
+# Deferred binary logging files.
+BINLOGSRC = $(CHIBIOS)/os/various/binlog/binlog.c
+
+BINLOGINC = $(CHIBIOS)/os/various/binlog
@@ -0,0 +1,191 @@
+#!/usr/bin/env python3
+#
+#    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+#
+#    Licensed under the Apache License, Version 2.0 (the "License");
+#    you may not use this file except in compliance with the License.
+#    You may obtain a copy of the License at
+#
+#        http://www.apache.org/licenses/LICENSE-2.0
+#
+#    Unless required by applicable law or agreed to in writing, software
+#    distributed under the License is distributed on an "AS IS" BASIS,
+#    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#    See the License for the specific language governing permissions and
+#    limitations under the License.
+#
+
+"""Decodes a binary log stream written by blogDrain().
+
+The format strings are read from the "binlog_fmt" section of the ELF file the
+stream was produced by, the output is the text chprintf() would have
+printed, one line per record.
+
+Usage: binlog_decode.py [--tick-hz HZ] [--no-time] firmware.elf [log.bin]
+
+The log is read from standard input if no file is given. The stream must be
+decoded from its start, records are not delimited.
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+SECTION = b"binlog_fmt"
+
+TYPE_MESSAGE = 0
+TYPE_LOST = 1
+
+# Conversions consuming an argument word.
+ARGUMENTS = "cdDiIuUxXoOs"
+
+# chprintf() conversion: %[-][0][width|*][.precision|*][l|L]type
+CONVERSION = re.compile(r"%(-?)(0?)(\*|\d*)(?:\.(\*|\d*))?([lL]?)(.?)",
+                        re.DOTALL)
+
+
+def read_section(path, name):
+    """Returns the contents of an ELF section."""
+    with open(path, "rb") as f:
+        elf = f.read()
+    if elf[:4] != b"\x7fELF":
+        raise ValueError("%s is not an ELF file" % path)
+    wide = elf[4] == 2
+    endian = "<" if elf[5] == 1 else ">"
+    if wide:
+        shoff, = struct.unpack_from(endian + "Q", elf, 0x28)
+        shentsize, shnum, shstrndx = struct.unpack_from(endian + "HHH",
+                                                        elf, 0x3A)
+        shfmt = endian + "IIQQQQ"
+    else:
+        shoff, = struct.unpack_from(endian + "I", elf, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from(endian + "HHH",
+                                                        elf, 0x2E)
+        shfmt = endian + "IIIIII"
+
+    def header(i):
+        return struct.unpack_from(shfmt, elf, shoff + i * shentsize)
+
+    names = header(shstrndx)[4]
+    for i in range(shnum):
+        sh_name, _, _, _, offset, size = header(i)
+        end = elf.index(b"\0", names + sh_name)
+        if elf[names + sh_name:end] == name:
+            return elf[offset:offset + size]
+    raise ValueError("section %s not found in %s" % (name.decode(), path))
+
+
+def format_value(spec, arg):
+    """Formats one argument like chprintf() does."""
+    left, zero, width, precision, long_mod, conv = spec
+    if conv in "dDiI":
+        text = str(arg - (1 << 32) if arg & 0x80000000 else arg)
+    elif conv in "uU":
+        text = str(arg)
+    elif conv in "xX":
+        text = "%X" % arg
+    elif conv in "oO":
+        text = "%o" % arg
+    elif conv == "c":
+        text = chr(arg & 0xFF)
+    elif conv == "s":
+        # Strings are not logged, only their address.
+        text = "<%08X>" % arg
+        if precision:
+            text = text[:precision]
+    else:
+        # Unknown conversions print the character itself, as in "%%".
+        text = conv
+    filler = "0" if zero and conv not in "cs" else " "
+    if len(text) >= width:
+        return text
+    if left:
+        return text + filler * (width - len(text))
+    if filler == "0" and text.startswith("-"):
+        return "-" + text[1:].rjust(width - 1, "0")
+    return text.rjust(width, filler)
+
+
+def format_message(fmt, args):
+    """Renders a format string with the logged argument words."""
+    out = []
+    args = list(args)
+    pos = 0
+
+    def take():
+        return args.pop(0) if args else 0
+
+    while True:
+        m = CONVERSION.search(fmt, pos)
+        if m is None:
+            out.append(fmt[pos:])
+            return "".join(out)
+        out.append(fmt[pos:m.start()])
+        pos = m.end()
+        left, zero, width, precision, long_mod, conv = m.groups()
+        if conv == "":
+            return "".join(out)
+        if width == "*":
+            width = take()
+        if precision == "*":
+            precision = take()
+        width = int(width or 0)
+        precision = int(precision or 0)
+        spec = (left, zero, width, precision, long_mod, conv)
+        out.append(format_value(spec, take() if conv in ARGUMENTS else 0))
+
+
+def records(data, timestamp):
+    """Yields (type, identifier, time, arguments) from a log stream."""
+    words = struct.unpack("<%dI" % (len(data) // 4), data[:len(data) & ~3])
+    i = 0
+    size = 2 if timestamp else 1
+    while i + size <= len(words):
+        header = words[i]
+        n = header & 0x0F
+        if i + size + n > len(words):
+            break
+        yield ((header >> 4) & 0x0F, header >> 8,
+               words[i + 1] if timestamp else None,
+               words[i + size:i + size + n])
+        i += size + n
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("elf", help="ELF file containing the binlog_fmt section")
+    parser.add_argument("log", nargs="?", help="log stream, default stdin")
+    parser.add_argument("--tick-hz", type=int, default=0,
+                        help="system tick frequency, prints seconds")
+    parser.add_argument("--no-time", action="store_true",
+                        help="records have no timestamp "
+                             "(BINLOG_USE_TIMESTAMP disabled)")
+    opts = parser.parse_args()
+
+    strings = read_section(opts.elf, SECTION)
+    if opts.log:
+        with open(opts.log, "rb") as f:
+            data = f.read()
+    else:
+        data = sys.stdin.buffer.read()
+
+    for rtype, ident, time, args in records(data, not opts.no_time):
+        if rtype == TYPE_LOST:
+            text = "*** %d records lost" % args[0]
+        elif ident < len(strings):
+            end = strings.find(b"\0", ident)
+            fmt = strings[ident:end].decode("latin-1")
+            text = format_message(fmt, args).rstrip("\r\n")
+        else:
+            text = "*** unknown format %06X" % ident
+        if time is None:
+            print(text)
+        elif opts.tick_hz:
+            print("%12.6f %s" % (time / opts.tick_hz, text))
+        else:
+            print("%10u %s" % (time, text))
+
+
+if __name__ == "__main__":
+    main()
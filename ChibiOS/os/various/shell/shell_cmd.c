@@ -22,6 +22,7 @@
  * @{
  */
 
+#include <stdlib.h>
 #include <string.h>
 
 #include "ch.h"
@@ -30,6 +31,10 @@
 #include "shell_cmd.h"
 #include "chprintf.h"
 
+#if SHELL_CMD_CRIT_ENABLED == TRUE
+#include "osal_prof.h"
+#endif
+
 #if (SHELL_CMD_TEST_ENABLED == TRUE) || defined(__DOXYGEN__)
 #include "ch_test.h"
 #endif
@@ -170,6 +175,116 @@ static void cmd_threads(BaseSequentialStream *chp, int argc, char *argv[]) {
 }
 #endif
 
+#if (SHELL_CMD_TOP_ENABLED == TRUE) || defined(__DOXYGEN__)
+static void top_percent(BaseSequentialStream *chp, uint32_t part,
+                        uint32_t total) {
+  uint32_t permille = 0U;
+
+  if (total > 0U) {
+    permille = (uint32_t)(((uint64_t)part * 1000U) / total);
+  }
+  chprintf(chp, "%3lu.%lu%%", (unsigned long)(permille / 10U),
+           (unsigned long)(permille % 10U));
+}
+
+static void cmd_top(BaseSequentialStream *chp, int argc, char *argv[]) {
+  static const char *states[] = {"run", "ready", "block", "susp", "del"};
+  TaskStatus_t *before, *after, tmp;
+  UBaseType_t size, nbefore, nafter, i, j;
+  uint32_t start, end, irq, critical;
+  int interval = 1000, count = 1;
+
+  if (argc > 2) {
+    shellUsage(chp, "top [interval_ms [count]]");
+    return;
+  }
+  if (argc > 0) {
+    interval = atoi(argv[0]);
+  }
+  if (argc > 1) {
+    count = atoi(argv[1]);
+  }
+  if (interval <= 0) {
+    interval = 1000;
+  }
+
+  /* Room for a few tasks created while sampling.*/
+  size = uxTaskGetNumberOfTasks() + 4U;
+  before = pvPortMalloc(2U * size * sizeof (TaskStatus_t));
+  if (before == NULL) {
+    chprintf(chp, "out of memory"SHELL_NEWLINE_STR);
+    return;
+  }
+  after = before + size;
+
+  while (count-- > 0) {
+    nbefore = uxTaskGetSystemState(before, size, &start);
+    irq = osalIrqRunTime;
+    critical = ulPortCriticalRunTime;
+
+    osalThreadSleepMilliseconds(interval);
+
+    nafter = uxTaskGetSystemState(after, size, &end);
+    irq = osalIrqRunTime - irq;
+    critical = ulPortCriticalRunTime - critical;
+
+    /* Keep the run time of the interval only, tasks created meanwhile
+       ran for all of their counter.*/
+    for (i = 0U; i < nafter; i++) {
+      for (j = 0U; j < nbefore; j++) {
+        if (before[j].xTaskNumber == after[i].xTaskNumber) {
+          after[i].ulRunTimeCounter -= before[j].ulRunTimeCounter;
+          break;
+        }
+      }
+    }
+
+    /* Busiest first.*/
+    for (i = 0U; i < nafter; i++) {
+      for (j = i + 1U; j < nafter; j++) {
+        if (after[j].ulRunTimeCounter > after[i].ulRunTimeCounter) {
+          tmp = after[i];
+          after[i] = after[j];
+          after[j] = tmp;
+        }
+      }
+    }
+
+    chprintf(chp, "prio state    cpu  stack name"SHELL_NEWLINE_STR);
+    for (i = 0U; i < nafter; i++) {
+      chprintf(chp, "%4lu %5s ", (unsigned long)after[i].uxCurrentPriority,
+               states[after[i].eCurrentState]);
+      top_percent(chp, after[i].ulRunTimeCounter, end - start);
+      chprintf(chp, " %6lu %s"SHELL_NEWLINE_STR,
+               (unsigned long)after[i].usStackHighWaterMark,
+               after[i].pcTaskName);
+    }
+    chprintf(chp, "      irq  ");
+    top_percent(chp, irq, end - start);
+    chprintf(chp, SHELL_NEWLINE_STR"      crit ");
+    top_percent(chp, critical, end - start);
+    chprintf(chp, SHELL_NEWLINE_STR SHELL_NEWLINE_STR);
+  }
+
+  vPortFree(before);
+}
+#endif
+
+#if (SHELL_CMD_CRIT_ENABLED == TRUE) || defined(__DOXYGEN__)
+static void cmd_crit(BaseSequentialStream *chp, int argc, char *argv[]) {
+
+  if ((argc > 1) || ((argc == 1) && (strcmp(argv[0], "reset") != 0))) {
+    shellUsage(chp, "crit [reset]");
+    return;
+  }
+  if (argc == 1) {
+    osalProfReset();
+    return;
+  }
+  osalProfDump(chp);
+}
+#endif
+
 #if (SHELL_CMD_TEST_ENABLED == TRUE) || defined(__DOXYGEN__)
 static void cmd_test(BaseSequentialStream *chp, int argc, char *argv[]) {
   thread_t *tp;
@@ -216,6 +331,12 @@ const ShellCommand shell_local_commands[] = {
 #if SHELL_CMD_THREADS_ENABLED == TRUE
   {"threads", cmd_threads},
 #endif
+#if SHELL_CMD_TOP_ENABLED == TRUE
+  {"top", cmd_top},
+#endif
+#if SHELL_CMD_CRIT_ENABLED == TRUE
+  {"crit", cmd_crit},
+#endif
 #if SHELL_CMD_TEST_ENABLED == TRUE
   {"test", cmd_test},
 #endif
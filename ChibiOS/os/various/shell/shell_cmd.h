@@ -61,6 +61,24 @@
 #define SHELL_CMD_TEST_ENABLED              TRUE
 #endif
 
+/* Only available on FreeRTOS, built with run time statistics. */
+#if !defined(SHELL_CMD_TOP_ENABLED) || defined(__DOXYGEN__)
+#if defined(configGENERATE_RUN_TIME_STATS) && (configGENERATE_RUN_TIME_STATS == 1)
+#define SHELL_CMD_TOP_ENABLED               TRUE
+#else
+#define SHELL_CMD_TOP_ENABLED               FALSE
+#endif
+#endif
+
+/* Only available when the OSAL critical section profiler is built in. */
+#if !defined(SHELL_CMD_CRIT_ENABLED) || defined(__DOXYGEN__)
+#if defined(configUSE_CRITICAL_PROFILER) && (configUSE_CRITICAL_PROFILER == 1)
+#define SHELL_CMD_CRIT_ENABLED              TRUE
+#else
+#define SHELL_CMD_CRIT_ENABLED              FALSE
+#endif
+#endif
+
 #if !defined(SHELL_CMD_TEST_WA_SIZE) || defined(__DOXYGEN__)
 #define SHELL_CMD_TEST_WA_SIZE              THD_WORKING_AREA_SIZE(256)
 #endif
@@ -81,6 +99,10 @@
 #error "SHELL_CMD_THREADS_ENABLED requires CH_CFG_USE_REGISTRY"
 #endif
 
+#if (SHELL_CMD_TOP_ENABLED == TRUE) && (configUSE_TRACE_FACILITY != 1)
+#error "SHELL_CMD_TOP_ENABLED requires configUSE_TRACE_FACILITY"
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
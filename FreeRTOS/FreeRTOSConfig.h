@@ -13,9 +13,29 @@
  *----------------------------------------------------------*/
 
 #define configUSE_PREEMPTION		1
+#ifdef SIMULATOR
+/* The Posix port dispatches its simulated interrupts from the idle hook. */
+#define configUSE_IDLE_HOOK			1
+#else
 #define configUSE_IDLE_HOOK			0
-#define configUSE_TICK_HOOK			0
+#endif
+/* The tick hook fires the OSAL virtual timers, see osal_ch_vt.c. */
+#define configUSE_TICK_HOOK			1
 #define configUSE_TICKLESS_IDLE     1
+/* Tickless idle periods longer than the SysTick range sleep on a low power
+timer driven by the application (ARM_CM0 port, see its portmacro.h). */
+#define configUSE_LOW_POWER_TIMER   0
+/* Tick count read from a free running timer, the tick interrupt only fires
+when a task or a virtual timer is due. Raise configTICK_RATE_HZ (100000 gives
+10us timeouts) when enabling it. Supported by the ARM_CM3, ARM_CM4F and Posix
+ports, the ARM ones need a 32 bit timer of the application clocked at
+configTIMEBASE_CLOCK_HZ (see their portmacro.h). */
+#define configUSE_HIGH_RES_TIMEBASE 0
+/* Delayed tasks are kept in a hierarchical timing wheel instead of a sorted
+list, blocking with a timeout is O(1) whatever the number of delayed tasks. The
+wheel has 2^configTIMING_WHEEL_SLOT_BITS lists per group of that many tick bits
+(128 lists for 32 bit ticks and the default of 4). */
+#define configUSE_TIMING_WHEEL      0
 //#define configCPU_CLOCK_HZ			( ( unsigned long ) 72000000 )
 #define configCPU_CLOCK_HZ			( ( unsigned long ) 48000000 )
 #define configSYSTICK_CLOCK_HZ      (configCPU_CLOCK_HZ / 8)
@@ -37,10 +57,25 @@
 #define configCHECK_FOR_STACK_OVERFLOW	2
 #define configUSE_RECURSIVE_MUTEXES		1
 #define configQUEUE_REGISTRY_SIZE		0
+/* Per task CPU time, counted in core cycles by the port (see the top shell
+command). Costs a counter read in every critical section and interrupt. */
 #define configGENERATE_RUN_TIME_STATS	0
+/* Time every osalSysLock() call site, dumped by the crit shell command. */
+#define configUSE_CRITICAL_PROFILER     0
 #define configSUPPORT_STATIC_ALLOCATION 1
 #define configSUPPORT_DYNAMIC_ALLOCATION 1
 
+/* Set to 1 for the constant time TLSF allocator (heap_tlsf.c) instead of the
+first fit heap.c.  With it, allocations of 1 << configTLSF_MAX_BLOCK_SIZE_LOG2
+bytes or more fail, and a larger heap is split in several blocks of at most
+that size. */
+#define configUSE_TLSF_HEAP             0
+#ifdef SIMULATOR
+#define configTLSF_MAX_BLOCK_SIZE_LOG2  20
+#else
+#define configTLSF_MAX_BLOCK_SIZE_LOG2  17
+#endif
+
 #define configUSE_TIMERS                0
 #define configTIMER_TASK_PRIORITY       1
 #define configTIMER_QUEUE_LENGTH        8
@@ -58,7 +93,14 @@ to exclude the API function. */
 
 #define configPORT_BUSY_DELAY_SCALE 	8
 
-#define configNUM_THREAD_LOCAL_STORAGE_POINTERS 2
+/* chMsgSend() and friends. */
+#ifndef configUSE_OSAL_MESSAGES
+#define configUSE_OSAL_MESSAGES         0
+#endif
+#define configNUM_THREAD_LOCAL_STORAGE_POINTERS 0
+
+/* The last notification index is reserved for the OSAL. */
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES 2
 /* This is the raw value as per the Cortex-M3 NVIC.  Values can be 255
 (lowest) to 0 (1?) (highest). */
 #define configKERNEL_INTERRUPT_PRIORITY 		255
@@ -82,5 +124,9 @@ NVIC value of 255. */
 void errorAssertCalled(const char*, unsigned long, const char*);
 #define configASSERT(x) if( (x) == 0 ) errorAssertCalled( __FILE__, __LINE__, NULL )
 
+/* Tickless idle must wake up in time for the next virtual timer. */
+uint32_t osalVTGetIdleTimeX(uint32_t);
+#define configPRE_SUPPRESS_TICKS_AND_SLEEP_PROCESSING(x) ( x ) = osalVTGetIdleTimeX( x )
+
 #endif /* FREERTOS_CONFIG_H */
 
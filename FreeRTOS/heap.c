@@ -46,6 +46,9 @@ task.h is included from an application file. */
 
 #undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
 
+/* heap_tlsf.c provides the allocator instead. */
+#if( configUSE_TLSF_HEAP == 0 )
+
 #if( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
 	#error This file must not be used if configSUPPORT_DYNAMIC_ALLOCATION is 0
 #endif
@@ -452,3 +455,5 @@ size_t chHeapStatus  (void* ignore, size_t* memFree, size_t* largestBlock){
     return blocks;
 
 }
+
+#endif /* configUSE_TLSF_HEAP */
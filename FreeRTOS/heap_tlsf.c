@@ -0,0 +1,574 @@
+/*
+ * FreeRTOS Kernel V10.0.0
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software. If you wish to use our Amazon
+ * FreeRTOS name, please do so in a fair use way that does not cause confusion.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * An implementation of pvPortMalloc() and vPortFree() using a two level
+ * segregated fit (TLSF) allocator.  The free blocks are kept in lists of
+ * similar sizes: the first level splits the sizes in powers of two, the second
+ * level splits each power of two in heapTLSF_SL_COUNT ranges.  A bitmap of the
+ * non empty lists finds a large enough block with a couple of bit scans, and
+ * adjacent free blocks are merged through the physical neighbour links, so
+ * both pvPortMalloc() and vPortFree() take constant time whatever the
+ * fragmentation.
+ *
+ * Selected with configUSE_TLSF_HEAP, see heap.c for the first fit
+ * implementation.  Both use the __heap_base__ and __heap_end__ symbols of the
+ * linker script.
+ */
+#include <stdlib.h>
+#include <stddef.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#if( configUSE_TLSF_HEAP == 1 )
+
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
+	#error This file must not be used if configSUPPORT_DYNAMIC_ALLOCATION is 0
+#endif
+
+/* Each power of two is split in 1 << configTLSF_SL_INDEX_COUNT_LOG2 lists. */
+#ifndef configTLSF_SL_INDEX_COUNT_LOG2
+	#define configTLSF_SL_INDEX_COUNT_LOG2	3
+#endif
+
+/* Blocks are smaller than 1 << configTLSF_MAX_BLOCK_SIZE_LOG2 bytes, a larger
+heap is split in several blocks.  Every power of two costs heapTLSF_SL_COUNT
+list heads. */
+#ifndef configTLSF_MAX_BLOCK_SIZE_LOG2
+	#define configTLSF_MAX_BLOCK_SIZE_LOG2	17
+#endif
+
+#if( portBYTE_ALIGNMENT == 32 )
+	#define heapALIGNMENT_LOG2		5
+#elif( portBYTE_ALIGNMENT == 16 )
+	#define heapALIGNMENT_LOG2		4
+#elif( portBYTE_ALIGNMENT == 8 )
+	#define heapALIGNMENT_LOG2		3
+#else
+	#error The TLSF heap needs portBYTE_ALIGNMENT to be 8, 16 or 32
+#endif
+
+#define heapTLSF_SL_COUNT		( 1UL << configTLSF_SL_INDEX_COUNT_LOG2 )
+#define heapTLSF_FL_COUNT		( configTLSF_MAX_BLOCK_SIZE_LOG2 - configTLSF_SL_INDEX_COUNT_LOG2 - heapALIGNMENT_LOG2 + 1 )
+
+#if( heapTLSF_SL_COUNT > 32 ) || ( heapTLSF_FL_COUNT > 32 ) || ( heapTLSF_FL_COUNT < 1 )
+	#error The TLSF bitmaps do not fit 32 bits, check configTLSF_SL_INDEX_COUNT_LOG2 and configTLSF_MAX_BLOCK_SIZE_LOG2
+#endif
+
+/* The two low bits of the block size are always 0 as sizes are multiples of
+portBYTE_ALIGNMENT, they are used as flags. */
+#define heapBLOCK_FREE_BIT		( ( size_t ) 1 )
+#define heapPREV_FREE_BIT		( ( size_t ) 2 )
+#define heapBLOCK_SIZE_MASK		( ~( heapBLOCK_FREE_BIT | heapPREV_FREE_BIT ) )
+
+/* Our linker script defines __heap_base__ and __heap_end__,
+ * mapping the final region of all remaining RAM */
+extern uint8_t __heap_base__[];
+extern uint8_t __heap_end__[];
+
+/* The header of a block.  The free list links are only used while the block
+is free, they overlap the memory handed to the application. */
+typedef struct A_TLSF_BLOCK
+{
+	struct A_TLSF_BLOCK *pxPrevPhysBlock;	/*<< The block just before this one in memory. */
+	size_t xBlockSize;						/*<< The size of the block, header included, and the flags. */
+	struct A_TLSF_BLOCK *pxNextFreeBlock;	/*<< The next block in the same free list. */
+	struct A_TLSF_BLOCK *pxPrevFreeBlock;	/*<< The previous block in the same free list. */
+} TlsfBlock_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Called automatically to setup the required heap structures the first time
+ * pvPortMalloc() is called.
+ */
+static void prvHeapInit( void );
+
+/*
+ * Find the free list a block of xBlockSize bytes belongs to.
+ */
+static void prvMapSize( size_t xBlockSize, UBaseType_t *puxFirstLevel, UBaseType_t *puxSecondLevel );
+
+/*
+ * Add and remove a free block from its free list.
+ */
+static void prvInsertFreeBlock( TlsfBlock_t *pxBlock );
+static void prvRemoveFreeBlock( TlsfBlock_t *pxBlock );
+
+/*-----------------------------------------------------------*/
+
+/* The size of the structure placed at the beginning of each allocated memory
+block must by correctly byte aligned, only the physical links are kept while
+the block is allocated. */
+static const size_t xHeapStructSize	= ( offsetof( TlsfBlock_t, pxNextFreeBlock ) + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+/* Block sizes must not get too small, a free block has to hold the free list
+links. */
+static const size_t xMinimumBlockSize = ( sizeof( TlsfBlock_t ) + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+/* The heads of the free lists, and a bit per non empty list. */
+static TlsfBlock_t *pxFreeLists[ heapTLSF_FL_COUNT ][ heapTLSF_SL_COUNT ];
+static uint32_t ulFirstLevelBitmap = 0;
+static uint32_t ulSecondLevelBitmap[ heapTLSF_FL_COUNT ];
+
+/* Marks the end of the heap, it is never free so it is never merged. */
+static TlsfBlock_t *pxEnd = NULL;
+
+/* Keeps track of the number of free bytes remaining, but says nothing about
+fragmentation. */
+static size_t xFreeBytesRemaining = 0U;
+static size_t xMinimumEverFreeBytesRemaining = 0U;
+static size_t xNumberOfFreeBlocks = 0U;
+
+/*-----------------------------------------------------------*/
+
+static portINLINE UBaseType_t prvFindLastSet( uint32_t ulValue )
+{
+	return ( UBaseType_t ) ( 31 - __builtin_clz( ulValue ) );
+}
+/*-----------------------------------------------------------*/
+
+static portINLINE UBaseType_t prvFindFirstSet( uint32_t ulValue )
+{
+	return ( UBaseType_t ) __builtin_ctz( ulValue );
+}
+/*-----------------------------------------------------------*/
+
+static portINLINE TlsfBlock_t *prvNextPhysBlock( TlsfBlock_t *pxBlock )
+{
+	return ( void * ) ( ( ( uint8_t * ) pxBlock ) + ( pxBlock->xBlockSize & heapBLOCK_SIZE_MASK ) );
+}
+/*-----------------------------------------------------------*/
+
+static void prvMapSize( size_t xBlockSize, UBaseType_t *puxFirstLevel, UBaseType_t *puxSecondLevel )
+{
+size_t xUnits = xBlockSize >> heapALIGNMENT_LOG2;
+UBaseType_t uxLastSet;
+
+	if( xUnits < heapTLSF_SL_COUNT )
+	{
+		/* Small blocks all go in the first list, one entry per size. */
+		*puxFirstLevel = 0;
+		*puxSecondLevel = ( UBaseType_t ) xUnits;
+	}
+	else
+	{
+		uxLastSet = prvFindLastSet( ( uint32_t ) xUnits );
+		*puxFirstLevel = uxLastSet - configTLSF_SL_INDEX_COUNT_LOG2 + 1;
+		*puxSecondLevel = ( UBaseType_t ) ( ( xUnits >> ( uxLastSet - configTLSF_SL_INDEX_COUNT_LOG2 ) ) - heapTLSF_SL_COUNT );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvInsertFreeBlock( TlsfBlock_t *pxBlock )
+{
+UBaseType_t uxFirstLevel, uxSecondLevel;
+TlsfBlock_t *pxHead;
+
+	prvMapSize( pxBlock->xBlockSize & heapBLOCK_SIZE_MASK, &uxFirstLevel, &uxSecondLevel );
+
+	pxHead = pxFreeLists[ uxFirstLevel ][ uxSecondLevel ];
+	pxBlock->pxNextFreeBlock = pxHead;
+	pxBlock->pxPrevFreeBlock = NULL;
+	if( pxHead != NULL )
+	{
+		pxHead->pxPrevFreeBlock = pxBlock;
+	}
+	pxFreeLists[ uxFirstLevel ][ uxSecondLevel ] = pxBlock;
+
+	ulFirstLevelBitmap |= 1UL << uxFirstLevel;
+	ulSecondLevelBitmap[ uxFirstLevel ] |= 1UL << uxSecondLevel;
+
+	/* The next block has to know this one can be merged. */
+	pxBlock->xBlockSize |= heapBLOCK_FREE_BIT;
+	prvNextPhysBlock( pxBlock )->xBlockSize |= heapPREV_FREE_BIT;
+	xNumberOfFreeBlocks++;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRemoveFreeBlock( TlsfBlock_t *pxBlock )
+{
+UBaseType_t uxFirstLevel, uxSecondLevel;
+
+	prvMapSize( pxBlock->xBlockSize & heapBLOCK_SIZE_MASK, &uxFirstLevel, &uxSecondLevel );
+
+	if( pxBlock->pxNextFreeBlock != NULL )
+	{
+		pxBlock->pxNextFreeBlock->pxPrevFreeBlock = pxBlock->pxPrevFreeBlock;
+	}
+
+	if( pxBlock->pxPrevFreeBlock != NULL )
+	{
+		pxBlock->pxPrevFreeBlock->pxNextFreeBlock = pxBlock->pxNextFreeBlock;
+	}
+	else
+	{
+		pxFreeLists[ uxFirstLevel ][ uxSecondLevel ] = pxBlock->pxNextFreeBlock;
+		if( pxBlock->pxNextFreeBlock == NULL )
+		{
+			ulSecondLevelBitmap[ uxFirstLevel ] &= ~( 1UL << uxSecondLevel );
+			if( ulSecondLevelBitmap[ uxFirstLevel ] == 0 )
+			{
+				ulFirstLevelBitmap &= ~( 1UL << uxFirstLevel );
+			}
+		}
+	}
+
+	pxBlock->xBlockSize &= ~heapBLOCK_FREE_BIT;
+	prvNextPhysBlock( pxBlock )->xBlockSize &= ~heapPREV_FREE_BIT;
+	xNumberOfFreeBlocks--;
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Find a free block of at least xWantedSize bytes.  The size is rounded up to
+ * the next list boundary, so any block of the list found fits and the search
+ * never walks a list.
+ */
+static TlsfBlock_t *prvFindFreeBlock( size_t xWantedSize )
+{
+UBaseType_t uxFirstLevel, uxSecondLevel;
+size_t xUnits = xWantedSize >> heapALIGNMENT_LOG2;
+uint32_t ulMap;
+
+	if( xUnits >= heapTLSF_SL_COUNT )
+	{
+		xUnits += ( ( size_t ) 1 << ( prvFindLastSet( ( uint32_t ) xUnits ) - configTLSF_SL_INDEX_COUNT_LOG2 ) ) - 1;
+	}
+
+	prvMapSize( xUnits << heapALIGNMENT_LOG2, &uxFirstLevel, &uxSecondLevel );
+	if( uxFirstLevel >= heapTLSF_FL_COUNT )
+	{
+		return NULL;
+	}
+
+	/* A list of the same power of two with large enough blocks... */
+	ulMap = ulSecondLevelBitmap[ uxFirstLevel ] & ( ~0UL << uxSecondLevel );
+	if( ulMap == 0 )
+	{
+		/* ...or the smallest list of the larger powers of two. */
+		ulMap = ( uxFirstLevel + 1 < 32 ) ? ( ulFirstLevelBitmap & ( ~0UL << ( uxFirstLevel + 1 ) ) ) : 0;
+		if( ulMap == 0 )
+		{
+			return NULL;
+		}
+
+		uxFirstLevel = prvFindFirstSet( ulMap );
+		ulMap = ulSecondLevelBitmap[ uxFirstLevel ];
+	}
+
+	uxSecondLevel = prvFindFirstSet( ulMap );
+	return pxFreeLists[ uxFirstLevel ][ uxSecondLevel ];
+}
+/*-----------------------------------------------------------*/
+
+void *pvPortMalloc( size_t xWantedSize )
+{
+TlsfBlock_t *pxBlock, *pxNewBlockLink;
+size_t xBlockSize;
+void *pvReturn = NULL;
+
+	vTaskSuspendAll();
+	{
+		/* If this is the first call to malloc then the heap will require
+		initialisation to setup the list of free blocks. */
+		if( pxEnd == NULL )
+		{
+			prvHeapInit();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		/* The wanted size is increased so it can contain the header, and
+		rounded up so blocks are always aligned to the required number of
+		bytes.  Larger sizes could not be mapped to a free list anyway. */
+		if( ( xWantedSize > 0 ) && ( xWantedSize < ( ( size_t ) 1 << configTLSF_MAX_BLOCK_SIZE_LOG2 ) ) )
+		{
+			xWantedSize += xHeapStructSize;
+			xWantedSize = ( xWantedSize + portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+			if( xWantedSize < xMinimumBlockSize )
+			{
+				xWantedSize = xMinimumBlockSize;
+			}
+
+			pxBlock = prvFindFreeBlock( xWantedSize );
+			if( pxBlock != NULL )
+			{
+				prvRemoveFreeBlock( pxBlock );
+				xBlockSize = pxBlock->xBlockSize & heapBLOCK_SIZE_MASK;
+
+				/* If the block is larger than required it can be split into
+				two, the remainder goes back to the free lists. */
+				if( ( xBlockSize - xWantedSize ) >= xMinimumBlockSize )
+				{
+					pxNewBlockLink = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xWantedSize );
+					configASSERT( ( ( ( size_t ) pxNewBlockLink ) & portBYTE_ALIGNMENT_MASK ) == 0 );
+
+					pxNewBlockLink->xBlockSize = xBlockSize - xWantedSize;
+					pxNewBlockLink->pxPrevPhysBlock = pxBlock;
+					prvNextPhysBlock( pxNewBlockLink )->pxPrevPhysBlock = pxNewBlockLink;
+					pxBlock->xBlockSize = xWantedSize | ( pxBlock->xBlockSize & heapPREV_FREE_BIT );
+
+					prvInsertFreeBlock( pxNewBlockLink );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				xFreeBytesRemaining -= pxBlock->xBlockSize & heapBLOCK_SIZE_MASK;
+
+				if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
+				{
+					xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				/* Return the memory space pointed to - jumping over the
+				header at its start. */
+				pvReturn = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xHeapStructSize );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		traceMALLOC( pvReturn, xWantedSize );
+	}
+	( void ) xTaskResumeAll();
+
+	#if( configUSE_MALLOC_FAILED_HOOK == 1 )
+	{
+		if( pvReturn == NULL )
+		{
+			extern void vApplicationMallocFailedHook( void );
+			vApplicationMallocFailedHook();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif
+
+	configASSERT( ( ( ( size_t ) pvReturn ) & ( size_t ) portBYTE_ALIGNMENT_MASK ) == 0 );
+	return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vPortFree( void *pv )
+{
+uint8_t *puc = ( uint8_t * ) pv;
+TlsfBlock_t *pxBlock, *pxNeighbour;
+
+	if( pv != NULL )
+	{
+		/* The memory being freed will have a header immediately before it. */
+		puc -= xHeapStructSize;
+
+		/* This casting is to keep the compiler from issuing warnings. */
+		pxBlock = ( void * ) puc;
+
+		/* Check the block is actually allocated. */
+		configASSERT( ( pxBlock->xBlockSize & heapBLOCK_FREE_BIT ) == 0 );
+
+		if( ( pxBlock->xBlockSize & heapBLOCK_FREE_BIT ) == 0 )
+		{
+			vTaskSuspendAll();
+			{
+				xFreeBytesRemaining += pxBlock->xBlockSize & heapBLOCK_SIZE_MASK;
+				traceFREE( pv, pxBlock->xBlockSize & heapBLOCK_SIZE_MASK );
+
+				/* Merge with the block before it... */
+				if( ( pxBlock->xBlockSize & heapPREV_FREE_BIT ) != 0 )
+				{
+					pxNeighbour = pxBlock->pxPrevPhysBlock;
+					prvRemoveFreeBlock( pxNeighbour );
+					pxNeighbour->xBlockSize += pxBlock->xBlockSize & heapBLOCK_SIZE_MASK;
+					pxBlock = pxNeighbour;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				/* ...and with the block after it. */
+				pxNeighbour = prvNextPhysBlock( pxBlock );
+				if( ( pxNeighbour->xBlockSize & heapBLOCK_FREE_BIT ) != 0 )
+				{
+					prvRemoveFreeBlock( pxNeighbour );
+					pxBlock->xBlockSize += pxNeighbour->xBlockSize & heapBLOCK_SIZE_MASK;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				prvNextPhysBlock( pxBlock )->pxPrevPhysBlock = pxBlock;
+				prvInsertFreeBlock( pxBlock );
+			}
+			( void ) xTaskResumeAll();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetFreeHeapSize( void )
+{
+	return xFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetMinimumEverFreeHeapSize( void )
+{
+	return xMinimumEverFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+void vPortInitialiseBlocks( void )
+{
+	/* This just exists to keep the linker quiet. */
+}
+/*-----------------------------------------------------------*/
+
+static void prvHeapInit( void )
+{
+TlsfBlock_t *pxBlock, *pxPrevBlock = NULL;
+size_t uxAddress, uxEndAddress, xBlockSize;
+const size_t xMaximumBlockSize = ( ( size_t ) 1 << configTLSF_MAX_BLOCK_SIZE_LOG2 ) - portBYTE_ALIGNMENT;
+
+	/* Ensure the heap starts and ends on a correctly aligned boundary. */
+	uxAddress = ( ( size_t ) __heap_base__ + portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+	uxEndAddress = ( ( size_t ) __heap_end__ - xHeapStructSize ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+	/* pxEnd is an allocated block of size 0 at the end of the heap space, so
+	the last block is never merged beyond it. */
+	pxEnd = ( void * ) uxEndAddress;
+	pxEnd->xBlockSize = 0;
+
+	/* A block can not be larger than the free lists can hold, a larger heap
+	space is split in several free blocks.  All but the last are followed by
+	an allocated header that is never freed, so they are never merged back
+	into a block the lists can not hold. */
+	xFreeBytesRemaining = 0;
+	for( ;; )
+	{
+		pxBlock = ( void * ) uxAddress;
+		pxBlock->pxPrevPhysBlock = pxPrevBlock;
+		xBlockSize = uxEndAddress - uxAddress;
+
+		if( xBlockSize <= xMaximumBlockSize )
+		{
+			/* The last block takes up the rest of the heap space, minus the
+			space taken by pxEnd. */
+			pxBlock->xBlockSize = xBlockSize;
+			pxEnd->pxPrevPhysBlock = pxBlock;
+			prvInsertFreeBlock( pxBlock );
+			xFreeBytesRemaining += xBlockSize;
+			break;
+		}
+
+		/* Leave room for the header and a whole block after it. */
+		if( ( xBlockSize - xMaximumBlockSize ) < ( xHeapStructSize + xMinimumBlockSize ) )
+		{
+			xBlockSize -= xHeapStructSize + xMinimumBlockSize;
+		}
+		else
+		{
+			xBlockSize = xMaximumBlockSize;
+		}
+
+		pxBlock->xBlockSize = xBlockSize;
+		uxAddress += xBlockSize;
+
+		pxPrevBlock = ( void * ) uxAddress;
+		pxPrevBlock->pxPrevPhysBlock = pxBlock;
+		pxPrevBlock->xBlockSize = xHeapStructSize;
+		uxAddress += xHeapStructSize;
+
+		prvInsertFreeBlock( pxBlock );
+		xFreeBytesRemaining += xBlockSize;
+	}
+
+	xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+/* ChibiOS style memory info function */
+size_t chHeapStatus  (void* ignore, size_t* memFree, size_t* largestBlock){
+    TlsfBlock_t *pxIterator;
+    UBaseType_t uxFirstLevel;
+    size_t blocks;
+
+    (void)ignore;
+    *largestBlock = 0;
+
+    vTaskSuspendAll();
+
+    *memFree = xFreeBytesRemaining;
+    blocks = xNumberOfFreeBlocks;
+
+    /* The largest block is in the last non empty list */
+    if(ulFirstLevelBitmap){
+        uxFirstLevel = prvFindLastSet(ulFirstLevelBitmap);
+        pxIterator = pxFreeLists[uxFirstLevel][prvFindLastSet(ulSecondLevelBitmap[uxFirstLevel])];
+        for(; pxIterator; pxIterator = pxIterator->pxNextFreeBlock){
+            if((pxIterator->xBlockSize & heapBLOCK_SIZE_MASK) > *largestBlock){
+                *largestBlock = pxIterator->xBlockSize & heapBLOCK_SIZE_MASK;
+            }
+        }
+    }
+
+    (void)xTaskResumeAll();
+
+    return blocks;
+}
+
+#endif /* configUSE_TLSF_HEAP */
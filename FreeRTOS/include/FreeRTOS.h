@@ -739,6 +739,34 @@ extern "C" {
 	#define configUSE_TICKLESS_IDLE 0
 #endif
 
+#ifndef configUSE_TLSF_HEAP
+	#define configUSE_TLSF_HEAP 0
+#endif
+
+#ifndef configUSE_HIGH_RES_TIMEBASE
+	#define configUSE_HIGH_RES_TIMEBASE 0
+#endif
+
+#if( configUSE_HIGH_RES_TIMEBASE == 1 ) && !defined( portGET_UNPROCESSED_TICKS )
+	#error This port does not support configUSE_HIGH_RES_TIMEBASE
+#endif
+
+#ifndef configUSE_TIMING_WHEEL
+	#define configUSE_TIMING_WHEEL 0
+#endif
+
+#ifndef configUSE_OSAL_MESSAGES
+	#define configUSE_OSAL_MESSAGES 0
+#endif
+
+#ifndef configTIMING_WHEEL_SLOT_BITS
+	#define configTIMING_WHEEL_SLOT_BITS 4
+#endif
+
+#if( configTIMING_WHEEL_SLOT_BITS < 1 ) || ( configTIMING_WHEEL_SLOT_BITS > 5 )
+	#error configTIMING_WHEEL_SLOT_BITS must be in the range 1 to 5
+#endif
+
 #ifndef configPRE_SUPPRESS_TICKS_AND_SLEEP_PROCESSING
 	#define configPRE_SUPPRESS_TICKS_AND_SLEEP_PROCESSING( x )
 #endif
@@ -807,6 +835,14 @@ extern "C" {
 	#define configUSE_TASK_NOTIFICATIONS 1
 #endif
 
+#ifndef configTASK_NOTIFICATION_ARRAY_ENTRIES
+	#define configTASK_NOTIFICATION_ARRAY_ENTRIES 1
+#endif
+
+#if configTASK_NOTIFICATION_ARRAY_ENTRIES < 1
+	#error configTASK_NOTIFICATION_ARRAY_ENTRIES must be at least 1
+#endif
+
 #ifndef portTICK_TYPE_IS_ATOMIC
 	#define portTICK_TYPE_IS_ATOMIC 0
 #endif
@@ -1017,8 +1053,8 @@ typedef struct xSTATIC_TCB
 		struct	_reent	xDummy17;
 	#endif
 	#if ( configUSE_TASK_NOTIFICATIONS == 1 )
-		uint32_t 		ulDummy18;
-		uint8_t 		ucDummy19;
+		uint32_t 		ulDummy18[ configTASK_NOTIFICATION_ARRAY_ENTRIES ];
+		uint8_t 		ucDummy19[ configTASK_NOTIFICATION_ARRAY_ENTRIES ];
 	#endif
 	#if( ( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) ) || ( portUSING_MPU_WRAPPERS == 1 ) )
 		uint8_t			uxDummy20;
@@ -1027,6 +1063,10 @@ typedef struct xSTATIC_TCB
 	#if( INCLUDE_xTaskAbortDelay == 1 )
 		uint8_t ucDummy21;
 	#endif
+
+	#if( configUSE_OSAL_MESSAGES == 1 )
+		void			*pvDummy22[ 2 ];
+	#endif
 } StaticTask_t;
 
 /*
@@ -2,5 +2,6 @@
  * Some ChibiOS code wants to see an include file with
  * this name.
  *
- * It is only here to avoid compile errors
+ * The OSAL provides the few kernel functions such code uses
  */
+#include "osal_ch.h"
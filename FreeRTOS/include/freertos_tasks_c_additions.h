@@ -16,3 +16,94 @@ xTaskHandle xGetCurrentTaskHandle( void )
 
     return xReturn;
 }
+
+#if( configUSE_MUTEXES == 1 )
+
+/* Runs a task at the higher of its base priority and uxPriority, used by the
+ * OSAL to donate the priority of message senders to their server. Like the
+ * mutex inheritance, the priority is only lowered when no mutexes are held,
+ * they may have raised it. */
+void vTaskPriorityDonate( TaskHandle_t xTask, UBaseType_t uxPriority )
+{
+    TCB_t * const pxTCB = prvGetTCBFromHandle( xTask );
+    UBaseType_t uxPriorityUsedOnEntry = pxTCB->uxPriority;
+
+    if( uxPriority < pxTCB->uxBasePriority )
+    {
+        uxPriority = pxTCB->uxBasePriority;
+    }
+
+    if( ( uxPriority == uxPriorityUsedOnEntry ) ||
+        ( ( uxPriority < uxPriorityUsedOnEntry ) && ( pxTCB->uxMutexesHeld != 0 ) ) )
+    {
+        return;
+    }
+
+    pxTCB->uxPriority = uxPriority;
+
+    if( ( listGET_LIST_ITEM_VALUE( &( pxTCB->xEventListItem ) ) & taskEVENT_LIST_ITEM_VALUE_IN_USE ) == 0UL )
+    {
+        List_t * const pxEventList = ( List_t * ) listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) );
+
+        listSET_LIST_ITEM_VALUE( &( pxTCB->xEventListItem ), ( TickType_t ) configMAX_PRIORITIES - ( TickType_t ) uxPriority );
+
+        /* A task blocked on a queue or semaphore moves to the place of its
+         * new priority, the highest priority waiter is the one unblocked.
+         * The pending ready list is not sorted. */
+        if( ( pxEventList != NULL ) && ( pxEventList != &xPendingReadyList ) )
+        {
+            ( void ) uxListRemove( &( pxTCB->xEventListItem ) );
+            vListInsert( pxEventList, &( pxTCB->xEventListItem ) );
+        }
+    }
+
+    if( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ uxPriorityUsedOnEntry ] ), &( pxTCB->xStateListItem ) ) != pdFALSE )
+    {
+        if( uxListRemove( &( pxTCB->xStateListItem ) ) == ( UBaseType_t ) 0 )
+        {
+            taskRESET_READY_PRIORITY( uxPriorityUsedOnEntry );
+        }
+        prvAddTaskToReadyList( pxTCB );
+
+        /* A ready task raised above the running one, or the running one
+         * lowered, picks up the switch in osalOsRescheduleS() */
+        if( pxTCB == pxCurrentTCB )
+        {
+            if( uxPriority < uxPriorityUsedOnEntry )
+            {
+                xYieldPending = pdTRUE;
+            }
+        }
+        else if( uxPriority > pxCurrentTCB->uxPriority )
+        {
+            xYieldPending = pdTRUE;
+        }
+    }
+}
+
+#endif /* configUSE_MUTEXES */
+
+#if( configUSE_OSAL_MESSAGES == 1 )
+
+/* The OSAL message queue of a task, kept in its TCB rather than in thread
+ * local storage pointers the application may want. */
+void **ppvTaskGetMsgQueue( TaskHandle_t xTask )
+{
+    TCB_t * const pxTCB = prvGetTCBFromHandle( xTask );
+
+    return pxTCB->pvMsgQueue;
+}
+
+#endif /* configUSE_OSAL_MESSAGES */
+
+#if( configGENERATE_RUN_TIME_STATS == 1 )
+
+/* Takes ulRunTime off the run time of the running task, used by the OSAL for
+ * the interrupt handlers that ran on top of it. The task is not switched out
+ * before they return, so its switch in time is simply moved forward. */
+void vTaskRunTimeExcludeFromISR( uint32_t ulRunTime )
+{
+    ulTaskSwitchedInTime += ulRunTime;
+}
+
+#endif /* configGENERATE_RUN_TIME_STATS */
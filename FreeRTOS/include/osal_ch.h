@@ -42,6 +42,9 @@
 /* HAL Compatibility functions */
 UBaseType_t uxYieldPending( void );
 xTaskHandle xGetCurrentTaskHandle( void );
+void vTaskPriorityDonate( TaskHandle_t xTask, UBaseType_t uxPriority );
+void vTaskRunTimeExcludeFromISR( uint32_t ulRunTime );
+void **ppvTaskGetMsgQueue( TaskHandle_t xTask );
 
 #define FALSE false
 #define TRUE true
@@ -69,6 +72,19 @@ xTaskHandle xGetCurrentTaskHandle( void );
 #define MSG_RESET   (msg_t)-2
 #define MSG_EVENT_W (msg_t)-3
 
+/* Threads are woken up through the last task notification, the other ones
+ * are left to the application */
+#if configTASK_NOTIFICATION_ARRAY_ENTRIES < 2
+#error "The OSAL needs configTASK_NOTIFICATION_ARRAY_ENTRIES >= 2"
+#endif
+#define OSAL_NOTIFY_INDEX (configTASK_NOTIFICATION_ARRAY_ENTRIES - 1)
+
+/* Synchronous messages, see osal_ch_msg.c. The senders queued on a thread
+ * are kept in its TCB. */
+#if (configUSE_OSAL_MESSAGES == 1) && (configUSE_MUTEXES != 1)
+#error "OSAL messages need configUSE_MUTEXES for the priority donation"
+#endif
+
 /* Systick rate set by FreeRTOS */
 #define OSAL_ST_FREQUENCY configTICK_RATE_HZ
 
@@ -76,9 +92,19 @@ xTaskHandle xGetCurrentTaskHandle( void );
 /* Thread related */
 typedef TaskHandle_t thread_t;
 typedef thread_t * thread_reference_t;
+
+/* A waiting thread links this node, living on its own stack, into the queue */
+typedef struct threads_queue_node threads_queue_node_t;
+struct threads_queue_node {
+    threads_queue_node_t* next;
+    threads_queue_node_t* prev;
+    thread_reference_t thread;
+};
+
+/* New waiters are inserted at the head, they are woken from the tail */
 typedef struct {
-    thread_t head;
-    thread_t tail;
+    threads_queue_node_t* head;
+    threads_queue_node_t* tail;
 } threads_queue_t;
 
 /* Stores the system state before enterring critical section */
@@ -94,14 +120,20 @@ typedef int32_t msg_t;
 /* Event/Poll related */
 typedef UBaseType_t eventflags_t;
 typedef struct event_repeater event_repeater_t;
+typedef struct event_listener event_listener_t;
 
 typedef struct event_source_s event_source_t;
 
 struct event_source_s {
     event_repeater_t* firstRepeater;
+    event_listener_t* firstListener;
     eventflags_t setEvents;
     thread_reference_t waitThread;
     void (*eventCallback)(event_source_t* source, eventflags_t set);
+    /* Queue of the sources a broadcast still has to handle, see
+       osalEventBroadcastFlagsI() */
+    event_source_t* nextPending;
+    eventflags_t pendingEvents;
 };
 
 typedef struct event_repeater {
@@ -114,6 +146,49 @@ typedef struct event_repeater {
     eventflags_t myEvent;
 } event_repeater_t;
 
+/* Any number of threads can each wait on their own listener of a source */
+struct event_listener {
+    event_listener_t* nextListener;
+    event_listener_t* prevListener;
+    event_source_t* source;
+    thread_reference_t waitThread;
+    eventflags_t setEvents;
+    eventflags_t wakeEvents;
+};
+
+/* Virtual timers, the callback is called from the tick interrupt */
+typedef void (*vtfunc_t)(void* par);
+typedef struct virtual_timer virtual_timer_t;
+
+struct virtual_timer {
+    virtual_timer_t* next;
+    virtual_timer_t* prev;
+    systime_t delta;
+    vtfunc_t func;
+    void* par;
+};
+
+/* Memory pools of fixed size objects, see osal_ch_pools.c */
+typedef void* (*memgetfunc_t)(size_t size, unsigned align);
+typedef struct pool_header pool_header_t;
+
+struct pool_header {
+    pool_header_t* next;
+};
+
+typedef struct {
+    pool_header_t* next;
+    size_t object_size;
+    memgetfunc_t provider;
+} memory_pool_t;
+
+/* Allocating from a guarded pool can wait for an object to be freed */
+typedef struct {
+    memory_pool_t pool;
+    threads_queue_t waiters;
+    size_t free;
+} guarded_memory_pool_t;
+
 /* Mutex type */
 typedef struct {
     SemaphoreHandle_t handle;
@@ -140,6 +215,35 @@ void osalEventRepeaterRegister(event_repeater_t* event_repeater,
                                eventflags_t my_event);
 void osalEventRepeaterUnregister(event_repeater_t* event_repeater);
 void osalEventRegisterCallbackI(event_source_t* source, void (*eventCallback)(event_source_t* source, eventflags_t set));
+void osalEventListenerRegisterS(event_listener_t* event_listener,
+                                event_source_t* event_source,
+                                eventflags_t wake_events);
+void osalEventListenerUnregisterS(event_listener_t* event_listener);
+eventflags_t osalEventListenerWaitTimeoutS(event_listener_t* event_listener, systime_t timeout);
+
+void osalVTSetI(virtual_timer_t* vtp, systime_t delay, vtfunc_t vtfunc, void* par);
+void osalVTResetI(virtual_timer_t* vtp);
+void osalVTDoTickI(void);
+uint32_t osalVTGetIdleTimeX(uint32_t ticks);
+
+void osalPoolObjectInit(memory_pool_t* mp, size_t size, memgetfunc_t provider);
+void osalPoolLoadArray(memory_pool_t* mp, void* p, size_t n);
+void* osalPoolAllocI(memory_pool_t* mp);
+void osalPoolFreeI(memory_pool_t* mp, void* objp);
+void osalGuardedPoolObjectInit(guarded_memory_pool_t* gmp, size_t size);
+void osalGuardedPoolLoadArray(guarded_memory_pool_t* gmp, void* p, size_t n);
+void* osalGuardedPoolAllocI(guarded_memory_pool_t* gmp);
+void* osalGuardedPoolAllocTimeoutS(guarded_memory_pool_t* gmp, systime_t timeout);
+void osalGuardedPoolFreeI(guarded_memory_pool_t* gmp, void* objp);
+
+#if configUSE_OSAL_MESSAGES == 1
+msg_t osalMsgSend(thread_t* tp, msg_t msg);
+thread_t* osalMsgWait(void);
+msg_t osalMsgGet(thread_t* tp);
+void osalMsgReleaseS(thread_t* tp, msg_t msg);
+void osalMsgRelease(thread_t* tp, msg_t msg);
+bool osalMsgIsPendingI(thread_t* tp);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -189,14 +293,125 @@ void osalEventRegisterCallbackI(event_source_t* source, void (*eventCallback)(ev
 #define osalDbgCheckClassS()
 #endif
 
-/* Proxy functions to FreeRTOS */
-#define osalSysDisable vTaskEndScheduler
-#define osalSysEnable vTaskStartScheduler
+/* Critical section profiler: records how long every osalSysLock(),
+ * osalSysLockFromISR() and osalSysGetStatusAndLockX() call site keeps the
+ * interrupts masked, in the unit of portGET_RUN_TIME_COUNTER_VALUE() */
+#ifndef configUSE_CRITICAL_PROFILER
+#define configUSE_CRITICAL_PROFILER 0
+#endif
+
+#if configUSE_CRITICAL_PROFILER == 1
+#if configGENERATE_RUN_TIME_STATS != 1
+#error "configUSE_CRITICAL_PROFILER needs configGENERATE_RUN_TIME_STATS"
+#endif
+
+/* Bucket 0 counts the sections shorter than 2^configCRITICAL_PROFILER_SHIFT,
+ * every next bucket is twice as wide, the last one counts all longer ones */
+#ifndef configCRITICAL_PROFILER_BUCKETS
+#define configCRITICAL_PROFILER_BUCKETS 12
+#endif
+#ifndef configCRITICAL_PROFILER_SHIFT
+#define configCRITICAL_PROFILER_SHIFT 5
+#endif
+
+/* Every call site owns one of these, it is linked in the list when its first
+ * section ends */
+typedef struct osal_prof_site osal_prof_site_t;
+struct osal_prof_site {
+    const char* file;
+    uint32_t line;
+    osal_prof_site_t* next;
+    bool linked;
+    uint32_t count;
+    uint32_t max;
+    uint32_t histogram[configCRITICAL_PROFILER_BUCKETS];
+};
+
+/* The outermost section being timed. Only its owner can touch it, everybody
+ * else is masked out. */
+typedef struct {
+    osal_prof_site_t* site;
+    uint32_t start;
+    UBaseType_t nesting;
+} osal_prof_state_t;
+
+extern osal_prof_state_t osalProfState;
+extern osal_prof_site_t* osalProfSites;
+
+void osalProfRecordX(void);
+void osalProfReset(void);
+
+static inline void osalProfEnterX(osal_prof_site_t* site)
+{
+    if(!osalProfState.nesting++){
+        osalProfState.site = site;
+        osalProfState.start = portGET_RUN_TIME_COUNTER_VALUE();
+    }
+}
+
+static inline void osalProfLeaveX(void)
+{
+    if(!--osalProfState.nesting){
+        osalProfRecordX();
+    }
+}
+
+/* A thread blocking with the lock held lets the others run: its section ends
+ * there and restarts once it runs again, still holding the lock */
+static inline osal_prof_state_t osalProfSuspendX(void)
+{
+    osal_prof_state_t saved = osalProfState;
+    if(saved.nesting){
+        osalProfRecordX();
+        osalProfState.nesting = 0;
+    }
+    return saved;
+}
+
+static inline void osalProfResumeX(const osal_prof_state_t* saved)
+{
+    osalProfState = *saved;
+    osalProfState.start = portGET_RUN_TIME_COUNTER_VALUE();
+}
+
+#define OSAL_PROF_SITE()                                            \
+    static osal_prof_site_t osalProfSite = {__FILE__, __LINE__, NULL, false, 0, 0, {0}}
+#define OSAL_PROF_SUSPEND() osal_prof_state_t osalProfSaved = osalProfSuspendX()
+#define OSAL_PROF_RESUME() osalProfResumeX(&osalProfSaved)
+
+#define osalSysLock() do {                                          \
+    OSAL_PROF_SITE();                                               \
+    taskENTER_CRITICAL();                                           \
+    osalProfEnterX(&osalProfSite);                                  \
+}while(0)
+
+#define osalSysGetStatusAndLockX() ({                               \
+    OSAL_PROF_SITE();                                               \
+    syssts_t osalProfStatus = taskENTER_CRITICAL_FROM_ISR();        \
+    osalProfEnterX(&osalProfSite);                                  \
+    osalProfStatus;                                                 \
+})
+
+#define osalSysRestoreStatusX(state) do {                           \
+    osalProfLeaveX();                                               \
+    taskEXIT_CRITICAL_FROM_ISR(state);                              \
+}while(0)
+
+#else
+
+#define osalProfLeaveX()
+#define OSAL_PROF_SUSPEND()
+#define OSAL_PROF_RESUME()
+
 #define osalSysLock taskENTER_CRITICAL
 #define osalSysGetStatusAndLockX taskENTER_CRITICAL_FROM_ISR
 #define osalSysRestoreStatusX(state) taskEXIT_CRITICAL_FROM_ISR(state)
+#endif
+
+/* Proxy functions to FreeRTOS */
+#define osalSysDisable vTaskEndScheduler
+#define osalSysEnable vTaskStartScheduler
 #define osalOsGetSystemTimeX xTaskGetTickCountFromISR
-#define osalThreadSleepS(time) vTaskDelay(time)
 #define osalThreadSleep(time) vTaskDelay(time)
 
 /* More proxying using simple inline functions */
@@ -205,20 +420,41 @@ extern UBaseType_t uxSavedInterruptStatus;
 static inline void osalOsRescheduleS(void)
 {
     osalDbgCheckClassS();
-    if(uxYieldPending()) taskYIELD();
+    if(uxYieldPending()){
+        OSAL_PROF_SUSPEND();
+        taskYIELD();
+        OSAL_PROF_RESUME();
+    }
+}
+
+static inline void osalThreadSleepS(systime_t time)
+{
+    OSAL_PROF_SUSPEND();
+    vTaskDelay(time);
+    OSAL_PROF_RESUME();
 }
 
+#if configUSE_CRITICAL_PROFILER == 1
+#define osalSysLockFromISR() do {                                   \
+    OSAL_PROF_SITE();                                               \
+    uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();         \
+    osalProfEnterX(&osalProfSite);                                  \
+}while(0)
+#else
 static inline void osalSysLockFromISR(void)
 {
     uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
 }
+#endif
 
 static inline void osalSysUnlockFromISR(void)
 {
+    osalProfLeaveX();
     taskEXIT_CRITICAL_FROM_ISR(uxSavedInterruptStatus);
 }
 
 static inline void osalSysUnlock(void){
+    osalProfLeaveX();
     osalOsRescheduleS();
     taskEXIT_CRITICAL();
 }
@@ -238,6 +474,12 @@ static inline eventflags_t osalEventRepeaterGetS(event_repeater_t* event_repeate
     return flags;
 }
 
+static inline eventflags_t osalEventListenerGetS(event_listener_t* event_listener){
+    eventflags_t flags = event_listener->setEvents;
+    event_listener->setEvents = 0;
+    return flags;
+}
+
 static inline void osalMutexLock(mutex_t* mutex)
 {
     osalDbgCheck(mutex != NULL);
@@ -254,7 +496,7 @@ static inline void osalThreadResumeI(thread_reference_t* thread_reference, msg_t
 {
     osalDbgCheckClassI();
     if(*thread_reference) {
-        xTaskNotifyFromISR( *thread_reference, msg, eSetValueWithOverwrite, NULL );
+        xTaskNotifyIndexedFromISR( *thread_reference, OSAL_NOTIFY_INDEX, msg, eSetValueWithOverwrite, NULL );
         *thread_reference = NULL;
     }
 }
@@ -263,7 +505,7 @@ static inline void osalThreadResumeS(thread_reference_t* thread_reference, msg_t
 {
     osalDbgCheckClassS();
     if(*thread_reference) {
-        xTaskNotify( *thread_reference, msg, eSetValueWithOverwrite );
+        xTaskNotifyIndexed( *thread_reference, OSAL_NOTIFY_INDEX, msg, eSetValueWithOverwrite );
         *thread_reference = NULL;
     }
 }
@@ -273,7 +515,85 @@ static inline void osalSysPolledDelayX(rtcnt_t cycles)
     vPortBusyDelay(cycles);
 }
 
+static inline bool osalVTIsArmedI(virtual_timer_t* vtp)
+{
+    osalDbgCheckClassI();
+    return vtp->func != NULL;
+}
+
+static inline void osalVTSet(virtual_timer_t* vtp, systime_t delay, vtfunc_t vtfunc, void* par)
+{
+    osalSysLock();
+    osalVTSetI(vtp, delay, vtfunc, par);
+    osalSysUnlock();
+}
+
+static inline void osalVTReset(virtual_timer_t* vtp)
+{
+    osalSysLock();
+    osalVTResetI(vtp);
+    osalSysUnlock();
+}
+
+static inline void* osalPoolAlloc(memory_pool_t* mp)
+{
+    osalSysLock();
+    void* objp = osalPoolAllocI(mp);
+    osalSysUnlock();
+
+    return objp;
+}
+
+static inline void osalPoolFree(memory_pool_t* mp, void* objp)
+{
+    osalSysLock();
+    osalPoolFreeI(mp, objp);
+    osalSysUnlock();
+}
+
+static inline void osalPoolAddI(memory_pool_t* mp, void* objp)
+{
+    osalPoolFreeI(mp, objp);
+}
+
+static inline void osalPoolAdd(memory_pool_t* mp, void* objp)
+{
+    osalPoolFree(mp, objp);
+}
+
+static inline void* osalGuardedPoolAllocTimeout(guarded_memory_pool_t* gmp, systime_t timeout)
+{
+    osalSysLock();
+    void* objp = osalGuardedPoolAllocTimeoutS(gmp, timeout);
+    osalSysUnlock();
+
+    return objp;
+}
+
+static inline void osalGuardedPoolFree(guarded_memory_pool_t* gmp, void* objp)
+{
+    osalSysLock();
+    osalGuardedPoolFreeI(gmp, objp);
+    osalSysUnlock();
+}
+
+static inline void osalGuardedPoolAddI(guarded_memory_pool_t* gmp, void* objp)
+{
+    osalGuardedPoolFreeI(gmp, objp);
+}
+
+static inline void osalGuardedPoolAdd(guarded_memory_pool_t* gmp, void* objp)
+{
+    osalGuardedPoolFree(gmp, objp);
+}
+
 /* Init objects */
+static inline void osalVTObjectInit(virtual_timer_t* vtp)
+{
+    osalDbgCheck(vtp != NULL);
+    vtp->func = NULL;
+}
+
 static inline void osalThreadQueueObjectInit(threads_queue_t* thread_queue)
 {
     osalDbgCheck(thread_queue != NULL);
@@ -292,19 +612,58 @@ static inline void osalEventObjectInit(event_source_t* event_source)
     osalDbgCheck(event_source != NULL);
     event_source->setEvents = 0;
     event_source->firstRepeater = NULL;
+    event_source->firstListener = NULL;
     event_source->waitThread = NULL;
+    event_source->eventCallback = NULL;
+    event_source->nextPending = NULL;
+    event_source->pendingEvents = 0;
 }
 
+#if configGENERATE_RUN_TIME_STATS == 1
+/* Run time spent in the interrupt handlers using these macros, in the unit of
+ * portGET_RUN_TIME_COUNTER_VALUE(). Nested handlers are counted once, and
+ * not in the run time of the task they interrupted. */
+extern volatile uint32_t osalIrqRunTime;
+extern uint32_t osalIrqEnterTime;
+extern UBaseType_t osalIrqNesting;
+
+static inline void osalIrqEnterX(void)
+{
+    if(!osalIrqNesting++){
+        osalIrqEnterTime = portGET_RUN_TIME_COUNTER_VALUE();
+    }
+}
+
+static inline void osalIrqLeaveX(void)
+{
+    if(!--osalIrqNesting){
+        uint32_t elapsed = portGET_RUN_TIME_COUNTER_VALUE() - osalIrqEnterTime;
+
+        osalIrqRunTime += elapsed;
+        vTaskRunTimeExcludeFromISR(elapsed);
+    }
+}
+
+#define OSAL_IRQ_PROLOGUE() osalIrqEnterX()
+#else
 #define OSAL_IRQ_PROLOGUE()
+#define osalIrqLeaveX()
+#endif
 /* At the end of the interrupt handler we need to check if we need
  * to yield */
 #define OSAL_IRQ_EPILOGUE() {                  \
+    osalIrqLeaveX();                           \
     portYIELD_FROM_ISR(uxYieldPending());      \
 }
 #define OSAL_IRQ_HANDLER(handleName) void handleName(void)
 
-/* Macros converting real time to systicks */
+/* Macros converting real time to systicks, a high resolution timebase runs
+ * at rates where 32 bits would overflow for timeouts of a few seconds */
+#if configUSE_HIGH_RES_TIMEBASE == 1
+typedef uint64_t conv_t;
+#else
 typedef uint32_t conv_t;
+#endif
 #define OSAL_T2ST(r, t, hz, div) ((r)(((conv_t)(hz) * (conv_t)(t) + (conv_t)(div-1)) / (conv_t)(div)))
 
 #define OSAL_US2ST(t) OSAL_T2ST(systime_t, t, configTICK_RATE_HZ, 1000000)
@@ -338,9 +697,44 @@ static inline void osalInit(void)
 /* Some code in ChibiOS seems to call the kernel directly instead of using the osal */
 #define chSysLock osalSysLock
 #define chSysUnock osalSysUnlock
+#define chSysLockFromISR osalSysLockFromISR
+#define chSysUnlockFromISR osalSysUnlockFromISR
 #define chEvtObjectInit osalEventObjectInit
 #define chVTGetSystemTime osalOsGetSystemTimeX
 #define chCoreGetStatusX xPortGetFreeHeapSize
+#define chVTObjectInit osalVTObjectInit
+#define chVTIsArmedI osalVTIsArmedI
+#define chVTDoSetI osalVTSetI
+#define chVTSetI osalVTSetI
+#define chVTSet osalVTSet
+#define chVTDoResetI osalVTResetI
+#define chVTResetI osalVTResetI
+#define chVTReset osalVTReset
+#define chPoolObjectInit osalPoolObjectInit
+#define chPoolLoadArray osalPoolLoadArray
+#define chPoolAllocI osalPoolAllocI
+#define chPoolAlloc osalPoolAlloc
+#define chPoolFreeI osalPoolFreeI
+#define chPoolFree osalPoolFree
+#define chPoolAddI osalPoolAddI
+#define chPoolAdd osalPoolAdd
+#define chGuardedPoolObjectInit osalGuardedPoolObjectInit
+#define chGuardedPoolLoadArray osalGuardedPoolLoadArray
+#define chGuardedPoolAllocI osalGuardedPoolAllocI
+#define chGuardedPoolAllocTimeoutS osalGuardedPoolAllocTimeoutS
+#define chGuardedPoolAllocTimeout osalGuardedPoolAllocTimeout
+#define chGuardedPoolFreeI osalGuardedPoolFreeI
+#define chGuardedPoolFree osalGuardedPoolFree
+#define chGuardedPoolAddI osalGuardedPoolAddI
+#define chGuardedPoolAdd osalGuardedPoolAdd
+#if configUSE_OSAL_MESSAGES == 1
+#define chMsgSend osalMsgSend
+#define chMsgWait osalMsgWait
+#define chMsgGet osalMsgGet
+#define chMsgReleaseS osalMsgReleaseS
+#define chMsgRelease osalMsgRelease
+#define chMsgIsPendingI osalMsgIsPendingI
+#endif
 static inline void chThdExitS(msg_t msg){
     (void)msg;
 
@@ -355,6 +749,13 @@ static inline void chEvtBroadcastI(event_source_t* event_source){
 #define CH_KERNEL_VERSION "FreeRTOS v10"
 #define CH_CFG_USE_MEMCORE TRUE
 #define CH_CFG_USE_HEAP TRUE
+#define CH_CFG_USE_EVENTS TRUE
+#define CH_CFG_USE_MEMPOOLS TRUE
+#if configUSE_OSAL_MESSAGES == 1
+#define CH_CFG_USE_MESSAGES TRUE
+#else
+#define CH_CFG_USE_MESSAGES FALSE
+#endif
 #endif
 
 size_t chHeapStatus  (void* ignore, size_t* memFree, size_t* largestBlock);
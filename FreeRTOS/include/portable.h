@@ -85,6 +85,48 @@ must be set in the compiler's include path. */
 	#define portNUM_CONFIGURABLE_REGIONS 1
 #endif
 
+#if( configUSE_PORT_OPTIMISED_TASK_SELECTION == 1 )
+
+	/* Highest bit set in a non zero ready priorities bit map, for the ports
+	that have no count leading zeros instruction (ARMv6-M).  The bits below
+	the highest one are set first, which leaves 2^(n+1)-1 for a highest bit n.
+	The product of that value by the de Bruijn sequence 0x07C4ACDD has a
+	different value for each n in its top five bits.  The bits are only
+	propagated over the range configMAX_PRIORITIES covers. */
+	portFORCE_INLINE static UBaseType_t uxPortGetHighestPriority( uint32_t ulReadyPriorities )
+	{
+	static const uint8_t ucHighestBit[ 32 ] =
+	{
+		0U, 9U, 1U, 10U, 13U, 21U, 2U, 29U, 11U, 14U, 16U, 18U, 22U, 25U, 3U, 30U,
+		8U, 12U, 20U, 28U, 15U, 17U, 24U, 7U, 19U, 27U, 23U, 6U, 26U, 5U, 4U, 31U
+	};
+
+		ulReadyPriorities |= ulReadyPriorities >> 1;
+		ulReadyPriorities |= ulReadyPriorities >> 2;
+
+		#if( configMAX_PRIORITIES > 4 )
+		{
+			ulReadyPriorities |= ulReadyPriorities >> 4;
+		}
+		#endif
+
+		#if( configMAX_PRIORITIES > 8 )
+		{
+			ulReadyPriorities |= ulReadyPriorities >> 8;
+		}
+		#endif
+
+		#if( configMAX_PRIORITIES > 16 )
+		{
+			ulReadyPriorities |= ulReadyPriorities >> 16;
+		}
+		#endif
+
+		return ( UBaseType_t ) ucHighestBit[ ( uint32_t ) ( ulReadyPriorities * 0x07C4ACDDUL ) >> 27 ];
+	}
+
+#endif /* configUSE_PORT_OPTIMISED_TASK_SELECTION */
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -30,9 +30,6 @@
 
 /* In this file there are slightly more complicated functions */
 
-#define LOCAL_STORAGE_QUEUE_NEXT 0 
-#define LOCAL_STORAGE_QUEUE_PREV 1
-
 msg_t osalThreadEnqueueTimeoutS(threads_queue_t* thread_queue, systime_t timeout)
 {
     if(!timeout) {
@@ -42,36 +39,40 @@ msg_t osalThreadEnqueueTimeoutS(threads_queue_t* thread_queue, systime_t timeout
     osalDbgCheck(thread_queue != NULL);
     osalDbgCheckClassS();
 
-    thread_t currentTask = xGetCurrentTaskHandle();
-   
+    threads_queue_node_t node;
+    node.thread = xGetCurrentTaskHandle();
+
     /* Insert in the front */
-    vTaskSetThreadLocalStoragePointer(currentTask, LOCAL_STORAGE_QUEUE_NEXT, thread_queue->head);
-    vTaskSetThreadLocalStoragePointer(currentTask, LOCAL_STORAGE_QUEUE_PREV, NULL);
+    node.next = thread_queue->head;
+    node.prev = NULL;
 
     if(thread_queue->head){
-        vTaskSetThreadLocalStoragePointer(thread_queue->head, LOCAL_STORAGE_QUEUE_PREV, currentTask);
+        thread_queue->head->prev = &node;
     }
-    thread_queue->head = currentTask;
+    thread_queue->head = &node;
     if(!thread_queue->tail){
-        thread_queue->tail = currentTask;
+        thread_queue->tail = &node;
     }
 
     msg_t msg = osalThreadSuspendTimeoutS(NULL, timeout);
-    
-    /* Remove from the queue in case of timeout */
-    if(msg == MSG_TIMEOUT) {
-        thread_t nextTask = pvTaskGetThreadLocalStoragePointer(currentTask, LOCAL_STORAGE_QUEUE_NEXT);
-        thread_t prevTask = pvTaskGetThreadLocalStoragePointer(currentTask, LOCAL_STORAGE_QUEUE_PREV);
 
-        if(nextTask){
-            vTaskSetThreadLocalStoragePointer(nextTask, LOCAL_STORAGE_QUEUE_PREV, prevTask);
-        }else{
-            thread_queue->tail = prevTask;
-        }
-        if(prevTask){
-            vTaskSetThreadLocalStoragePointer(prevTask, LOCAL_STORAGE_QUEUE_NEXT, nextTask);
+    if(msg == MSG_TIMEOUT) {
+        if(node.thread){
+            /* Still queued, unlink ourself */
+            if(node.next){
+                node.next->prev = node.prev;
+            }else{
+                thread_queue->tail = node.prev;
+            }
+            if(node.prev){
+                node.prev->next = node.next;
+            }else{
+                thread_queue->head = node.next;
+            }
         }else{
-            thread_queue->head = nextTask;
+            /* We were dequeued after the timeout expired, but before we could run.
+             * Consume the notification, it would wake up the next wait otherwise. */
+            xTaskNotifyWaitIndexed(OSAL_NOTIFY_INDEX, UINT32_MAX, UINT32_MAX, (uint32_t*)&msg, 0);
         }
     }
 
@@ -79,23 +80,23 @@ msg_t osalThreadEnqueueTimeoutS(threads_queue_t* thread_queue, systime_t timeout
 }
 
 static bool osalThreadDequeueI(threads_queue_t* thread_queue, msg_t msg){
-    if(!thread_queue->tail){
+    threads_queue_node_t* node = thread_queue->tail;
+
+    if(!node){
         return false;
     }
 
-    thread_reference_t toWakeUp = thread_queue->tail;
-
-    /* Lookup the last task, and pop it */
-    thread_t prevTask = pvTaskGetThreadLocalStoragePointer(toWakeUp, LOCAL_STORAGE_QUEUE_PREV);
-    if(prevTask){
-        vTaskSetThreadLocalStoragePointer(prevTask, LOCAL_STORAGE_QUEUE_NEXT, NULL);
+    /* Pop the oldest waiter */
+    thread_queue->tail = node->prev;
+    if(node->prev){
+        node->prev->next = NULL;
     }else{
         thread_queue->head = NULL;
     }
-    thread_queue->tail = prevTask;
-   
-    /* Resume it */
-    osalThreadResumeI(&toWakeUp, msg);
+
+    /* Resume it, this clears node->thread, marking it as dequeued. The node
+     * must not be touched afterwards, it lives on the stack of the waiter. */
+    osalThreadResumeI(&node->thread, msg);
 
     return true;
 }
@@ -124,6 +125,7 @@ msg_t osalThreadSuspendS(thread_reference_t* thread_reference)
 msg_t osalThreadSuspendTimeoutS(thread_reference_t* thread_reference, systime_t timeout)
 {
     msg_t ulInterruptStatus;
+    BaseType_t notified;
     osalDbgCheckClassS();
 
     if(!timeout) {
@@ -134,7 +136,11 @@ msg_t osalThreadSuspendTimeoutS(thread_reference_t* thread_reference, systime_t
         *thread_reference = xGetCurrentTaskHandle();
     }
 
-    if(!xTaskNotifyWait(ULONG_MAX, ULONG_MAX, (uint32_t*)&ulInterruptStatus, timeout )) {
+    OSAL_PROF_SUSPEND();
+    notified = xTaskNotifyWaitIndexed(OSAL_NOTIFY_INDEX, UINT32_MAX, UINT32_MAX, (uint32_t*)&ulInterruptStatus, timeout );
+    OSAL_PROF_RESUME();
+
+    if(!notified) {
         if(thread_reference) {
             *thread_reference = NULL;
         }
@@ -158,11 +164,31 @@ eventflags_t osalEventWaitTimeoutS(event_source_t* event_source, systime_t timeo
     return result;
 }
 
-void osalEventBroadcastFlagsI(event_source_t* event_source, eventflags_t set)
+/* Sources a broadcast still has to handle. A source is queued while its
+   nextPending is not NULL, the last one points to itself */
+typedef struct {
+    event_source_t* head;
+    event_source_t* tail;
+} event_queue_t;
+
+static void osalEventQueueI(event_queue_t* queue, event_source_t* event_source, eventflags_t set)
 {
-    osalDbgCheck(event_source != NULL);
-    osalDbgCheckClassI();
+    event_source->pendingEvents |= set;
+    if(event_source->nextPending){
+        return;
+    }
+
+    event_source->nextPending = event_source;
+    if(queue->tail){
+        queue->tail->nextPending = event_source;
+    }else{
+        queue->head = event_source;
+    }
+    queue->tail = event_source;
+}
 
+static void osalEventSourceBroadcastI(event_queue_t* queue, event_source_t* event_source, eventflags_t set)
+{
     event_source->setEvents |= set;
     eventflags_t localEvents = event_source->setEvents;
 
@@ -170,23 +196,72 @@ void osalEventBroadcastFlagsI(event_source_t* event_source, eventflags_t set)
         event_source->eventCallback(event_source, localEvents);
     }
 
-    /* Any repeaters? */
+    /* Any repeaters? Their targets are queued, not broadcast from here */
     event_repeater_t* repeater = event_source->firstRepeater;
     while(repeater){
         if(localEvents & repeater->triggerEvents){
             repeater->setEvents |= localEvents;
-            osalEventBroadcastFlagsI(repeater->target, repeater->myEvent);
+            osalEventQueueI(queue, repeater->target, repeater->myEvent);
+
+            /* Events passed on to a repeater are consumed by it, they do not
+               also wake the thread waiting on the source */
+            event_source->setEvents &=~ repeater->triggerEvents;
         }
-        event_source->setEvents &=~ repeater->triggerEvents;
         repeater = repeater->nextRepeater;
     }
-   
+
+    /* Listeners get the new events, a single pass without recursion */
+    if(set){
+        event_listener_t* listener = event_source->firstListener;
+        while(listener){
+            listener->setEvents |= set;
+            if(set & listener->wakeEvents){
+                osalThreadResumeI(&listener->waitThread, MSG_EVENT_W);
+            }
+            listener = listener->nextListener;
+        }
+    }
+
     /* Wake up any waiting threads that may be waiting on remaining events */
     if(event_source->setEvents){
         osalThreadResumeI(&event_source->waitThread, MSG_EVENT_W);
     }
 }
 
+/* The sources fired by repeaters are queued and handled one after the other,
+   so the stack use does not depend on the length of the repeater chains. A
+   source fired again while it is still queued is handled once with all the
+   events. Chains of repeaters must not loop back to a source. */
+void osalEventBroadcastFlagsI(event_source_t* event_source, eventflags_t set)
+{
+    event_queue_t queue = {NULL, NULL};
+    osalDbgCheck(event_source != NULL);
+    osalDbgCheckClassI();
+
+    /* From an event callback, a source that is already queued only gets the
+       events added, the outer broadcast handles it */
+    if(event_source->nextPending){
+        event_source->pendingEvents |= set;
+        return;
+    }
+
+    osalEventQueueI(&queue, event_source, set);
+    while(queue.head){
+        event_source = queue.head;
+        queue.head = (event_source->nextPending == event_source) ? NULL : event_source->nextPending;
+        if(!queue.head){
+            queue.tail = NULL;
+        }
+
+        /* Out of the queue before its repeaters can queue it again */
+        set = event_source->pendingEvents;
+        event_source->pendingEvents = 0;
+        event_source->nextPending = NULL;
+
+        osalEventSourceBroadcastI(&queue, event_source, set);
+    }
+}
+
 void osalEventRegisterCallbackI(event_source_t* source, void (*eventCallback)(event_source_t* source, eventflags_t set)){
     osalDbgCheck(source != NULL);
     osalDbgCheckClassI();
@@ -241,4 +316,61 @@ void osalEventRepeaterUnregister(event_repeater_t* event_repeater){
     event_repeater->prevRepeater->nextRepeater = event_repeater->nextRepeater;
 }
 
+void osalEventListenerRegisterS(event_listener_t* event_listener,
+                                event_source_t* event_source,
+                                eventflags_t wake_events){
+    osalDbgCheck(event_source != NULL);
+    osalDbgCheck(event_listener != NULL);
+    osalDbgCheckClassS();
+
+    /* Initialize the structure */
+    event_listener->source = event_source;
+    event_listener->waitThread = NULL;
+    event_listener->setEvents = 0;
+    event_listener->wakeEvents = wake_events;
+
+    /* Insert at the beginning */
+    event_listener->nextListener = event_source->firstListener;
+    event_listener->prevListener = NULL;
+    if(event_source->firstListener){
+        event_source->firstListener->prevListener = event_listener;
+    }
+    event_source->firstListener = event_listener;
+}
+
+void osalEventListenerUnregisterS(event_listener_t* event_listener){
+    osalDbgCheck(event_listener != NULL);
+    osalDbgCheckClassS();
+
+    if(event_listener->nextListener){
+        event_listener->nextListener->prevListener = event_listener->prevListener;
+    }
+    if(event_listener->prevListener){
+        event_listener->prevListener->nextListener = event_listener->nextListener;
+    }else{
+        event_listener->source->firstListener = event_listener->nextListener;
+    }
+
+    /* Somebody may still be waiting on it */
+    osalThreadResumeI(&event_listener->waitThread, MSG_RESET);
+}
+
+eventflags_t osalEventListenerWaitTimeoutS(event_listener_t* event_listener, systime_t timeout){
+    osalDbgCheck(event_listener != NULL);
+    osalDbgCheckClassS();
+
+    /* Only block if none of the wake up events are pending */
+    if(!(event_listener->setEvents & event_listener->wakeEvents)){
+        osalThreadSuspendTimeoutS(&event_listener->waitThread, timeout);
+    }
+
+    return osalEventListenerGetS(event_listener);
+}
+
 UBaseType_t uxSavedInterruptStatus;
+
+#if configGENERATE_RUN_TIME_STATS == 1
+volatile uint32_t osalIrqRunTime;
+uint32_t osalIrqEnterTime;
+UBaseType_t osalIrqNesting;
+#endif
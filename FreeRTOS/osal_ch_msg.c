@@ -0,0 +1,211 @@
+/*
+ * OSAL_CH v0.1.0
+ * Copyright (C) 2017 Bertold Van den Bergh.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software. If you wish to use our Amazon
+ * FreeRTOS name, please do so in a fair use way that does not cause confusion.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+
+#include "osal_ch.h"
+
+#if configUSE_OSAL_MESSAGES == 1
+
+/*
+ * Synchronous messages. A sender links a node, living on its own stack, in the
+ * queue of the server and sleeps until the server releases it with the reply.
+ * The server reads the message in place, nothing is copied, and it runs at the
+ * priority of the highest sender it has queued or is serving. A request costs
+ * one switch to the server and one back.
+ *
+ * The queue is sorted by priority, the nodes being served stay in it until they
+ * are released, so its head gives the priority to donate, and the server finds
+ * the node of a sender there. Like for the mutex inheritance, giving back the
+ * last mutex while serving drops the donation.
+ *
+ * The TCB of the server keeps the head of the queue, and a marker while the
+ * server waits for a message.
+ */
+
+typedef struct msg_node msg_node_t;
+struct msg_node {
+    msg_node_t* next;
+    thread_t* sender;
+    msg_t msg;
+    UBaseType_t priority;
+    bool taken;
+};
+
+#define OSAL_MSG_HEAD 0
+#define OSAL_MSG_WAIT 1
+
+/* Stored in the TCB by a server waiting for a message */
+static uint8_t osalMsgWaiting;
+#define OSAL_MSG_WAITING ((void*)&osalMsgWaiting)
+
+static inline msg_node_t* osalMsgNextX(void** queue)
+{
+    msg_node_t* node = queue[OSAL_MSG_HEAD];
+
+    while(node && node->taken){
+        node = node->next;
+    }
+
+    return node;
+}
+
+static inline msg_node_t* osalMsgServedX(void** queue, thread_t* tp)
+{
+    msg_node_t* node = queue[OSAL_MSG_HEAD];
+
+    while(node && !(node->taken && node->sender == tp)){
+        node = node->next;
+    }
+
+    return node;
+}
+
+static void osalMsgDonateS(thread_t* tp, void** queue)
+{
+    msg_node_t* head = queue[OSAL_MSG_HEAD];
+
+    vTaskPriorityDonate(tp, head ? head->priority : tskIDLE_PRIORITY);
+}
+
+msg_t osalMsgSend(thread_t* tp, msg_t msg)
+{
+    msg_node_t node;
+    msg_node_t* prev;
+    void** queue;
+
+    osalDbgCheck(tp != NULL);
+
+    osalSysLock();
+
+    node.sender = xGetCurrentTaskHandle();
+    node.msg = msg;
+    node.priority = uxTaskPriorityGet(NULL);
+    node.taken = false;
+    osalDbgAssert(tp != node.sender, "sending to self");
+
+    /* Behind the senders of the same or a higher priority */
+    queue = ppvTaskGetMsgQueue(tp);
+    prev = queue[OSAL_MSG_HEAD];
+    if(!prev || prev->priority < node.priority){
+        node.next = prev;
+        queue[OSAL_MSG_HEAD] = &node;
+    }else{
+        while(prev->next && prev->next->priority >= node.priority){
+            prev = prev->next;
+        }
+        node.next = prev->next;
+        prev->next = &node;
+    }
+
+    osalMsgDonateS(tp, queue);
+
+    if(queue[OSAL_MSG_WAIT] == OSAL_MSG_WAITING){
+        thread_reference_t server = tp;
+
+        queue[OSAL_MSG_WAIT] = NULL;
+        osalThreadResumeS(&server, MSG_OK);
+    }
+
+    /* The server runs with our priority, this is the only switch */
+    msg = osalThreadSuspendS(NULL);
+
+    osalSysUnlock();
+
+    return msg;
+}
+
+thread_t* osalMsgWait(void)
+{
+    msg_node_t* node;
+    void** queue;
+
+    osalSysLock();
+
+    queue = ppvTaskGetMsgQueue(NULL);
+    while(!(node = osalMsgNextX(queue))){
+        queue[OSAL_MSG_WAIT] = OSAL_MSG_WAITING;
+        osalThreadSuspendS(NULL);
+    }
+    node->taken = true;
+
+    osalSysUnlock();
+
+    return node->sender;
+}
+
+msg_t osalMsgGet(thread_t* tp)
+{
+    msg_node_t* node = osalMsgServedX(ppvTaskGetMsgQueue(NULL), tp);
+
+    osalDbgAssert(node != NULL, "not being served");
+
+    return node->msg;
+}
+
+void osalMsgReleaseS(thread_t* tp, msg_t msg)
+{
+    void** queue = ppvTaskGetMsgQueue(NULL);
+    msg_node_t* node = queue[OSAL_MSG_HEAD];
+    msg_node_t* prev = NULL;
+    thread_reference_t sender = tp;
+
+    osalDbgCheckClassS();
+
+    while(node && !(node->taken && node->sender == tp)){
+        prev = node;
+        node = node->next;
+    }
+    osalDbgAssert(node != NULL, "not being served");
+
+    if(!prev){
+        queue[OSAL_MSG_HEAD] = node->next;
+    }else{
+        prev->next = node->next;
+    }
+
+    /* Back to the priority of the remaining senders, before the reply lets
+     * this one run. The node must not be touched afterwards. */
+    osalMsgDonateS(NULL, queue);
+    osalThreadResumeS(&sender, msg);
+}
+
+void osalMsgRelease(thread_t* tp, msg_t msg)
+{
+    osalSysLock();
+    osalMsgReleaseS(tp, msg);
+    osalSysUnlock();
+}
+
+bool osalMsgIsPendingI(thread_t* tp)
+{
+    osalDbgCheckClassI();
+
+    return osalMsgNextX(ppvTaskGetMsgQueue(tp)) != NULL;
+}
+
+#endif
@@ -0,0 +1,155 @@
+/*
+ * OSAL_CH v0.1.0
+ * Copyright (C) 2017 Bertold Van den Bergh.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software. If you wish to use our Amazon
+ * FreeRTOS name, please do so in a fair use way that does not cause confusion.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+
+#include "osal_ch.h"
+
+/*
+ * Memory pools of fixed size objects. The free objects are linked through
+ * their first word, so allocating and freeing is a push or pop on that list
+ * and can be done from interrupts.
+ */
+
+void osalPoolObjectInit(memory_pool_t* mp, size_t size, memgetfunc_t provider)
+{
+    osalDbgCheck(mp != NULL);
+    osalDbgCheck(size >= sizeof(pool_header_t));
+    osalDbgCheck((size % sizeof(void*)) == 0);
+
+    mp->next = NULL;
+    mp->object_size = size;
+    mp->provider = provider;
+}
+
+void osalPoolLoadArray(memory_pool_t* mp, void* p, size_t n)
+{
+    osalDbgCheck(mp != NULL);
+
+    while(n){
+        osalPoolAdd(mp, p);
+        p = (uint8_t*)p + mp->object_size;
+        n--;
+    }
+}
+
+void* osalPoolAllocI(memory_pool_t* mp)
+{
+    osalDbgCheckClassI();
+    osalDbgCheck(mp != NULL);
+
+    pool_header_t* objp = mp->next;
+    if(objp){
+        mp->next = objp->next;
+    }else if(mp->provider){
+        /* The provider has to be callable from a critical section */
+        objp = mp->provider(mp->object_size, sizeof(void*));
+    }
+
+    return objp;
+}
+
+void osalPoolFreeI(memory_pool_t* mp, void* objp)
+{
+    osalDbgCheckClassI();
+    osalDbgCheck((mp != NULL) && (objp != NULL));
+
+    pool_header_t* php = objp;
+    php->next = mp->next;
+    mp->next = php;
+}
+
+/*
+ * Guarded pools count their free objects like a semaphore. A thread waiting
+ * for an object is woken by the free that made one available and the object
+ * stays reserved for it, an interrupt can not take it in the meantime.
+ */
+
+void osalGuardedPoolObjectInit(guarded_memory_pool_t* gmp, size_t size)
+{
+    osalDbgCheck(gmp != NULL);
+
+    osalPoolObjectInit(&gmp->pool, size, NULL);
+    osalThreadQueueObjectInit(&gmp->waiters);
+    gmp->free = 0;
+}
+
+void osalGuardedPoolLoadArray(guarded_memory_pool_t* gmp, void* p, size_t n)
+{
+    osalDbgCheck(gmp != NULL);
+
+    while(n){
+        osalGuardedPoolAdd(gmp, p);
+        p = (uint8_t*)p + gmp->pool.object_size;
+        n--;
+    }
+}
+
+void* osalGuardedPoolAllocI(guarded_memory_pool_t* gmp)
+{
+    osalDbgCheckClassI();
+    osalDbgCheck(gmp != NULL);
+
+    if(!gmp->free){
+        return NULL;
+    }
+
+    gmp->free--;
+    return osalPoolAllocI(&gmp->pool);
+}
+
+void* osalGuardedPoolAllocTimeoutS(guarded_memory_pool_t* gmp, systime_t timeout)
+{
+    osalDbgCheckClassS();
+    osalDbgCheck(gmp != NULL);
+
+    if(gmp->free){
+        gmp->free--;
+        return osalPoolAllocI(&gmp->pool);
+    }
+
+    /* Wait for osalGuardedPoolFreeI() to hand us an object */
+    if(osalThreadEnqueueTimeoutS(&gmp->waiters, timeout) != MSG_OK){
+        return NULL;
+    }
+
+    return osalPoolAllocI(&gmp->pool);
+}
+
+void osalGuardedPoolFreeI(guarded_memory_pool_t* gmp, void* objp)
+{
+    osalDbgCheckClassI();
+    osalDbgCheck(gmp != NULL);
+
+    osalPoolFreeI(&gmp->pool, objp);
+
+    if(gmp->waiters.tail){
+        osalThreadDequeueNextI(&gmp->waiters, MSG_OK);
+    }else{
+        gmp->free++;
+    }
+}
@@ -0,0 +1,87 @@
+/*
+ * OSAL_CH v0.1.0
+ * Copyright (C) 2017 Bertold Van den Bergh.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software. If you wish to use our Amazon
+ * FreeRTOS name, please do so in a fair use way that does not cause confusion.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+
+#include "osal_ch.h"
+
+#if configUSE_CRITICAL_PROFILER == 1
+
+/*
+ * Critical section profiler. Each call site of the lock functions owns a
+ * static osal_prof_site_t, the outermost section is timed and accounted to the
+ * site that started it. Sites are linked in osalProfSites, newest first.
+ */
+
+osal_prof_state_t osalProfState;
+osal_prof_site_t* osalProfSites;
+
+void osalProfRecordX(void)
+{
+    osal_prof_site_t* site = osalProfState.site;
+    uint32_t held = portGET_RUN_TIME_COUNTER_VALUE() - osalProfState.start;
+    uint32_t range = held >> configCRITICAL_PROFILER_SHIFT;
+    uint32_t bucket = 0;
+
+    if(range){
+        bucket = 32 - __builtin_clz(range);
+        if(bucket >= configCRITICAL_PROFILER_BUCKETS){
+            bucket = configCRITICAL_PROFILER_BUCKETS - 1;
+        }
+    }
+
+    if(!site->linked){
+        site->linked = true;
+        site->next = osalProfSites;
+        osalProfSites = site;
+    }
+
+    site->count++;
+    if(held > site->max){
+        site->max = held;
+    }
+    site->histogram[bucket]++;
+}
+
+void osalProfReset(void)
+{
+    osal_prof_site_t* site;
+    UBaseType_t i;
+
+    /* One short section per site, sites are never unlinked */
+    for(site = osalProfSites; site; site = site->next){
+        taskENTER_CRITICAL();
+        site->count = 0;
+        site->max = 0;
+        for(i = 0; i < configCRITICAL_PROFILER_BUCKETS; i++){
+            site->histogram[i] = 0;
+        }
+        taskEXIT_CRITICAL();
+    }
+}
+
+#endif
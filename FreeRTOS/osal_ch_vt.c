@@ -0,0 +1,159 @@
+/*
+ * OSAL_CH v0.1.0
+ * Copyright (C) 2017 Bertold Van den Bergh.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software. If you wish to use our Amazon
+ * FreeRTOS name, please do so in a fair use way that does not cause confusion.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#include "osal_ch.h"
+
+/* Virtual timers, kept in a delta list and fired from the tick hook.
+ * No timer task is involved, so the callbacks run in interrupt context. */
+
+/* The list header doubles as the end marker, its layout matches the start
+ * of virtual_timer_t. The deltas are relative to baseTime. */
+static struct {
+    virtual_timer_t* next;
+    virtual_timer_t* prev;
+    systime_t delta;
+    systime_t baseTime;
+} vtList = {
+    (virtual_timer_t*)&vtList,
+    (virtual_timer_t*)&vtList,
+    (systime_t)-1,
+    0
+};
+
+#define VT_LIST_END ((virtual_timer_t*)&vtList)
+
+void osalVTSetI(virtual_timer_t* vtp, systime_t delay, vtfunc_t vtfunc, void* par)
+{
+    osalDbgCheck((vtp != NULL) && (vtfunc != NULL) && (delay != TIME_IMMEDIATE));
+    osalDbgCheckClassI();
+
+    systime_t now = osalOsGetSystemTimeX();
+
+    if(vtList.next == VT_LIST_END){
+        vtList.baseTime = now;
+    }
+
+    /* Ticks that already passed since the base, but were not processed yet */
+    delay += now - vtList.baseTime;
+
+    virtual_timer_t* p = vtList.next;
+    while(p->delta < delay){
+        delay -= p->delta;
+        p = p->next;
+    }
+
+    /* Insert before p */
+    vtp->func = vtfunc;
+    vtp->par = par;
+    vtp->delta = delay;
+    vtp->next = p;
+    vtp->prev = p->prev;
+    p->prev->next = vtp;
+    p->prev = vtp;
+
+    if(p != VT_LIST_END){
+        p->delta -= delay;
+    }
+}
+
+void osalVTResetI(virtual_timer_t* vtp)
+{
+    osalDbgCheck(vtp != NULL);
+    osalDbgCheckClassI();
+
+    if(!vtp->func){
+        return;
+    }
+
+    /* The next one inherits my delta */
+    if(vtp->next != VT_LIST_END){
+        vtp->next->delta += vtp->delta;
+    }
+
+    vtp->prev->next = vtp->next;
+    vtp->next->prev = vtp->prev;
+    vtp->func = NULL;
+}
+
+void osalVTDoTickI(void)
+{
+    systime_t now = osalOsGetSystemTimeX();
+
+    /* Normally one tick passed, but tickless idle can step several at once */
+    while(vtList.next != VT_LIST_END){
+        virtual_timer_t* vtp = vtList.next;
+        systime_t elapsed = now - vtList.baseTime;
+
+        if(vtp->delta > elapsed){
+            vtp->delta -= elapsed;
+            break;
+        }
+
+        vtList.baseTime += vtp->delta;
+
+        /* Pop it, the callback may set it again */
+        vtList.next = vtp->next;
+        vtp->next->prev = VT_LIST_END;
+
+        vtfunc_t func = vtp->func;
+        vtp->func = NULL;
+        func(vtp->par);
+    }
+
+    vtList.baseTime = now;
+}
+
+uint32_t osalVTGetIdleTimeX(uint32_t ticks)
+{
+    /* Also called by the tick interrupt of a high resolution timebase */
+    UBaseType_t status = taskENTER_CRITICAL_FROM_ISR();
+
+    if(vtList.next != VT_LIST_END){
+        systime_t elapsed = osalOsGetSystemTimeX() - vtList.baseTime;
+        systime_t remaining = 0;
+
+        if(vtList.next->delta > elapsed){
+            remaining = vtList.next->delta - elapsed;
+        }
+        if(remaining < ticks){
+            ticks = remaining;
+        }
+    }
+
+    taskEXIT_CRITICAL_FROM_ISR(status);
+
+    return ticks;
+}
+
+#if( configUSE_TICK_HOOK == 1 )
+/* An application providing its own tick hook has to call osalVTDoTickI() */
+__attribute__((weak)) void vApplicationTickHook(void)
+{
+    osalVTDoTickI();
+}
+#endif
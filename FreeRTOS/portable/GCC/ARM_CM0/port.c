@@ -40,10 +40,12 @@
 #define portNVIC_SYSTICK_CURRENT_VALUE	( ( volatile uint32_t * ) 0xe000e018 )
 #define portNVIC_INT_CTRL				( ( volatile uint32_t *) 0xe000ed04 )
 #define portNVIC_SYSPRI2				( ( volatile uint32_t *) 0xe000ed20 )
+#define portNVIC_SYSTICK_COUNT_FLAG		0x00010000
 #define portNVIC_SYSTICK_CLK			0x00000004
 #define portNVIC_SYSTICK_INT			0x00000002
 #define portNVIC_SYSTICK_ENABLE			0x00000001
 #define portNVIC_PENDSVSET				0x10000000
+#define portNVIC_PENDSTSET				0x04000000
 #define portMIN_INTERRUPT_PRIORITY		( 255UL )
 #define portNVIC_PENDSV_PRI				( ((uint32_t)configKERNEL_INTERRUPT_PRIORITY ) << 16UL )
 #define portNVIC_PENDSV_HIPRI           ( ((uint32_t)configKERNEL_INTERRUPT_HIPRIORITY ) << 16UL )
@@ -52,6 +54,26 @@
 /* Constants required to set up the initial stack. */
 #define portINITIAL_XPSR			( 0x01000000 )
 
+/* The systick is a 24-bit counter. */
+#define portMAX_24_BIT_NUMBER		( 0xffffffUL )
+
+/* The SysTick is clocked by the core and counts down to the next tick. */
+#define portSYSTICK_COUNTS_PER_TICK	( configCPU_CLOCK_HZ / configTICK_RATE_HZ )
+
+/* A fiddle factor to estimate the number of SysTick counts that would have
+occurred while the SysTick counter is stopped during tickless idle
+calculations. */
+#define portMISSED_COUNTS_FACTOR	( 45UL )
+
+/* Idle periods from which the low power timer is used, by default the ones the
+SysTick cannot cover.  The timer is armed for the complete tick periods that
+follow the one the sleep starts in, so there must be at least one. */
+#ifndef configLOW_POWER_TIMER_MIN_TICKS
+	#define configLOW_POWER_TIMER_MIN_TICKS	( xMaximumPossibleSuppressedTicks + 1UL )
+#elif( configLOW_POWER_TIMER_MIN_TICKS < 2 )
+	#error configLOW_POWER_TIMER_MIN_TICKS must be at least 2
+#endif
+
 /* Let the user override the pre-loading of the initial LR with the address of
 prvTaskExitError() in case it messes up unwinding of the stack in the
 debugger. */
@@ -89,6 +111,35 @@ static void prvTaskExitError( void );
 variable. */
 static UBaseType_t uxCriticalNesting = 0;
 
+#if( configGENERATE_RUN_TIME_STATS == 1 )
+	/* Cycles spent in critical sections entered by tasks, timed with the
+	SysTick value alone as they are expected to be shorter than a tick. */
+	volatile uint32_t ulPortCriticalRunTime = 0;
+	static uint32_t ulCriticalEnterValue = 0;
+#endif
+
+#if( configUSE_TICKLESS_IDLE == 1 )
+	/* The number of SysTick increments that make up one tick period. */
+	static uint32_t ulTimerCountsForOneTick = 0;
+
+	/* The maximum number of tick periods that can be suppressed is limited by
+	the 24 bit resolution of the SysTick timer. */
+	static uint32_t xMaximumPossibleSuppressedTicks = 0;
+
+	/* Compensate for the CPU cycles that pass while the SysTick is stopped. */
+	static uint32_t ulStoppedTimerCompensation = 0;
+#endif /* configUSE_TICKLESS_IDLE */
+
+#if( configUSE_TICKLESS_IDLE == 1 ) && ( configUSE_LOW_POWER_TIMER == 1 )
+	/* The low power timer sleeps are limited by the 32 bit count of SysTick
+	increments they return. */
+	static uint32_t xMaximumLowPowerTimerTicks = 0;
+
+	/* Sleep on the application's low power timer, interrupts masked and the
+	SysTick stopped. */
+	static void prvLowPowerTimerSleep( TickType_t xExpectedIdleTime );
+#endif
+
 /*-----------------------------------------------------------*/
 static uint32_t ulSyspri2Value;
 /*
@@ -261,6 +312,15 @@ void vPortEnterCritical( void )
     uxCriticalNesting++;
 	__asm volatile( "dsb" ::: "memory" );
 	__asm volatile( "isb" );
+
+	#if( configGENERATE_RUN_TIME_STATS == 1 )
+	{
+		if( uxCriticalNesting == 1 )
+		{
+			ulCriticalEnterValue = *(portNVIC_SYSTICK_CURRENT_VALUE);
+		}
+	}
+	#endif
 }
 /*-----------------------------------------------------------*/
 
@@ -270,11 +330,59 @@ void vPortExitCritical( void )
     uxCriticalNesting--;
     if( uxCriticalNesting == 0 )
     {
+		#if( configGENERATE_RUN_TIME_STATS == 1 )
+		{
+		uint32_t ulElapsed = ulCriticalEnterValue - *(portNVIC_SYSTICK_CURRENT_VALUE);
+
+			/* The SysTick wrapped if the value went up. */
+			if( ulElapsed > portSYSTICK_COUNTS_PER_TICK )
+			{
+				ulElapsed += portSYSTICK_COUNTS_PER_TICK;
+			}
+
+			ulPortCriticalRunTime += ulElapsed;
+		}
+		#endif
+
         portENABLE_INTERRUPTS();
     }
 }
 /*-----------------------------------------------------------*/
 
+#if( configGENERATE_RUN_TIME_STATS == 1 )
+
+	uint32_t ulPortGetRunTimeCounter( void )
+	{
+	uint32_t ulMask, ulValue1, ulValue2, ulPending, ulReturn;
+
+		ulMask = ulSetInterruptMaskFromISR();
+
+		/* A wrap between the two reads shows as the value going up, the tick
+		interrupt is then pending for sure.  Otherwise the pending bit tells
+		if the tick count is one behind the first value. */
+		ulValue1 = *(portNVIC_SYSTICK_CURRENT_VALUE);
+		ulPending = *(portNVIC_INT_CTRL) & portNVIC_PENDSTSET;
+		ulValue2 = *(portNVIC_SYSTICK_CURRENT_VALUE);
+		if( ulValue2 > ulValue1 )
+		{
+			ulValue1 = ulValue2;
+			ulPending = portNVIC_PENDSTSET;
+		}
+
+		/* The SysTick value is what remains of the tick period, also when the
+		tickless idle code restarts it with a partial reload, so the reload
+		register is not used. */
+		ulReturn = ( xTaskGetTickCountFromISR() + ( ulPending ? 1UL : 0UL ) ) * portSYSTICK_COUNTS_PER_TICK;
+		ulReturn += ( portSYSTICK_COUNTS_PER_TICK - 1UL ) - ulValue1;
+
+		vClearInterruptMaskFromISR( ulMask );
+
+		return ulReturn;
+	}
+
+#endif /* configGENERATE_RUN_TIME_STATS */
+/*-----------------------------------------------------------*/
+
 uint32_t ulSetInterruptMaskFromISR( void )
 {
 	__asm volatile(
@@ -395,6 +503,21 @@ uint32_t ulPreviousMask;
  */
 void prvSetupTimerInterrupt( void )
 {
+	/* Calculate the constants required to configure the tick interrupt. */
+	#if( configUSE_TICKLESS_IDLE == 1 )
+	{
+		ulTimerCountsForOneTick = ( configCPU_CLOCK_HZ / configTICK_RATE_HZ );
+		xMaximumPossibleSuppressedTicks = portMAX_24_BIT_NUMBER / ulTimerCountsForOneTick;
+		ulStoppedTimerCompensation = portMISSED_COUNTS_FACTOR;
+	}
+	#endif /* configUSE_TICKLESS_IDLE */
+
+	#if( configUSE_TICKLESS_IDLE == 1 ) && ( configUSE_LOW_POWER_TIMER == 1 )
+	{
+		xMaximumLowPowerTimerTicks = 0xffffffffUL / ulTimerCountsForOneTick;
+	}
+	#endif /* configUSE_LOW_POWER_TIMER */
+
 	/* Stop and reset the SysTick. */
 	*(portNVIC_SYSTICK_CTRL) = 0UL;
 	*(portNVIC_SYSTICK_CURRENT_VALUE) = 0UL;
@@ -405,6 +528,262 @@ void prvSetupTimerInterrupt( void )
 }
 /*-----------------------------------------------------------*/
 
+#if( configUSE_TICKLESS_IDLE == 1 )
+
+	__attribute__((weak)) void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
+	{
+	uint32_t ulReloadValue, ulCompleteTickPeriods, ulCompletedSysTickDecrements;
+	TickType_t xModifiableIdleTime;
+	BaseType_t xUseLowPowerTimer = pdFALSE;
+
+		/* Idle periods too long for the SysTick, or configured so, run on the
+		low power timer.  Otherwise make sure the SysTick reload value does
+		not overflow the counter. */
+		#if( configUSE_LOW_POWER_TIMER == 1 )
+		{
+			if( xExpectedIdleTime >= configLOW_POWER_TIMER_MIN_TICKS )
+			{
+				xUseLowPowerTimer = pdTRUE;
+			}
+		}
+		#endif /* configUSE_LOW_POWER_TIMER */
+
+		if( ( xUseLowPowerTimer == pdFALSE ) && ( xExpectedIdleTime > xMaximumPossibleSuppressedTicks ) )
+		{
+			xExpectedIdleTime = xMaximumPossibleSuppressedTicks;
+		}
+
+		/* Stop the SysTick momentarily.  The time the SysTick is stopped for
+		is accounted for as best it can be, but using the tickless mode will
+		inevitably result in some tiny drift of the time maintained by the
+		kernel with respect to calendar time. */
+		*(portNVIC_SYSTICK_CTRL) &= ~portNVIC_SYSTICK_ENABLE;
+
+		/* Calculate the reload value required to wait xExpectedIdleTime
+		tick periods.  -1 is used because this code will execute part way
+		through one of the tick periods. */
+		ulReloadValue = 0UL;
+		if( xUseLowPowerTimer == pdFALSE )
+		{
+			ulReloadValue = *(portNVIC_SYSTICK_CURRENT_VALUE) + ( ulTimerCountsForOneTick * ( xExpectedIdleTime - 1UL ) );
+			if( ulReloadValue > ulStoppedTimerCompensation )
+			{
+				ulReloadValue -= ulStoppedTimerCompensation;
+			}
+		}
+
+		/* Enter a critical section but don't use the taskENTER_CRITICAL()
+		method as that will mask interrupts that should exit sleep mode. */
+		__asm volatile( "cpsid i" ::: "memory" );
+		__asm volatile( "dsb" );
+		__asm volatile( "isb" );
+
+		/* If a context switch is pending or a task is waiting for the scheduler
+		to be unsuspended then abandon the low power entry. */
+		if( eTaskConfirmSleepModeStatus() == eAbortSleep )
+		{
+			/* Restart from whatever is left in the count register to complete
+			this tick period. */
+			*(portNVIC_SYSTICK_LOAD) = *(portNVIC_SYSTICK_CURRENT_VALUE);
+
+			/* Restart SysTick. */
+			*(portNVIC_SYSTICK_CTRL) |= portNVIC_SYSTICK_ENABLE;
+
+			/* Reset the reload register to the value required for normal tick
+			periods. */
+			*(portNVIC_SYSTICK_LOAD) = ulTimerCountsForOneTick - 1UL;
+
+			/* Re-enable interrupts - see comments above the cpsid instruction()
+			above. */
+			__asm volatile( "cpsie i" ::: "memory" );
+		}
+		#if( configUSE_LOW_POWER_TIMER == 1 )
+		else if( xUseLowPowerTimer != pdFALSE )
+		{
+			prvLowPowerTimerSleep( xExpectedIdleTime );
+
+			/* Let the interrupt that ended the sleep execute. */
+			__asm volatile( "cpsie i" ::: "memory" );
+		}
+		#endif /* configUSE_LOW_POWER_TIMER */
+		else
+		{
+			/* Set the new reload value. */
+			*(portNVIC_SYSTICK_LOAD) = ulReloadValue;
+
+			/* Clear the SysTick count flag and set the count value back to
+			zero. */
+			*(portNVIC_SYSTICK_CURRENT_VALUE) = 0UL;
+
+			/* Restart SysTick. */
+			*(portNVIC_SYSTICK_CTRL) |= portNVIC_SYSTICK_ENABLE;
+
+			/* Sleep until something happens.  configPRE_SLEEP_PROCESSING() can
+			set its parameter to 0 to indicate that its implementation contains
+			its own wait for interrupt or wait for event instruction, and so wfi
+			should not be executed again.  However, the original expected idle
+			time variable must remain unmodified, so a copy is taken. */
+			xModifiableIdleTime = xExpectedIdleTime;
+			configPRE_SLEEP_PROCESSING( xModifiableIdleTime );
+			if( xModifiableIdleTime > 0 )
+			{
+				__asm volatile( "dsb" ::: "memory" );
+				__asm volatile( "wfi" );
+				__asm volatile( "isb" );
+			}
+			configPOST_SLEEP_PROCESSING( xExpectedIdleTime );
+
+			/* Re-enable interrupts to allow the interrupt that brought the MCU
+			out of sleep mode to execute immediately. */
+			__asm volatile( "cpsie i" ::: "memory" );
+			__asm volatile( "dsb" );
+			__asm volatile( "isb" );
+
+			/* Disable interrupts again because the clock is about to be stopped
+			and interrupts that execute while the clock is stopped will increase
+			any slippage between the time maintained by the RTOS and calendar
+			time. */
+			__asm volatile( "cpsid i" ::: "memory" );
+			__asm volatile( "dsb" );
+			__asm volatile( "isb" );
+
+			/* Disable the SysTick clock without reading the
+			portNVIC_SYSTICK_CTRL register to ensure the
+			portNVIC_SYSTICK_COUNT_FLAG is not cleared if it is set. */
+			*(portNVIC_SYSTICK_CTRL) = ( portNVIC_SYSTICK_CLK | portNVIC_SYSTICK_INT );
+
+			/* Determine if the SysTick clock has already counted to zero and
+			been set back to the current reload value (the reload back being
+			correct for the entire expected idle time) or if the SysTick is yet
+			to count to zero (in which case an interrupt other than the SysTick
+			must have brought the system out of sleep mode). */
+			if( ( *(portNVIC_SYSTICK_CTRL) & portNVIC_SYSTICK_COUNT_FLAG ) != 0 )
+			{
+				uint32_t ulCalculatedLoadValue;
+
+				/* The tick interrupt is already pending, and the SysTick count
+				reloaded with ulReloadValue.  Reset the portNVIC_SYSTICK_LOAD
+				register with whatever remains of this tick period. */
+				ulCalculatedLoadValue = ( ulTimerCountsForOneTick - 1UL ) - ( ulReloadValue - *(portNVIC_SYSTICK_CURRENT_VALUE) );
+
+				/* Don't allow a tiny value, or values that have somehow
+				underflowed because the post sleep hook did something
+				that took too long. */
+				if( ( ulCalculatedLoadValue < ulStoppedTimerCompensation ) || ( ulCalculatedLoadValue > ulTimerCountsForOneTick ) )
+				{
+					ulCalculatedLoadValue = ( ulTimerCountsForOneTick - 1UL );
+				}
+
+				*(portNVIC_SYSTICK_LOAD) = ulCalculatedLoadValue;
+
+				/* As the pending tick will be processed as soon as this
+				function exits, the tick value maintained by the tick is stepped
+				forward by one less than the time spent waiting. */
+				ulCompleteTickPeriods = xExpectedIdleTime - 1UL;
+			}
+			else
+			{
+				/* Something other than the tick interrupt ended the sleep.
+				Work out how long the sleep lasted rounded to complete tick
+				periods (not the ulReload value which accounted for part
+				ticks). */
+				ulCompletedSysTickDecrements = ( xExpectedIdleTime * ulTimerCountsForOneTick ) - *(portNVIC_SYSTICK_CURRENT_VALUE);
+
+				/* How many complete tick periods passed while the processor
+				was waiting? */
+				ulCompleteTickPeriods = ulCompletedSysTickDecrements / ulTimerCountsForOneTick;
+
+				/* The reload value is set to whatever fraction of a single tick
+				period remains. */
+				*(portNVIC_SYSTICK_LOAD) = ( ( ulCompleteTickPeriods + 1UL ) * ulTimerCountsForOneTick ) - ulCompletedSysTickDecrements;
+			}
+
+			/* Restart SysTick so it runs from portNVIC_SYSTICK_LOAD again,
+			then set portNVIC_SYSTICK_LOAD back to its standard value. */
+			*(portNVIC_SYSTICK_CURRENT_VALUE) = 0UL;
+			*(portNVIC_SYSTICK_CTRL) |= portNVIC_SYSTICK_ENABLE;
+			vTaskStepTick( ulCompleteTickPeriods );
+			*(portNVIC_SYSTICK_LOAD) = ulTimerCountsForOneTick - 1UL;
+
+			/* Exit with interrupts enabled. */
+			__asm volatile( "cpsie i" ::: "memory" );
+		}
+	}
+
+#endif /* configUSE_TICKLESS_IDLE */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_TICKLESS_IDLE == 1 ) && ( configUSE_LOW_POWER_TIMER == 1 )
+
+	static void prvLowPowerTimerSleep( TickType_t xExpectedIdleTime )
+	{
+	uint32_t ulRemainingCounts, ulElapsedCounts;
+	TickType_t xArmedTicks, xCompleteTickPeriods, xModifiableIdleTime;
+
+		/* The SysTick keeps the counts left in the tick period the sleep
+		starts in, the low power timer covers the complete periods that
+		follow.  The SysTick may not run in the sleep mode the low power
+		timer allows. */
+		ulRemainingCounts = *(portNVIC_SYSTICK_CURRENT_VALUE);
+
+		/* The elapsed time is returned in SysTick counts, limit the sleep to
+		what 32 bits can hold. */
+		if( xExpectedIdleTime > xMaximumLowPowerTimerTicks )
+		{
+			xExpectedIdleTime = xMaximumLowPowerTimerTicks;
+		}
+
+		xArmedTicks = xPortLowPowerTimerStart( xExpectedIdleTime - 1UL );
+		configASSERT( ( xArmedTicks > 0 ) && ( xArmedTicks < xExpectedIdleTime ) );
+
+		xModifiableIdleTime = xExpectedIdleTime;
+		configPRE_SLEEP_PROCESSING( xModifiableIdleTime );
+		if( xModifiableIdleTime > 0 )
+		{
+			__asm volatile( "dsb" ::: "memory" );
+			__asm volatile( "wfi" );
+			__asm volatile( "isb" );
+		}
+		configPOST_SLEEP_PROCESSING( xExpectedIdleTime );
+
+		ulElapsedCounts = ulPortLowPowerTimerStop() + ulStoppedTimerCompensation;
+
+		/* Work out the tick periods completed during the sleep and the counts
+		left to the next tick.  When the low power timer expired that is
+		xArmedTicks periods and the part of a period the sleep started with,
+		so the next tick interrupt fires when the kernel expects it. */
+		if( ulElapsedCounts < ulRemainingCounts )
+		{
+			xCompleteTickPeriods = 0;
+			ulRemainingCounts -= ulElapsedCounts;
+		}
+		else
+		{
+			ulElapsedCounts -= ulRemainingCounts;
+			xCompleteTickPeriods = ( TickType_t ) ( ulElapsedCounts / ulTimerCountsForOneTick ) + 1UL;
+			ulRemainingCounts = ulTimerCountsForOneTick - ( ulElapsedCounts % ulTimerCountsForOneTick );
+		}
+
+		/* The tick the kernel is waiting for is not stepped over, it is left
+		to the tick interrupt so the tasks it unblocks are processed. */
+		if( xCompleteTickPeriods >= xExpectedIdleTime )
+		{
+			xCompleteTickPeriods = xExpectedIdleTime - 1UL;
+			ulRemainingCounts = 1UL;
+		}
+
+		/* Restart the SysTick for the rest of the current tick period, then
+		set the reload back to its standard value. */
+		*(portNVIC_SYSTICK_LOAD) = ulRemainingCounts;
+		*(portNVIC_SYSTICK_CURRENT_VALUE) = 0UL;
+		*(portNVIC_SYSTICK_CTRL) |= portNVIC_SYSTICK_ENABLE;
+		vTaskStepTick( xCompleteTickPeriods );
+		*(portNVIC_SYSTICK_LOAD) = ulTimerCountsForOneTick - 1UL;
+	}
+
+#endif /* configUSE_LOW_POWER_TIMER */
+/*-----------------------------------------------------------*/
+
 void vPortBusyDelay( unsigned long cycles )
 {
     unsigned long i = 0;
@@ -106,6 +106,73 @@ extern void vClearInterruptMaskFromISR( uint32_t ulMask )  __attribute__((naked)
 
 /*-----------------------------------------------------------*/
 
+/* The Cortex-M0 has no cycle counter, the run time statistics are derived from
+the tick count and the SysTick, which is clocked by the core.  The time spent
+with interrupts masked by a task is accumulated in ulPortCriticalRunTime. */
+#if( configGENERATE_RUN_TIME_STATS == 1 )
+	extern uint32_t ulPortGetRunTimeCounter( void );
+	extern volatile uint32_t ulPortCriticalRunTime;
+
+	#ifndef portCONFIGURE_TIMER_FOR_RUN_TIME_STATS
+		#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+		#define portGET_RUN_TIME_COUNTER_VALUE()			ulPortGetRunTimeCounter()
+	#endif
+#endif
+
+/*-----------------------------------------------------------*/
+
+/* Tickless idle/low power functionality. */
+#ifndef portSUPPRESS_TICKS_AND_SLEEP
+	extern void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime );
+	#define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime ) vPortSuppressTicksAndSleep( xExpectedIdleTime )
+#endif
+
+/* The SysTick covers idle periods of up to 2^24 core cycles.  With
+configUSE_LOW_POWER_TIMER set to 1 the longer ones (or the ones of at least
+configLOW_POWER_TIMER_MIN_TICKS ticks) sleep on a timer that keeps running in
+the low power modes, an RTC wake up timer or a LPTIM, the application provides
+its driver.  Both functions are called with interrupts masked.
+xPortLowPowerTimerStart() arms the timer to wake the core after xTicks tick
+periods, or less if they do not fit its range, and returns the number of
+periods armed, at least one.  ulPortLowPowerTimerStop() stops the timer,
+clears its interrupt and returns the time elapsed since it was started in core
+clock cycles, the SysTick counts, so the phase of the tick is kept when
+another interrupt ends the sleep. */
+#ifndef configUSE_LOW_POWER_TIMER
+	#define configUSE_LOW_POWER_TIMER 0
+#endif
+
+#if( configUSE_LOW_POWER_TIMER == 1 )
+	extern TickType_t xPortLowPowerTimerStart( TickType_t xTicks );
+	extern uint32_t ulPortLowPowerTimerStop( void );
+#endif
+/*-----------------------------------------------------------*/
+
+/* Architecture specific optimisations. */
+#ifndef configUSE_PORT_OPTIMISED_TASK_SELECTION
+	#define configUSE_PORT_OPTIMISED_TASK_SELECTION 1
+#endif
+
+#if configUSE_PORT_OPTIMISED_TASK_SELECTION == 1
+
+	/* Check the configuration. */
+	#if( configMAX_PRIORITIES > 32 )
+		#error configUSE_PORT_OPTIMISED_TASK_SELECTION can only be set to 1 when configMAX_PRIORITIES is less than or equal to 32.  It is very rare that a system requires more than 10 to 15 difference priorities as tasks that share a priority will time slice.
+	#endif
+
+	/* Store/clear the ready priorities in a bit map. */
+	#define portRECORD_READY_PRIORITY( uxPriority, uxReadyPriorities ) ( uxReadyPriorities ) |= ( 1UL << ( uxPriority ) )
+	#define portRESET_READY_PRIORITY( uxPriority, uxReadyPriorities ) ( uxReadyPriorities ) &= ~( 1UL << ( uxPriority ) )
+
+	/*-----------------------------------------------------------*/
+
+	/* There is no CLZ instruction, the highest bit is found with a multiply
+	and a table lookup, see uxPortGetHighestPriority() in portable.h. */
+	#define portGET_HIGHEST_PRIORITY( uxTopPriority, uxReadyPriorities ) uxTopPriority = uxPortGetHighestPriority( ( uint32_t ) ( uxReadyPriorities ) )
+
+#endif /* configUSE_PORT_OPTIMISED_TASK_SELECTION */
+/*-----------------------------------------------------------*/
+
 /* Task function macros as described on the FreeRTOS.org WEB site. */
 #define portTASK_FUNCTION_PROTO( vFunction, pvParameters ) void vFunction( void *pvParameters )
 #define portTASK_FUNCTION( vFunction, pvParameters ) void vFunction( void *pvParameters )
@@ -62,6 +62,19 @@ FreeRTOS.org versions prior to V4.4.0 did not include this definition. */
 #define portNVIC_PENDSVCLEAR_BIT 			( 1UL << 27UL )
 #define portNVIC_PEND_SYSTICK_CLEAR_BIT		( 1UL << 25UL )
 
+/* Closest the high resolution timebase compare is armed ahead of its counter,
+about 64 core clock cycles so it is not reached while being written. */
+#ifndef portTIMEBASE_MIN_COUNTS
+	#define portTIMEBASE_MIN_COUNTS			( 2UL + ( uint32_t ) ( ( 64ULL * configTIMEBASE_CLOCK_HZ ) / configCPU_CLOCK_HZ ) )
+#endif
+
+/* The DWT cycle counter used for the run time statistics. */
+#define portDEMCR_REG						( * ( ( volatile uint32_t * ) 0xe000edfc ) )
+#define portDWT_CTRL_REG					( * ( ( volatile uint32_t * ) 0xe0001000 ) )
+#define portDWT_CYCCNT_REG					( * ( ( volatile uint32_t * ) 0xe0001004 ) )
+#define portDEMCR_TRCENA_BIT				( 1UL << 24UL )
+#define portDWT_CYCCNTENA_BIT				( 1UL << 0UL )
+
 
 /* Constants required to check the validity of an interrupt priority. */
 #define portFIRST_USER_INTERRUPT_NUMBER		( 16 )
@@ -104,6 +117,19 @@ debugger. */
 variable. */
 UBaseType_t uxCriticalNesting = 0;
 
+#if( configGENERATE_RUN_TIME_STATS == 1 )
+	/* Cycles spent in critical sections entered by tasks. */
+	volatile uint32_t ulPortCriticalRunTime = 0;
+	static uint32_t ulCriticalEnterTime = 0;
+#endif
+
+#if( configGENERATE_RUN_TIME_STATS == 1 ) && ( configUSE_TICKLESS_IDLE == 1 )
+	/* The DWT cycle counter stops while the core sleeps.  The sleep is timed
+	with the timer that wakes the core, and the cycle counter moved on to
+	ulStartCycles + ulSleptCycles once awake. */
+	static void prvAddSleepRunTime( uint32_t ulStartCycles, uint32_t ulSleptCycles );
+#endif
+
 uint32_t ulSyspri2Value;
 
 /*
@@ -133,20 +159,47 @@ static void prvTaskExitError( void );
 /*-----------------------------------------------------------*/
 
 /*
- * The number of SysTick increments that make up one tick period.
+ * The number of SysTick increments, or high resolution timebase counts, that
+ * make up one tick period.
  */
-#if configUSE_TICKLESS_IDLE == 1
+#if ( configUSE_TICKLESS_IDLE == 1 ) || ( configUSE_HIGH_RES_TIMEBASE == 1 )
 	static uint32_t ulTimerCountsForOneTick = 0;
 #endif /* configUSE_TICKLESS_IDLE */
 
 /*
  * The maximum number of tick periods that can be suppressed is limited by the
- * 24 bit resolution of the SysTick timer.
+ * 24 bit resolution of the SysTick timer, or by half the range of the high
+ * resolution timebase counter.
  */
-#if configUSE_TICKLESS_IDLE == 1
+#if ( configUSE_TICKLESS_IDLE == 1 ) || ( configUSE_HIGH_RES_TIMEBASE == 1 )
 	static uint32_t xMaximumPossibleSuppressedTicks = 0;
 #endif /* configUSE_TICKLESS_IDLE */
 
+/*
+ * High resolution timebase.  The time is read from a free running timer of the
+ * application, only its compare is moved to the next tick the kernel needs to
+ * see, so no count is ever lost.  The SysTick is not used.
+ */
+#if configUSE_HIGH_RES_TIMEBASE == 1
+	/* Timer counts at the last tick announced to the kernel. */
+	static uint32_t ulAnnouncedCounts = 0;
+
+	/* Timer counts the compare is armed for. */
+	static uint32_t ulArmedCounts = 0;
+
+	/* Program the compare xTicks ticks after the last announced one, unless
+	an earlier one is already armed and xForce is pdFALSE, interrupts
+	masked. */
+	static void prvArmTicks( TickType_t xTicks, BaseType_t xForce );
+
+	/* Selects the next task and rearms the compare, the new task may have
+	changed the next unblock time.  Called by the PendSV handler. */
+	static void prvSwitchContext( void ) __attribute__ (( used ));
+	#define portSWITCH_CONTEXT				"prvSwitchContext"
+#else
+	#define portSWITCH_CONTEXT				"vTaskSwitchContext"
+#endif /* configUSE_HIGH_RES_TIMEBASE */
+
 /*
  * Compensate for the CPU cycles that pass while the SysTick is stopped (low
  * power functionality only.
@@ -334,6 +387,12 @@ void vPortEnterCritical( void )
 {
 	if(!uxCriticalNesting) {
 		vPortRaiseBASEPRI();
+
+		#if( configGENERATE_RUN_TIME_STATS == 1 )
+		{
+			ulCriticalEnterTime = portDWT_CYCCNT_REG;
+		}
+		#endif
 	}
 
 	uxCriticalNesting++;
@@ -346,6 +405,12 @@ void vPortExitCritical( void )
 	uxCriticalNesting--;
 	if( uxCriticalNesting == 0 )
 	{
+		#if( configGENERATE_RUN_TIME_STATS == 1 )
+		{
+			ulPortCriticalRunTime += portDWT_CYCCNT_REG - ulCriticalEnterTime;
+		}
+		#endif
+
 		vPortSetBASEPRI(0);
 	}
 }
@@ -396,7 +461,7 @@ void xPortPendSVHandler( void )
 	"       stmdb sp!, {r3, r14}            \n"
 	"       mov r0, %0                      \n"
 	"       msr basepri, r0                 \n"
-	"       bl vTaskSwitchContext           \n"
+	"       bl " portSWITCH_CONTEXT "       \n"
 	"       ldmia sp!, {r3, r14}            \n"
 	"                                       \n"	/* Restore the context. */
 	"       ldr r1, [r3]                    \n"
@@ -417,6 +482,8 @@ void xPortPendSVHandler( void )
 }
 /*-----------------------------------------------------------*/
 
+#if( configUSE_HIGH_RES_TIMEBASE == 0 )
+
 void xPortSysTickHandler( void )
 {
 	/* The SysTick runs at the lowest interrupt priority, so when this interrupt
@@ -436,6 +503,126 @@ void xPortSysTickHandler( void )
 	}
 	portENABLE_INTERRUPTS();
 }
+
+#endif /* configUSE_HIGH_RES_TIMEBASE */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_HIGH_RES_TIMEBASE == 1 )
+
+	void xPortSysTickHandler( void )
+	{
+	uint32_t ulTicks;
+
+		portDISABLE_INTERRUPTS();
+		{
+			/* Announce all the ticks that passed at once, the kernel skips
+			those that do not unblock anything.  Only whole ticks are
+			announced, the remaining counts are kept for the next time. */
+			ulTicks = ( ulPortTimebaseGetCounter() - ulAnnouncedCounts ) / ulTimerCountsForOneTick;
+			ulAnnouncedCounts += ulTicks * ulTimerCountsForOneTick;
+
+			if( xTaskIncrementTickBy( ( TickType_t ) ulTicks ) != pdFALSE )
+			{
+				ulSyspri2Value = portNVIC_SYSPRI2_REG;
+				portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT;
+			}
+
+			/* The armed compare has been reached, a new one is needed even if
+			it is later. */
+			prvArmTicks( xTaskGetTicksToNextUnblock(), pdTRUE );
+		}
+		portENABLE_INTERRUPTS();
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvArmTicks( TickType_t xTicks, BaseType_t xForce )
+	{
+	uint32_t ulCompare, ulNow;
+
+		/* Tasks of the same priority still get their time slice about every
+		millisecond. */
+		#if( configUSE_PREEMPTION == 1 ) && ( configUSE_TIME_SLICING == 1 )
+		{
+			if( xTicks > portHIGH_RES_SLICE_TICKS )
+			{
+				xTicks = portHIGH_RES_SLICE_TICKS;
+			}
+		}
+		#endif
+
+		/* The virtual timers are not seen by the kernel. */
+		#ifdef configPRE_SUPPRESS_TICKS_AND_SLEEP_PROCESSING
+		{
+			configPRE_SUPPRESS_TICKS_AND_SLEEP_PROCESSING( xTicks );
+		}
+		#endif
+
+		/* Keep the compare less than half the counter range ahead so the
+		signed differences below stay valid. */
+		if( xTicks > xMaximumPossibleSuppressedTicks )
+		{
+			xTicks = xMaximumPossibleSuppressedTicks;
+		}
+
+		ulCompare = ulAnnouncedCounts + ( xTicks * ulTimerCountsForOneTick );
+
+		/* An earlier compare is already armed, it will rearm when it fires. */
+		if( ( xForce == pdFALSE ) && ( ( int32_t ) ( ulCompare - ulArmedCounts ) >= 0 ) )
+		{
+			return;
+		}
+
+		/* A compare too close to, or behind, the counter would be missed. */
+		ulNow = ulPortTimebaseGetCounter();
+		if( ( int32_t ) ( ulCompare - ulNow ) < ( int32_t ) portTIMEBASE_MIN_COUNTS )
+		{
+			ulCompare = ulNow + portTIMEBASE_MIN_COUNTS;
+		}
+
+		ulArmedCounts = ulCompare;
+		vPortTimebaseSetCompare( ulCompare );
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvSwitchContext( void )
+	{
+		vTaskSwitchContext();
+		vPortTimebaseRearm();
+	}
+	/*-----------------------------------------------------------*/
+
+	void vPortTimebaseRearm( void )
+	{
+	uint32_t ulBasePri;
+
+		if( ulTimerCountsForOneTick == 0 )
+		{
+			return;
+		}
+
+		ulBasePri = portSET_INTERRUPT_MASK_FROM_ISR();
+		prvArmTicks( xTaskGetTicksToNextUnblock(), pdFALSE );
+		portCLEAR_INTERRUPT_MASK_FROM_ISR( ulBasePri );
+	}
+	/*-----------------------------------------------------------*/
+
+	TickType_t xPortGetUnprocessedTicks( void )
+	{
+	uint32_t ulBasePri, ulCounts;
+
+		if( ulTimerCountsForOneTick == 0 )
+		{
+			return 0;
+		}
+
+		ulBasePri = portSET_INTERRUPT_MASK_FROM_ISR();
+		ulCounts = ulPortTimebaseGetCounter() - ulAnnouncedCounts;
+		portCLEAR_INTERRUPT_MASK_FROM_ISR( ulBasePri );
+
+		return ( TickType_t ) ( ulCounts / ulTimerCountsForOneTick );
+	}
+
+#endif /* configUSE_HIGH_RES_TIMEBASE */
 /*-----------------------------------------------------------*/
 
 #if( configUSE_TICKLESS_IDLE == 1 )
@@ -444,6 +631,57 @@ void xPortSysTickHandler( void )
 	{
 	uint32_t ulReloadValue, ulCompleteTickPeriods, ulCompletedSysTickDecrements;
 	TickType_t xModifiableIdleTime;
+	#if( configGENERATE_RUN_TIME_STATS == 1 )
+		uint32_t ulStartCycles, ulStartCounts;
+	#endif
+
+		#if( configUSE_HIGH_RES_TIMEBASE == 1 )
+		{
+			/* The timebase is not periodic, make sure the compare is armed
+			for the end of the idle time and sleep.  The ticks slept through
+			are announced by the timebase interrupt, there is nothing to
+			step. */
+			( void ) ulReloadValue;
+			( void ) ulCompleteTickPeriods;
+			( void ) ulCompletedSysTickDecrements;
+
+			__asm volatile( "cpsid i" ::: "memory" );
+			__asm volatile( "dsb" );
+			__asm volatile( "isb" );
+
+			if( eTaskConfirmSleepModeStatus() != eAbortSleep )
+			{
+				prvArmTicks( xExpectedIdleTime, pdFALSE );
+
+				#if( configGENERATE_RUN_TIME_STATS == 1 )
+				{
+					ulStartCycles = portDWT_CYCCNT_REG;
+					ulStartCounts = ulPortTimebaseGetCounter();
+				}
+				#endif
+
+				xModifiableIdleTime = xExpectedIdleTime;
+				configPRE_SLEEP_PROCESSING( xModifiableIdleTime );
+				if( xModifiableIdleTime > 0 )
+				{
+					__asm volatile( "dsb" ::: "memory" );
+					__asm volatile( "wfi" );
+					__asm volatile( "isb" );
+				}
+
+				#if( configGENERATE_RUN_TIME_STATS == 1 )
+				{
+					prvAddSleepRunTime( ulStartCycles, ( uint32_t ) ( ( ( uint64_t ) ( ulPortTimebaseGetCounter() - ulStartCounts ) * configCPU_CLOCK_HZ ) / configTIMEBASE_CLOCK_HZ ) );
+				}
+				#endif
+
+				configPOST_SLEEP_PROCESSING( xExpectedIdleTime );
+			}
+
+			__asm volatile( "cpsie i" ::: "memory" );
+			return;
+		}
+		#endif /* configUSE_HIGH_RES_TIMEBASE */
 
 		/* Make sure the SysTick reload value does not overflow the counter. */
 		if( xExpectedIdleTime > xMaximumPossibleSuppressedTicks )
@@ -503,6 +741,13 @@ void xPortSysTickHandler( void )
 			/* Restart SysTick. */
 			portNVIC_SYSTICK_CTRL_REG |= portNVIC_SYSTICK_ENABLE_BIT;
 
+			#if( configGENERATE_RUN_TIME_STATS == 1 )
+			{
+				ulStartCycles = portDWT_CYCCNT_REG;
+				ulStartCounts = portNVIC_SYSTICK_CURRENT_VALUE_REG;
+			}
+			#endif
+
 			/* Sleep until something happens.  configPRE_SLEEP_PROCESSING() can
 			set its parameter to 0 to indicate that its implementation contains
 			its own wait for interrupt or wait for event instruction, and so wfi
@@ -516,6 +761,38 @@ void xPortSysTickHandler( void )
 				__asm volatile( "wfi" );
 				__asm volatile( "isb" );
 			}
+
+			#if( configGENERATE_RUN_TIME_STATS == 1 )
+			{
+			uint32_t ulEndValue, ulPending, ulValue;
+
+				/* The SysTick reads 0 until its first clock after the restart.
+				If it wrapped since, the tick interrupt is pending, a wrap
+				between the two reads shows as the value going up. */
+				if( ulStartCounts == 0UL )
+				{
+					ulStartCounts = ulReloadValue + 1UL;
+				}
+
+				ulEndValue = portNVIC_SYSTICK_CURRENT_VALUE_REG;
+				ulPending = portNVIC_INT_CTRL_REG & portNVIC_PENDSTSET_BIT;
+				ulValue = portNVIC_SYSTICK_CURRENT_VALUE_REG;
+				if( ulValue > ulEndValue )
+				{
+					ulEndValue = ulValue;
+					ulPending = portNVIC_PENDSTSET_BIT;
+				}
+
+				ulValue = ulStartCounts - ulEndValue;
+				if( ulPending != 0UL )
+				{
+					ulValue += ulReloadValue + 1UL;
+				}
+
+				prvAddSleepRunTime( ulStartCycles, ulValue * ( configCPU_CLOCK_HZ / configSYSTICK_CLOCK_HZ ) );
+			}
+			#endif
+
 			configPOST_SLEEP_PROCESSING( xExpectedIdleTime );
 
 			/* Re-enable interrupts to allow the interrupt that brought the MCU
@@ -605,6 +882,35 @@ void xPortSysTickHandler( void )
 #endif /* configUSE_TICKLESS_IDLE */
 /*-----------------------------------------------------------*/
 
+#if( configGENERATE_RUN_TIME_STATS == 1 )
+
+	void vPortSetupRunTimeCounter( void )
+	{
+		portDEMCR_REG |= portDEMCR_TRCENA_BIT;
+		portDWT_CYCCNT_REG = 0UL;
+		portDWT_CTRL_REG |= portDWT_CYCCNTENA_BIT;
+	}
+	/*-----------------------------------------------------------*/
+
+	#if( configUSE_TICKLESS_IDLE == 1 )
+
+		static void prvAddSleepRunTime( uint32_t ulStartCycles, uint32_t ulSleptCycles )
+		{
+		uint32_t ulCycles = ulStartCycles + ulSleptCycles;
+
+			/* Never move the counter back, the cycles counted while awake may
+			be more than the timer resolution. */
+			if( ( int32_t ) ( ulCycles - portDWT_CYCCNT_REG ) > 0 )
+			{
+				portDWT_CYCCNT_REG = ulCycles;
+			}
+		}
+
+	#endif /* configUSE_TICKLESS_IDLE */
+
+#endif /* configGENERATE_RUN_TIME_STATS */
+/*-----------------------------------------------------------*/
+
 /*
  * Setup the systick timer to generate the tick interrupts at the required
  * frequency.
@@ -620,6 +926,22 @@ __attribute__(( weak )) void vPortSetupTimerInterrupt( void )
 	}
 	#endif /* configUSE_TICKLESS_IDLE */
 
+	/* The high resolution timebase uses the free running timer of the
+	application instead of the SysTick.  The first compare is one tick away,
+	the timebase interrupt arms the following ones. */
+	#if configUSE_HIGH_RES_TIMEBASE == 1
+	{
+		ulTimerCountsForOneTick = ( configTIMEBASE_CLOCK_HZ / configTICK_RATE_HZ );
+		xMaximumPossibleSuppressedTicks = 0x7FFFFFFFUL / ulTimerCountsForOneTick;
+
+		vPortTimebaseSetup();
+		ulAnnouncedCounts = ulPortTimebaseGetCounter();
+		ulArmedCounts = ulAnnouncedCounts;
+		prvArmTicks( 1, pdTRUE );
+		return;
+	}
+	#endif /* configUSE_HIGH_RES_TIMEBASE */
+
 	/* Configure SysTick to interrupt at the requested rate. */
 	portNVIC_SYSTICK_LOAD_REG = ( configSYSTICK_CLOCK_HZ / configTICK_RATE_HZ ) - 1UL;
 	portNVIC_SYSTICK_CTRL_REG = ( portNVIC_SYSTICK_CLK_BIT | portNVIC_SYSTICK_INT_BIT | portNVIC_SYSTICK_ENABLE_BIT );
@@ -108,6 +108,7 @@ extern uint32_t ulSyspri2Value;
 
 #define portNVIC_INT_CTRL_REG		( * ( ( volatile uint32_t * ) 0xe000ed04 ) )
 #define portNVIC_PENDSVSET_BIT		( 1UL << 28UL )
+#define portNVIC_PENDSTSET_BIT		( 1UL << 26UL )
 #define portEND_SWITCHING_ISR( xSwitchRequired ) if( xSwitchRequired != pdFALSE ) portYIELD()
 #define portYIELD_FROM_ISR( x ) portEND_SWITCHING_ISR( x )
 /*-----------------------------------------------------------*/
@@ -135,6 +136,48 @@ not necessary for to use this port.  They are defined so the common demo files
 #define portTASK_FUNCTION( vFunction, pvParameters ) void vFunction( void *pvParameters )
 /*-----------------------------------------------------------*/
 
+/* High resolution timebase: the tick count is derived from a free running 32
+bit counter of the application, clocked at configTIMEBASE_CLOCK_HZ, and only its
+compare is moved to the next tick the kernel needs to see.  The SysTick is not
+used.  The application supplies the timer functions below, they are called with
+interrupts masked, and calls xPortSysTickHandler() from the compare interrupt,
+at configKERNEL_INTERRUPT_PRIORITY.  The compare is also moved on every context
+switch, after vTaskSwitchContext(), as the new task may have changed the next
+unblock time, and by vPortTimebaseRearm(). */
+#if( configUSE_HIGH_RES_TIMEBASE == 1 )
+	#ifndef configTIMEBASE_CLOCK_HZ
+		#error configTIMEBASE_CLOCK_HZ must be defined when configUSE_HIGH_RES_TIMEBASE is 1
+	#endif
+
+	extern void vPortTimebaseSetup( void );
+	extern uint32_t ulPortTimebaseGetCounter( void );
+	extern void vPortTimebaseSetCompare( uint32_t ulCounter );
+
+	extern TickType_t xPortGetUnprocessedTicks( void );
+	extern void vPortTimebaseRearm( void );
+	#define portGET_UNPROCESSED_TICKS()		xPortGetUnprocessedTicks()
+
+	#ifndef portHIGH_RES_SLICE_TICKS
+		#define portHIGH_RES_SLICE_TICKS	( ( configTICK_RATE_HZ >= 1000 ) ? ( TickType_t ) ( configTICK_RATE_HZ / 1000 ) : ( TickType_t ) 1 )
+	#endif
+#endif
+/*-----------------------------------------------------------*/
+
+/* Run time statistics count core clock cycles with the DWT cycle counter.  It
+stops while the core sleeps, the tickless idle code moves it on by the time
+slept.  The time spent with interrupts masked by a task is accumulated in
+ulPortCriticalRunTime. */
+#if( configGENERATE_RUN_TIME_STATS == 1 )
+	extern void vPortSetupRunTimeCounter( void );
+	extern volatile uint32_t ulPortCriticalRunTime;
+
+	#ifndef portCONFIGURE_TIMER_FOR_RUN_TIME_STATS
+		#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()	vPortSetupRunTimeCounter()
+		#define portGET_RUN_TIME_COUNTER_VALUE()			( * ( ( volatile uint32_t * ) 0xe0001004 ) )
+	#endif
+#endif
+/*-----------------------------------------------------------*/
+
 /* Tickless idle/low power functionality. */
 #ifndef portSUPPRESS_TICKS_AND_SLEEP
 	extern void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime );
@@ -0,0 +1,696 @@
+/*
+ * FreeRTOS Kernel V10.0.0
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software. If you wish to use our Amazon
+ * FreeRTOS name, please do so in a fair use way that does not cause confusion.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*-----------------------------------------------------------
+ * Implementation of functions defined in portable.h for the Posix
+ * (Linux host) port.
+ *----------------------------------------------------------*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <sys/time.h>
+#include <time.h>
+#include <ucontext.h>
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define portNSEC_PER_SEC					( 1000000000L )
+#define portNSEC_PER_TICK					( portNSEC_PER_SEC / configTICK_RATE_HZ )
+
+/* With a high resolution timebase the idle task never sleeps longer than this,
+the simulated peripherals are polled at the same rate. */
+#define portNSEC_PER_POLL					( 1000000L )
+
+/* Period of the host timer signal that preempts the running task. */
+#if( configUSE_HIGH_RES_TIMEBASE == 1 )
+	#define portNSEC_PER_TIMER				portNSEC_PER_POLL
+#else
+	#define portNSEC_PER_TIMER				portNSEC_PER_TICK
+#endif
+
+#define portSTRINGIFY_( x )					#x
+#define portSTRINGIFY( x )					portSTRINGIFY_( x )
+
+/* Host side state of a task. The FreeRTOS stack of the task only holds a
+pointer to this structure, the task itself runs on xStack. */
+typedef struct xPORT_THREAD
+{
+	ucontext_t xContext;
+	UBaseType_t uxCriticalNesting;
+	TaskFunction_t pxCode;
+	void *pvParameters;
+	uint8_t xStack[ configSIMULATOR_STACK_SIZE ] __attribute__(( aligned( 16 ) ));
+} PortThread_t;
+
+/* Defined in tasks.c, the first member of the TCB is the top of stack. */
+extern struct tskTaskControlBlock * volatile pxCurrentTCB;
+
+/* Each task maintains its own interrupt status in the critical nesting
+variable. */
+UBaseType_t uxCriticalNesting = 0;
+
+#if( configGENERATE_RUN_TIME_STATS == 1 )
+	/* Cycles spent in critical sections entered by tasks. */
+	volatile uint32_t ulPortCriticalRunTime = 0;
+	static uint32_t ulCriticalEnterTime = 0;
+#endif
+
+/* Set while a simulated interrupt is being serviced. */
+volatile BaseType_t xPortInterruptActive = pdFALSE;
+
+/* Interrupts are only dispatched once the scheduler runs. */
+static BaseType_t xSchedulerStarted = pdFALSE;
+
+/* A context switch was requested from a simulated interrupt. */
+static BaseType_t xSwitchPending = pdFALSE;
+
+/* The timer signal arrived while the interrupts were masked. */
+static volatile sig_atomic_t xTimerPending = pdFALSE;
+
+/* Host time at which the next tick is due. */
+static struct timespec xNextTick;
+
+#if( configUSE_HIGH_RES_TIMEBASE == 1 )
+	/* Host time at which the peripherals are polled again. */
+	static struct timespec xNextPoll;
+#endif
+
+static void ( *pxInterruptHandler )( void ) = NULL;
+
+/* heap.c expects the linker script to provide __heap_base__ and __heap_end__,
+on the host they simply delimit a block of bss. */
+__asm__(
+	"	.bss							\n"
+	"	.balign 16						\n"
+	"	.globl __heap_base__			\n"
+	"__heap_base__:						\n"
+	"	.space " portSTRINGIFY( configSIMULATOR_HEAP_SIZE ) "\n"
+	"	.globl __heap_end__				\n"
+	"__heap_end__:						\n"
+	"	.text							\n"
+);
+
+/*
+ * Used to catch tasks that attempt to return from their implementing function.
+ */
+static void prvTaskExitError( void );
+
+/*
+ * Dispatch the simulated interrupts.
+ */
+static void prvServiceInterrupts( void );
+
+/*-----------------------------------------------------------*/
+
+static PortThread_t *prvGetThread( void *pxTCB )
+{
+	return ( PortThread_t * ) **( ( StackType_t ** ) pxTCB );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTaskEntry( void )
+{
+PortThread_t *pxThread = prvGetThread( pxCurrentTCB );
+
+	/* The switch into a new task does not return through prvSwitchContext(),
+	the nesting of the previous task is still loaded. */
+	uxCriticalNesting = pxThread->uxCriticalNesting;
+	if( xTimerPending != pdFALSE )
+	{
+		prvServiceInterrupts();
+	}
+
+	pxThread->pxCode( pxThread->pvParameters );
+
+	prvTaskExitError();
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * See header file for description.
+ */
+StackType_t *pxPortInitialiseStack( StackType_t *pxTopOfStack, TaskFunction_t pxCode, void *pvParameters )
+{
+PortThread_t *pxThread;
+
+	/* The host heap is not reentrant, the timer signal must not switch to
+	another task while it is used. */
+	vPortEnterCritical();
+	pxThread = malloc( sizeof( PortThread_t ) );
+	vPortExitCritical();
+
+	configASSERT( pxThread != NULL );
+
+	getcontext( &pxThread->xContext );
+	pxThread->xContext.uc_stack.ss_sp = pxThread->xStack;
+	pxThread->xContext.uc_stack.ss_size = sizeof( pxThread->xStack );
+	pxThread->xContext.uc_link = NULL;
+	makecontext( &pxThread->xContext, prvTaskEntry, 0 );
+
+	pxThread->uxCriticalNesting = 0;
+	pxThread->pxCode = pxCode;
+	pxThread->pvParameters = pvParameters;
+
+	*pxTopOfStack = ( StackType_t ) pxThread;
+	return pxTopOfStack;
+}
+/*-----------------------------------------------------------*/
+
+void vPortCleanUpTCB( void *pxTCB )
+{
+	vPortEnterCritical();
+	free( prvGetThread( pxTCB ) );
+	vPortExitCritical();
+}
+/*-----------------------------------------------------------*/
+
+static void prvTaskExitError( void )
+{
+	/* A function that implements a task must not exit or attempt to return to
+	its caller as there is nothing to return to.  If a task wants to exit it
+	should instead call vTaskDelete( NULL ). */
+	configASSERT( uxCriticalNesting == ~0UL );
+	portDISABLE_INTERRUPTS();
+	for( ;; );
+}
+/*-----------------------------------------------------------*/
+
+static void prvSwitchContext( void )
+{
+PortThread_t *pxOld = prvGetThread( pxCurrentTCB );
+PortThread_t *pxNew;
+
+	/* The interrupts are masked while the next task is selected, the task
+	switched to loads its own nesting. */
+	pxOld->uxCriticalNesting = uxCriticalNesting;
+	uxCriticalNesting++;
+	vTaskSwitchContext();
+	pxNew = prvGetThread( pxCurrentTCB );
+
+	if( pxNew != pxOld )
+	{
+		swapcontext( &pxOld->xContext, &pxNew->xContext );
+	}
+
+	/* Running again, pxCurrentTCB refers to this task. */
+	uxCriticalNesting = pxOld->uxCriticalNesting;
+	if( ( uxCriticalNesting == 0 ) && ( xTimerPending != pdFALSE ) )
+	{
+		prvServiceInterrupts();
+	}
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvTimeDue( const struct timespec *pxNow, const struct timespec *pxWhen )
+{
+	if( pxNow->tv_sec != pxWhen->tv_sec )
+	{
+		return ( pxNow->tv_sec > pxWhen->tv_sec ) ? pdTRUE : pdFALSE;
+	}
+
+	return ( pxNow->tv_nsec >= pxWhen->tv_nsec ) ? pdTRUE : pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvTickDue( const struct timespec *pxNow )
+{
+	return prvTimeDue( pxNow, &xNextTick );
+}
+/*-----------------------------------------------------------*/
+
+#if( configUSE_HIGH_RES_TIMEBASE == 1 )
+
+	static void prvAddNanoseconds( struct timespec *pxTime, int64_t llNanoseconds )
+	{
+		pxTime->tv_sec += ( time_t ) ( llNanoseconds / portNSEC_PER_SEC );
+		pxTime->tv_nsec += ( long ) ( llNanoseconds % portNSEC_PER_SEC );
+		if( pxTime->tv_nsec >= portNSEC_PER_SEC )
+		{
+			pxTime->tv_nsec -= portNSEC_PER_SEC;
+			pxTime->tv_sec++;
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	/* Number of ticks that passed but were not announced to the kernel yet. */
+	static TickType_t prvElapsedTicks( const struct timespec *pxNow )
+	{
+	int64_t llNanoseconds;
+
+		if( prvTickDue( pxNow ) == pdFALSE )
+		{
+			return 0;
+		}
+
+		llNanoseconds = ( int64_t ) ( pxNow->tv_sec - xNextTick.tv_sec ) * portNSEC_PER_SEC;
+		llNanoseconds += pxNow->tv_nsec - xNextTick.tv_nsec;
+
+		return ( TickType_t ) ( llNanoseconds / portNSEC_PER_TICK ) + 1;
+	}
+	/*-----------------------------------------------------------*/
+
+	TickType_t xPortGetUnprocessedTicks( void )
+	{
+	struct timespec xNow;
+
+		if( xSchedulerStarted == pdFALSE )
+		{
+			return 0;
+		}
+
+		clock_gettime( CLOCK_MONOTONIC, &xNow );
+		return prvElapsedTicks( &xNow );
+	}
+	/*-----------------------------------------------------------*/
+
+	/* Plays the role of the compare register: sleep until xTicks ticks are
+	announced, or until the peripherals have to be polled again. */
+	static void prvSleepTicks( TickType_t xTicks )
+	{
+	struct timespec xWhen = xNextTick;
+
+		if( xTicks > ( TickType_t ) 1 )
+		{
+			prvAddNanoseconds( &xWhen, ( int64_t ) ( xTicks - 1 ) * portNSEC_PER_TICK );
+		}
+
+		if( prvTimeDue( &xWhen, &xNextPoll ) != pdFALSE )
+		{
+			xWhen = xNextPoll;
+		}
+
+		while( clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &xWhen, NULL ) != 0 )
+		{
+		}
+	}
+
+#endif /* configUSE_HIGH_RES_TIMEBASE */
+/*-----------------------------------------------------------*/
+
+/*
+ * Dispatch the simulated interrupts. This plays the role of the NVIC: it is
+ * called whenever interrupts become unmasked.
+ */
+static void prvServiceInterrupts( void )
+{
+struct timespec xNow;
+BaseType_t xTicked = pdFALSE;
+
+	if( ( xSchedulerStarted == pdFALSE ) || ( xPortInterruptActive != pdFALSE ) )
+	{
+		return;
+	}
+
+	xPortInterruptActive = pdTRUE;
+	xTimerPending = pdFALSE;
+
+	clock_gettime( CLOCK_MONOTONIC, &xNow );
+
+	#if( configUSE_HIGH_RES_TIMEBASE == 1 )
+	{
+	TickType_t xTicks = prvElapsedTicks( &xNow );
+
+		/* Announce all the ticks that passed at once, the kernel skips those
+		that do not unblock anything. */
+		if( xTicks > ( TickType_t ) 0 )
+		{
+			prvAddNanoseconds( &xNextTick, ( int64_t ) xTicks * portNSEC_PER_TICK );
+
+			uxCriticalNesting++;
+			if( xTaskIncrementTickBy( xTicks ) != pdFALSE )
+			{
+				xSwitchPending = pdTRUE;
+			}
+			uxCriticalNesting--;
+		}
+
+		if( prvTimeDue( &xNow, &xNextPoll ) != pdFALSE )
+		{
+			xNextPoll = xNow;
+			prvAddNanoseconds( &xNextPoll, portNSEC_PER_POLL );
+			xTicked = pdTRUE;
+		}
+	}
+	#else
+	{
+		/* SysTick, catching up on ticks the host did not give us time for. */
+		while( prvTickDue( &xNow ) != pdFALSE )
+		{
+			xNextTick.tv_nsec += portNSEC_PER_TICK;
+			if( xNextTick.tv_nsec >= portNSEC_PER_SEC )
+			{
+				xNextTick.tv_nsec -= portNSEC_PER_SEC;
+				xNextTick.tv_sec++;
+			}
+
+			uxCriticalNesting++;
+			if( xTaskIncrementTick() != pdFALSE )
+			{
+				xSwitchPending = pdTRUE;
+			}
+			uxCriticalNesting--;
+
+			xTicked = pdTRUE;
+		}
+	}
+	#endif /* configUSE_HIGH_RES_TIMEBASE */
+
+	/* Peripherals are polled at tick rate, polling them on every critical
+	section exit would make the simulation mostly system calls. */
+	if( ( xTicked != pdFALSE ) && ( pxInterruptHandler != NULL ) )
+	{
+		pxInterruptHandler();
+	}
+
+	xPortInterruptActive = pdFALSE;
+
+	if( xSwitchPending != pdFALSE )
+	{
+		xSwitchPending = pdFALSE;
+		prvSwitchContext();
+	}
+}
+/*-----------------------------------------------------------*/
+
+#if( configUSE_PREEMPTION == 1 )
+
+	/* The host timer signal plays the role of the SysTick interrupt, it can
+	switch tasks at any point where the interrupts are not masked. */
+	static void prvTimerSignalHandler( int iSignal )
+	{
+	int iSavedErrno = errno;
+
+		( void ) iSignal;
+
+		if( ( uxCriticalNesting != 0 ) || ( xPortInterruptActive != pdFALSE ) )
+		{
+			/* Dispatched when the interrupts are unmasked. */
+			xTimerPending = pdTRUE;
+		}
+		else
+		{
+			prvServiceInterrupts();
+		}
+
+		errno = iSavedErrno;
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvStartTimerSignal( long lNanoseconds )
+	{
+	struct sigaction xAction;
+	struct itimerval xTimer;
+
+		memset( &xAction, 0, sizeof( xAction ) );
+		xAction.sa_handler = prvTimerSignalHandler;
+		xAction.sa_flags = SA_RESTART;
+		sigemptyset( &xAction.sa_mask );
+		sigaction( SIGALRM, &xAction, NULL );
+
+		xTimer.it_interval.tv_sec = 0;
+		xTimer.it_interval.tv_usec = ( lNanoseconds + 999L ) / 1000L;
+		xTimer.it_value = xTimer.it_interval;
+		setitimer( ITIMER_REAL, &xTimer, NULL );
+	}
+
+#endif /* configUSE_PREEMPTION */
+/*-----------------------------------------------------------*/
+
+void vPortSetInterruptHandler( void ( *pxHandler )( void ) )
+{
+	pxInterruptHandler = pxHandler;
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * See header file for description.
+ */
+BaseType_t xPortStartScheduler( void )
+{
+ucontext_t xSchedulerContext;
+
+	clock_gettime( CLOCK_MONOTONIC, &xNextTick );
+	#if( configUSE_HIGH_RES_TIMEBASE == 1 )
+	{
+		xNextPoll = xNextTick;
+	}
+	#endif
+
+	/* The interrupts stay masked by vTaskStartScheduler() until the first
+	task loads its own critical nesting. */
+	xSchedulerStarted = pdTRUE;
+
+	#if( configUSE_PREEMPTION == 1 )
+	{
+		prvStartTimerSignal( portNSEC_PER_TIMER );
+	}
+	#endif
+
+	/* Start the first task, the scheduler context is never resumed. */
+	swapcontext( &xSchedulerContext, &prvGetThread( pxCurrentTCB )->xContext );
+
+	/* Should not get here! */
+	prvTaskExitError();
+	return 0;
+}
+/*-----------------------------------------------------------*/
+
+void vPortEndScheduler( void )
+{
+	/* Mask all interrupts */
+	xSchedulerStarted = pdFALSE;
+
+	#if( configUSE_PREEMPTION == 1 )
+	{
+		prvStartTimerSignal( 0 );
+	}
+	#endif
+}
+/*-----------------------------------------------------------*/
+
+void vPortYield( void )
+{
+	if( xPortInterruptActive != pdFALSE )
+	{
+		xSwitchPending = pdTRUE;
+		return;
+	}
+
+	prvSwitchContext();
+}
+/*-----------------------------------------------------------*/
+
+void vPortYieldFromISR( void )
+{
+	vPortYield();
+}
+/*-----------------------------------------------------------*/
+
+void vPortEnterCritical( void )
+{
+	uxCriticalNesting++;
+
+	#if( configGENERATE_RUN_TIME_STATS == 1 )
+	{
+		if( ( uxCriticalNesting == 1 ) && ( xPortInterruptActive == pdFALSE ) )
+		{
+			ulCriticalEnterTime = ulPortGetRunTimeCounter();
+		}
+	}
+	#endif
+}
+/*-----------------------------------------------------------*/
+
+void vPortExitCritical( void )
+{
+	configASSERT( uxCriticalNesting );
+	uxCriticalNesting--;
+	if( uxCriticalNesting == 0 )
+	{
+		#if( configGENERATE_RUN_TIME_STATS == 1 )
+		{
+			if( xPortInterruptActive == pdFALSE )
+			{
+				ulPortCriticalRunTime += ulPortGetRunTimeCounter() - ulCriticalEnterTime;
+			}
+		}
+		#endif
+
+		prvServiceInterrupts();
+	}
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulPortEnterCriticalFromISR( void )
+{
+	uint32_t ulNesting = uxCriticalNesting;
+
+	uxCriticalNesting++;
+
+	return ulNesting;
+}
+/*-----------------------------------------------------------*/
+
+void vPortExitCriticalFromISR( uint32_t ulNesting )
+{
+	configASSERT( uxCriticalNesting );
+	uxCriticalNesting = ulNesting;
+	if( uxCriticalNesting == 0 )
+	{
+		prvServiceInterrupts();
+	}
+}
+/*-----------------------------------------------------------*/
+
+#if( configUSE_TICKLESS_IDLE == 1 )
+
+	__attribute__((weak)) void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
+	{
+		( void ) xExpectedIdleTime;
+
+		/* If a context switch is pending or a task is waiting for the scheduler
+		to be unsuspended then abandon the low power entry. */
+		if( eTaskConfirmSleepModeStatus() == eAbortSleep )
+		{
+			return;
+		}
+
+		#if( configUSE_HIGH_RES_TIMEBASE == 1 )
+		{
+			/* There is no periodic tick to suppress, the ticks slept through
+			are announced when the scheduler is resumed. */
+			prvSleepTicks( xExpectedIdleTime );
+			return;
+		}
+		#endif
+
+		/* Sleep until the next tick is due, the tick and the peripherals are
+		serviced as soon as the idle task leaves its critical section. The
+		tick keeps running so there is no need to step it. */
+		while( clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &xNextTick, NULL ) != 0 )
+		{
+		}
+	}
+
+#endif /* configUSE_TICKLESS_IDLE */
+/*-----------------------------------------------------------*/
+
+void vPortIdle( void )
+{
+struct timespec xNow;
+
+	/* The idle task only enters tickless sleep when no task is due within two
+	ticks, in the other cases it spins without ever leaving a critical section.
+	Wait for the next tick here and let the exit of the critical section
+	dispatch it. */
+	#if( configUSE_HIGH_RES_TIMEBASE == 1 )
+	{
+	TickType_t xTicks;
+
+		( void ) xNow;
+
+		portENTER_CRITICAL();
+		xTicks = xTaskGetTicksToNextUnblock();
+		#ifdef configPRE_SUPPRESS_TICKS_AND_SLEEP_PROCESSING
+		{
+			configPRE_SUPPRESS_TICKS_AND_SLEEP_PROCESSING( xTicks );
+		}
+		#endif
+		prvSleepTicks( xTicks );
+		portEXIT_CRITICAL();
+		return;
+	}
+	#endif
+
+	clock_gettime( CLOCK_MONOTONIC, &xNow );
+	if( prvTickDue( &xNow ) == pdFALSE )
+	{
+		while( clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &xNextTick, NULL ) != 0 )
+		{
+		}
+	}
+
+	portENTER_CRITICAL();
+	portEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+#if( configUSE_IDLE_HOOK == 1 )
+
+	/* Applications providing their own idle hook must call vPortIdle(). */
+	__attribute__((weak)) void vApplicationIdleHook( void )
+	{
+		vPortIdle();
+	}
+
+#endif /* configUSE_IDLE_HOOK */
+/*-----------------------------------------------------------*/
+
+#if( configGENERATE_RUN_TIME_STATS == 1 )
+
+	uint32_t ulPortGetRunTimeCounter( void )
+	{
+	struct timespec xNow;
+	uint64_t ullCycles;
+
+		clock_gettime( CLOCK_MONOTONIC, &xNow );
+		ullCycles = ( uint64_t ) xNow.tv_sec * configCPU_CLOCK_HZ;
+		ullCycles += ( ( uint64_t ) xNow.tv_nsec * configCPU_CLOCK_HZ ) / portNSEC_PER_SEC;
+
+		/* Only the low 32 bits are kept, like a hardware cycle counter. */
+		return ( uint32_t ) ullCycles;
+	}
+
+#endif /* configGENERATE_RUN_TIME_STATS */
+/*-----------------------------------------------------------*/
+
+void vPortBusyDelay( unsigned long cycles )
+{
+struct timespec xNow, xEnd;
+long lNanoseconds = ( long ) ( ( ( unsigned long long ) cycles * portNSEC_PER_SEC ) / configCPU_CLOCK_HZ );
+
+	/* Spin on the host clock, as if the core ran at configCPU_CLOCK_HZ. */
+	clock_gettime( CLOCK_MONOTONIC, &xEnd );
+	xEnd.tv_sec += lNanoseconds / portNSEC_PER_SEC;
+	xEnd.tv_nsec += lNanoseconds % portNSEC_PER_SEC;
+	if( xEnd.tv_nsec >= portNSEC_PER_SEC )
+	{
+		xEnd.tv_nsec -= portNSEC_PER_SEC;
+		xEnd.tv_sec++;
+	}
+
+	do
+	{
+		clock_gettime( CLOCK_MONOTONIC, &xNow );
+	} while( ( xNow.tv_sec < xEnd.tv_sec ) ||
+	         ( ( xNow.tv_sec == xEnd.tv_sec ) && ( xNow.tv_nsec < xEnd.tv_nsec ) ) );
+}
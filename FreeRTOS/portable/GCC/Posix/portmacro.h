@@ -0,0 +1,238 @@
+/*
+ * FreeRTOS Kernel V10.0.0
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software. If you wish to use our Amazon
+ * FreeRTOS name, please do so in a fair use way that does not cause confusion.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+
+#ifndef PORTMACRO_H
+#define PORTMACRO_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PORT_ARCHITECTURE_NAME "Posix"
+
+/*-----------------------------------------------------------
+ * Port specific definitions.
+ *
+ * The settings in this file configure FreeRTOS correctly for the
+ * given hardware and compiler.
+ *
+ * This port runs the whole system inside a single Linux process. Every task
+ * gets its own ucontext, interrupts are simulated: they are dispatched when the
+ * running task leaves its outermost critical section, when the idle task
+ * sleeps and, with configUSE_PREEMPTION set to 1, from a SIGALRM timer at the
+ * tick rate (every millisecond with a high resolution timebase) that can switch
+ * tasks at any point. Without preemption a task spinning without calling into
+ * the kernel only sees the pending ticks when it calls into it again.
+ *
+ * As all the tasks share one host thread, host library calls that are not
+ * async signal safe (malloc, stdio) must be made in a critical section when
+ * several tasks use them.
+ *
+ * These settings should not be altered.
+ *-----------------------------------------------------------
+ */
+
+/* Type definitions. */
+#define portCHAR		char
+#define portFLOAT		float
+#define portDOUBLE		double
+#define portLONG		long
+#define portSHORT		short
+#define portSTACK_TYPE	uintptr_t
+#define portBASE_TYPE	long
+#define portPOINTER_SIZE_TYPE uintptr_t
+
+typedef portSTACK_TYPE StackType_t;
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+
+#if( configUSE_16_BIT_TICKS == 1 )
+	typedef uint16_t TickType_t;
+	#define portMAX_DELAY ( TickType_t ) 0xffff
+#else
+	typedef uint32_t TickType_t;
+	#define portMAX_DELAY ( TickType_t ) 0xffffffffUL
+
+	/* Only one task runs at a time and reads can not be torn by a simulated
+	interrupt, so reads of the tick count do not need a critical section. */
+	#define portTICK_TYPE_IS_ATOMIC 1
+#endif
+/*-----------------------------------------------------------*/
+
+/* Architecture specifics. */
+#define portSTACK_GROWTH			( -1 )
+#define portTICK_PERIOD_MS			( ( TickType_t ) 1000 / configTICK_RATE_HZ )
+#define portBYTE_ALIGNMENT			16
+
+/* The tasks do not run on the stack FreeRTOS allocates for them, it only holds
+a pointer to the host context. The real stack is allocated from the host heap
+and has this size (in bytes). */
+#ifndef configSIMULATOR_STACK_SIZE
+	#define configSIMULATOR_STACK_SIZE	( 64 * 1024 )
+#endif
+
+/* Size of the region handed to heap.c as __heap_base__/__heap_end__. */
+#ifndef configSIMULATOR_HEAP_SIZE
+	#define configSIMULATOR_HEAP_SIZE	( 1024 * 1024 )
+#endif
+/*-----------------------------------------------------------*/
+
+/* Scheduler utilities. Like on the Cortex-M ports a yield requested inside a
+critical section switches immediately, the critical nesting is saved per
+task. */
+extern void vPortYield( void );
+extern void vPortYieldFromISR( void );
+#define portYIELD()									vPortYield()
+#define portEND_SWITCHING_ISR( xSwitchRequired )	if( xSwitchRequired != pdFALSE ) vPortYieldFromISR()
+#define portYIELD_FROM_ISR( x )						portEND_SWITCHING_ISR( x )
+/*-----------------------------------------------------------*/
+
+/* Critical section management. */
+extern void vPortEnterCritical( void );
+extern void vPortExitCritical( void );
+extern uint32_t ulPortEnterCriticalFromISR( void );
+extern void vPortExitCriticalFromISR( uint32_t ulNesting );
+extern void vPortBusyDelay( unsigned long cycles );
+extern UBaseType_t uxCriticalNesting;
+extern volatile BaseType_t xPortInterruptActive;
+#define portSET_INTERRUPT_MASK_FROM_ISR()			ulPortEnterCriticalFromISR()
+#define portCLEAR_INTERRUPT_MASK_FROM_ISR(v)		vPortExitCriticalFromISR(v)
+#define portDISABLE_INTERRUPTS()					vPortEnterCritical()
+#define portENABLE_INTERRUPTS()						vPortExitCritical()
+#define portENTER_CRITICAL()						vPortEnterCritical()
+#define portEXIT_CRITICAL()							vPortExitCritical()
+
+/*-----------------------------------------------------------*/
+
+/* Simulated peripherals (serial sockets, console...) are polled by this
+handler. It runs in interrupt context once per tick and whenever the idle
+task wakes up. */
+extern void vPortSetInterruptHandler( void ( *pxHandler )( void ) );
+
+/* Waits for the next tick and dispatches the pending interrupts, called from
+the idle hook. */
+extern void vPortIdle( void );
+
+/* High resolution timebase: the tick count is derived from the host clock, the
+tick interrupt only fires when the kernel needs it. */
+extern TickType_t xPortGetUnprocessedTicks( void );
+#define portGET_UNPROCESSED_TICKS()					xPortGetUnprocessedTicks()
+
+/* Run time statistics count cycles of a core running at configCPU_CLOCK_HZ,
+derived from the host clock.  The time spent in critical sections entered by
+tasks is accumulated in ulPortCriticalRunTime. */
+#if( configGENERATE_RUN_TIME_STATS == 1 )
+	extern uint32_t ulPortGetRunTimeCounter( void );
+	extern volatile uint32_t ulPortCriticalRunTime;
+
+	#ifndef portCONFIGURE_TIMER_FOR_RUN_TIME_STATS
+		#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+		#define portGET_RUN_TIME_COUNTER_VALUE()			ulPortGetRunTimeCounter()
+	#endif
+#endif
+
+/* The host stack of a task is released when its TCB is deleted. */
+extern void vPortCleanUpTCB( void *pxTCB );
+#define portCLEAN_UP_TCB( pxTCB )					vPortCleanUpTCB( pxTCB )
+/*-----------------------------------------------------------*/
+
+/* Task function macros as described on the FreeRTOS.org WEB site.  These are
+not necessary for to use this port.  They are defined so the common demo files
+(which build with all the ports) will build. */
+#define portTASK_FUNCTION_PROTO( vFunction, pvParameters ) void vFunction( void *pvParameters )
+#define portTASK_FUNCTION( vFunction, pvParameters ) void vFunction( void *pvParameters )
+/*-----------------------------------------------------------*/
+
+/* Tickless idle: the idle task sleeps on the host clock instead of spinning. */
+#ifndef portSUPPRESS_TICKS_AND_SLEEP
+	extern void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime );
+	#define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime ) vPortSuppressTicksAndSleep( xExpectedIdleTime )
+#endif
+/*-----------------------------------------------------------*/
+
+/* Architecture specific optimisations. */
+#ifndef configUSE_PORT_OPTIMISED_TASK_SELECTION
+	#define configUSE_PORT_OPTIMISED_TASK_SELECTION 1
+#endif
+
+#if configUSE_PORT_OPTIMISED_TASK_SELECTION == 1
+
+	/* Check the configuration. */
+	#if( configMAX_PRIORITIES > 32 )
+		#error configUSE_PORT_OPTIMISED_TASK_SELECTION can only be set to 1 when configMAX_PRIORITIES is less than or equal to 32.  It is very rare that a system requires more than 10 to 15 difference priorities as tasks that share a priority will time slice.
+	#endif
+
+	/* Store/clear the ready priorities in a bit map. */
+	#define portRECORD_READY_PRIORITY( uxPriority, uxReadyPriorities ) ( uxReadyPriorities ) |= ( 1UL << ( uxPriority ) )
+	#define portRESET_READY_PRIORITY( uxPriority, uxReadyPriorities ) ( uxReadyPriorities ) &= ~( 1UL << ( uxPriority ) )
+
+	/*-----------------------------------------------------------*/
+
+	/* With configSIMULATOR_NO_CLZ set to 1 the search of the ports that have
+	no count leading zeros instruction (ARM_CM0) is used, to profile it. */
+	#ifndef configSIMULATOR_NO_CLZ
+		#define configSIMULATOR_NO_CLZ 0
+	#endif
+
+	#if( configSIMULATOR_NO_CLZ == 1 )
+		#define portGET_HIGHEST_PRIORITY( uxTopPriority, uxReadyPriorities ) uxTopPriority = uxPortGetHighestPriority( ( uint32_t ) ( uxReadyPriorities ) )
+	#else
+		#define portGET_HIGHEST_PRIORITY( uxTopPriority, uxReadyPriorities ) uxTopPriority = ( 31UL - ( uint32_t ) __builtin_clz( ( uint32_t ) ( uxReadyPriorities ) ) )
+	#endif
+
+#endif /* configUSE_PORT_OPTIMISED_TASK_SELECTION */
+
+/*-----------------------------------------------------------*/
+
+/* portNOP() is not required by this port. */
+#define portNOP()
+
+#define portINLINE	__inline
+
+#ifndef portFORCE_INLINE
+	#define portFORCE_INLINE inline __attribute__(( always_inline))
+#endif
+
+portFORCE_INLINE static BaseType_t xPortIsInsideInterrupt( void )
+{
+	return xPortInterruptActive;
+}
+/*-----------------------------------------------------------*/
+
+portFORCE_INLINE static BaseType_t xPortIsCriticalSection( void )
+{
+	return ( uxCriticalNesting > 0 ) ? pdTRUE : pdFALSE;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PORTMACRO_H */
+
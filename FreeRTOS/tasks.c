@@ -210,21 +210,64 @@ configIDLE_TASK_NAME in FreeRTOSConfig.h. */
 
 /*-----------------------------------------------------------*/
 
-/* pxDelayedTaskList and pxOverflowDelayedTaskList are switched when the tick
-count overflows. */
-#define taskSWITCH_DELAYED_LISTS()																	\
-{																									\
+#if( configUSE_TIMING_WHEEL == 1 )
+
+	/* The wheel has a level per configTIMING_WHEEL_SLOT_BITS bits of the tick
+	count, and a slot per value of these bits in each level. */
+	#define taskWHEEL_SLOT_BITS		( ( UBaseType_t ) configTIMING_WHEEL_SLOT_BITS )
+	#define taskWHEEL_SLOTS			( ( UBaseType_t ) 1U << taskWHEEL_SLOT_BITS )
+	#define taskWHEEL_LEVELS		( ( ( sizeof( TickType_t ) * 8U ) + configTIMING_WHEEL_SLOT_BITS - 1U ) / configTIMING_WHEEL_SLOT_BITS )
+
+	/* The time from which the tasks in a slot can be due: the wheel time above
+	the level, the slot number at the level and zeros below. */
+	#define taskWHEEL_SLOT_TIME( uxLevel, uxSlot )																		\
+		( ( xDelayedTaskWheelTime & ~( TickType_t ) ( ( ( TickType_t ) taskWHEEL_SLOTS << ( ( uxLevel ) * taskWHEEL_SLOT_BITS ) ) - ( TickType_t ) 1U ) ) |	\
+		  ( ( TickType_t ) ( uxSlot ) << ( ( uxLevel ) * taskWHEEL_SLOT_BITS ) ) )
+
+	/* Index of the lowest bit set in a non zero slot map.  The lowest bit is
+	isolated and multiplied by a de Bruijn sequence, which puts a different
+	value in the top five bits for each bit position. */
+	#define taskWHEEL_LOWEST_SET_BIT( ulMap ) ( ( UBaseType_t ) ucWheelDeBruijn[ ( uint32_t ) ( ( ( ulMap ) & ( 0UL - ( ulMap ) ) ) * 0x077CB531UL ) >> 27 ] )
+
+	/* The tasks whose wake time has overflowed are moved to the wheel when the
+	tick count overflows. */
+	#define taskSWITCH_DELAYED_LISTS()																\
+	{																								\
+	ListItem_t *pxItem;																				\
+																									\
+		/* The wheel should be empty when the tick count overflows. */								\
+		configASSERT( prvWheelGetNextUnblockTime() == portMAX_DELAY );								\
+																									\
+		xDelayedTaskWheelTime = ( TickType_t ) 0U;													\
+		while( listLIST_IS_EMPTY( &xOverflowDelayedTaskList ) == pdFALSE )							\
+		{																							\
+			pxItem = listGET_HEAD_ENTRY( &xOverflowDelayedTaskList );								\
+			( void ) uxListRemove( pxItem );														\
+			prvWheelInsert( pxItem );																\
+		}																							\
+		xNumOfOverflows++;																			\
+		prvResetNextTaskUnblockTime();																\
+	}
+
+#else
+
+	/* pxDelayedTaskList and pxOverflowDelayedTaskList are switched when the
+	tick count overflows. */
+	#define taskSWITCH_DELAYED_LISTS()																\
+	{																								\
 	List_t *pxTemp;																					\
 																									\
-	/* The delayed tasks list should be empty when the lists are switched. */						\
-	configASSERT( ( listLIST_IS_EMPTY( pxDelayedTaskList ) ) );										\
+		/* The delayed tasks list should be empty when the lists are switched. */					\
+		configASSERT( ( listLIST_IS_EMPTY( pxDelayedTaskList ) ) );									\
 																									\
-	pxTemp = pxDelayedTaskList;																		\
-	pxDelayedTaskList = pxOverflowDelayedTaskList;													\
-	pxOverflowDelayedTaskList = pxTemp;																\
-	xNumOfOverflows++;																				\
-	prvResetNextTaskUnblockTime();																	\
-}
+		pxTemp = pxDelayedTaskList;																	\
+		pxDelayedTaskList = pxOverflowDelayedTaskList;												\
+		pxOverflowDelayedTaskList = pxTemp;															\
+		xNumOfOverflows++;																			\
+		prvResetNextTaskUnblockTime();																\
+	}
+
+#endif /* configUSE_TIMING_WHEEL */
 
 /*-----------------------------------------------------------*/
 
@@ -322,8 +365,8 @@ typedef struct tskTaskControlBlock
 	#endif
 
 	#if( configUSE_TASK_NOTIFICATIONS == 1 )
-		volatile uint32_t ulNotifiedValue;
-		volatile uint8_t ucNotifyState;
+		volatile uint32_t ulNotifiedValue[ configTASK_NOTIFICATION_ARRAY_ENTRIES ];
+		volatile uint8_t ucNotifyState[ configTASK_NOTIFICATION_ARRAY_ENTRIES ];
 	#endif
 
 	/* See the comments above the definition of
@@ -335,6 +378,10 @@ typedef struct tskTaskControlBlock
 	#if( INCLUDE_xTaskAbortDelay == 1 )
 		uint8_t ucDelayAborted;
 	#endif
+
+	#if( configUSE_OSAL_MESSAGES == 1 )
+		void			*pvMsgQueue[ 2 ];	/*< The OSAL messages sent to the task, and a marker while it waits for one, see osal_ch_msg.c. */
+	#endif
 } tskTCB;
 
 /* The old tskTCB name is maintained above then typedefed to the new TCB_t name
@@ -348,10 +395,49 @@ PRIVILEGED_DATA TCB_t * volatile pxCurrentTCB = NULL;
 
 /* Lists for ready and blocked tasks. --------------------*/
 PRIVILEGED_DATA static List_t pxReadyTasksLists[ configMAX_PRIORITIES ];/*< Prioritised ready tasks. */
-PRIVILEGED_DATA static List_t xDelayedTaskList1;						/*< Delayed tasks. */
-PRIVILEGED_DATA static List_t xDelayedTaskList2;						/*< Delayed tasks (two lists are used - one for delays that have overflowed the current tick count. */
-PRIVILEGED_DATA static List_t * volatile pxDelayedTaskList;				/*< Points to the delayed task list currently being used. */
-PRIVILEGED_DATA static List_t * volatile pxOverflowDelayedTaskList;		/*< Points to the delayed task list currently being used to hold tasks that have overflowed the current tick count. */
+#if( configUSE_TIMING_WHEEL == 1 )
+
+	/* A delayed task is in the level of the highest bit group in which its
+	wake time differs from xDelayedTaskWheelTime, in the slot given by the value
+	of that group.  All the tasks of a level are due before the tasks of the
+	next one, and the tasks of a slot before the tasks of the next slot. */
+	PRIVILEGED_DATA static List_t xDelayedTaskWheel[ taskWHEEL_LEVELS ][ taskWHEEL_SLOTS ];	/*< Delayed tasks, not sorted within a slot. */
+	PRIVILEGED_DATA static uint32_t ulDelayedTaskWheelMap[ taskWHEEL_LEVELS ];				/*< Bit n is set if slot n of the level may hold tasks. */
+	PRIVILEGED_DATA static TickType_t xDelayedTaskWheelTime;									/*< The time tasks are placed relative to, never after the tick count. */
+	PRIVILEGED_DATA static List_t xOverflowDelayedTaskList;									/*< Delayed tasks that have overflowed the current tick count, not sorted. */
+
+	/* Bit positions for taskWHEEL_LOWEST_SET_BIT(). */
+	static const uint8_t ucWheelDeBruijn[ 32 ] =
+	{
+		0U, 1U, 28U, 2U, 29U, 14U, 24U, 3U, 30U, 22U, 20U, 15U, 25U, 17U, 4U, 8U,
+		31U, 27U, 13U, 23U, 21U, 19U, 16U, 7U, 26U, 12U, 18U, 6U, 11U, 5U, 10U, 9U
+	};
+
+	/* A task is delayed if its state list item is in a slot of the wheel or in
+	the overflow list. */
+	#define taskIS_DELAYED_TASK_LIST( pxList )																	\
+		( ( ( ( pxList ) >= &( xDelayedTaskWheel[ 0 ][ 0 ] ) ) &&												\
+			( ( pxList ) <= &( xDelayedTaskWheel[ taskWHEEL_LEVELS - 1U ][ taskWHEEL_SLOTS - 1U ] ) ) ) ||	\
+		  ( ( pxList ) == &xOverflowDelayedTaskList ) )
+
+	/* Both insertions are O(1), the overflow list is only walked when the tick
+	count overflows. */
+	#define taskINSERT_DELAYED_TASK( pxItem ) prvWheelInsert( pxItem )
+	#define taskINSERT_OVERFLOWED_DELAYED_TASK( pxItem ) vListInsertEnd( &xOverflowDelayedTaskList, ( pxItem ) )
+
+#else
+
+	PRIVILEGED_DATA static List_t xDelayedTaskList1;						/*< Delayed tasks. */
+	PRIVILEGED_DATA static List_t xDelayedTaskList2;						/*< Delayed tasks (two lists are used - one for delays that have overflowed the current tick count. */
+	PRIVILEGED_DATA static List_t * volatile pxDelayedTaskList;				/*< Points to the delayed task list currently being used. */
+	PRIVILEGED_DATA static List_t * volatile pxOverflowDelayedTaskList;		/*< Points to the delayed task list currently being used to hold tasks that have overflowed the current tick count. */
+
+	#define taskIS_DELAYED_TASK_LIST( pxList ) ( ( ( pxList ) == pxDelayedTaskList ) || ( ( pxList ) == pxOverflowDelayedTaskList ) )
+	#define taskINSERT_DELAYED_TASK( pxItem ) vListInsert( pxDelayedTaskList, ( pxItem ) )
+	#define taskINSERT_OVERFLOWED_DELAYED_TASK( pxItem ) vListInsert( pxOverflowDelayedTaskList, ( pxItem ) )
+
+#endif /* configUSE_TIMING_WHEEL */
+
 PRIVILEGED_DATA static List_t xPendingReadyList;						/*< Tasks that have been readied while the scheduler was suspended.  They will be moved to the ready list when the scheduler is resumed. */
 
 #if( INCLUDE_vTaskDelete == 1 )
@@ -379,6 +465,19 @@ PRIVILEGED_DATA static UBaseType_t uxTaskNumber 					= ( UBaseType_t ) 0U;
 PRIVILEGED_DATA static volatile TickType_t xNextTaskUnblockTime		= ( TickType_t ) 0U; /* Initialised to portMAX_DELAY before the scheduler starts. */
 PRIVILEGED_DATA static TaskHandle_t xIdleTaskHandle					= NULL;			/*< Holds the handle of the idle task.  The idle task is created automatically when the scheduler is started. */
 
+/* With a high resolution timebase xTickCount is only brought up to date when
+the port's compare interrupt fires.  Timeouts must be counted from the actual
+time, which the port can tell from its free running timer. */
+#if( configUSE_HIGH_RES_TIMEBASE == 1 )
+	#define prvGetTickCountNow() ( xTickCount + uxPendedTicks + portGET_UNPROCESSED_TICKS() )
+
+	/* The actual time can have wrapped before xTickCount has. */
+	#define prvGetOverflowCountNow( xNow ) ( xNumOfOverflows + ( ( ( xNow ) < xTickCount ) ? ( BaseType_t ) 1 : ( BaseType_t ) 0 ) )
+#else
+	#define prvGetTickCountNow() ( xTickCount )
+	#define prvGetOverflowCountNow( xNow ) ( xNumOfOverflows )
+#endif
+
 /* Context switches are held pending while the scheduler is suspended.  Also,
 interrupts must not manipulate the xStateListItem of a TCB, or any of the
 lists the xStateListItem can be referenced from, if the scheduler is suspended.
@@ -533,6 +632,31 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait, const BaseT
  */
 static void prvResetNextTaskUnblockTime( void );
 
+#if( configUSE_TIMING_WHEEL == 1 )
+
+	/*
+	 * Place a delayed task in the timing wheel, by the wake time held in its
+	 * state list item.
+	 */
+	static void prvWheelInsert( ListItem_t * const pxItem ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Move the tasks of the wheel slots that start at or before xTime to the
+	 * lower levels.  Returns the level 0 slot holding the tasks due at or
+	 * before xTime, NULL if no task is due.
+	 */
+	static List_t *prvWheelAdvance( const TickType_t xTime ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Return the start time of the first slot holding tasks, portMAX_DELAY if
+	 * the wheel is empty.  This is the wake time of the first delayed task if
+	 * the slot is in level 0, and a time before it otherwise.  The wheel is
+	 * only read so the function can be called from an interrupt.
+	 */
+	static TickType_t prvWheelGetNextUnblockTime( void ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_TIMING_WHEEL */
+
 #if ( ( configUSE_TRACE_FACILITY == 1 ) && ( configUSE_STATS_FORMATTING_FUNCTIONS > 0 ) )
 
 	/*
@@ -976,8 +1100,11 @@ UBaseType_t x;
 
 	#if ( configUSE_TASK_NOTIFICATIONS == 1 )
 	{
-		pxNewTCB->ulNotifiedValue = 0;
-		pxNewTCB->ucNotifyState = taskNOT_WAITING_NOTIFICATION;
+		for( x = 0; x < ( UBaseType_t ) configTASK_NOTIFICATION_ARRAY_ENTRIES; x++ )
+		{
+			pxNewTCB->ulNotifiedValue[ x ] = 0;
+			pxNewTCB->ucNotifyState[ x ] = taskNOT_WAITING_NOTIFICATION;
+		}
 	}
 	#endif
 
@@ -994,6 +1121,13 @@ UBaseType_t x;
 	}
 	#endif
 
+	#if( configUSE_OSAL_MESSAGES == 1 )
+	{
+		pxNewTCB->pvMsgQueue[ 0 ] = NULL;
+		pxNewTCB->pvMsgQueue[ 1 ] = NULL;
+	}
+	#endif
+
 	/* Initialize the TCB stack to look as if the task was already running,
 	but had been interrupted by the scheduler.  The return address is set
 	to the start of the task function. Once the stack has been initialised
@@ -1211,7 +1345,7 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 		{
 			/* Minor optimisation.  The tick count cannot change in this
 			block. */
-			const TickType_t xConstTickCount = xTickCount;
+			const TickType_t xConstTickCount = prvGetTickCountNow();
 
 			/* Generate the tick time at which the task wants to wake. */
 			xTimeToWake = *pxPreviousWakeTime + xTimeIncrement;
@@ -1348,7 +1482,7 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 			}
 			taskEXIT_CRITICAL();
 
-			if( ( pxStateList == pxDelayedTaskList ) || ( pxStateList == pxOverflowDelayedTaskList ) )
+			if( taskIS_DELAYED_TASK_LIST( pxStateList ) )
 			{
 				/* The task being queried is referenced from one of the Blocked
 				lists. */
@@ -1661,11 +1795,16 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 
 			#if( configUSE_TASK_NOTIFICATIONS == 1 )
 			{
-				if( pxTCB->ucNotifyState == taskWAITING_NOTIFICATION )
+			UBaseType_t x;
+
+				for( x = 0; x < ( UBaseType_t ) configTASK_NOTIFICATION_ARRAY_ENTRIES; x++ )
 				{
-					/* The task was blocked to wait for a notification, but is
-					now suspended, so no notification was received. */
-					pxTCB->ucNotifyState = taskNOT_WAITING_NOTIFICATION;
+					if( pxTCB->ucNotifyState[ x ] == taskWAITING_NOTIFICATION )
+					{
+						/* The task was blocked to wait for a notification, but is
+						now suspended, so no notification was received. */
+						pxTCB->ucNotifyState[ x ] = taskNOT_WAITING_NOTIFICATION;
+					}
 				}
 			}
 			#endif
@@ -2212,7 +2351,7 @@ TickType_t xTicks;
 	/* Critical section required if running on a 16 bit processor. */
 	portTICK_TYPE_ENTER_CRITICAL();
 	{
-		xTicks = xTickCount;
+		xTicks = prvGetTickCountNow();
 	}
 	portTICK_TYPE_EXIT_CRITICAL();
 
@@ -2243,7 +2382,7 @@ UBaseType_t uxSavedInterruptStatus;
 
 	uxSavedInterruptStatus = portTICK_TYPE_SET_INTERRUPT_MASK_FROM_ISR();
 	{
-		xReturn = xTickCount;
+		xReturn = prvGetTickCountNow();
 	}
 	portTICK_TYPE_CLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
 
@@ -2359,15 +2498,36 @@ TCB_t *pxTCB;
 			} while( uxQueue > ( UBaseType_t ) tskIDLE_PRIORITY ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
 
 			/* Search the delayed lists. */
-			if( pxTCB == NULL )
+			#if( configUSE_TIMING_WHEEL == 1 )
 			{
-				pxTCB = prvSearchForNameWithinSingleList( ( List_t * ) pxDelayedTaskList, pcNameToQuery );
-			}
+			UBaseType_t uxLevel, uxSlot;
+
+				for( uxLevel = ( UBaseType_t ) 0U; ( uxLevel < ( UBaseType_t ) taskWHEEL_LEVELS ) && ( pxTCB == NULL ); uxLevel++ )
+				{
+					for( uxSlot = ( UBaseType_t ) 0U; ( uxSlot < taskWHEEL_SLOTS ) && ( pxTCB == NULL ); uxSlot++ )
+					{
+						pxTCB = prvSearchForNameWithinSingleList( &( xDelayedTaskWheel[ uxLevel ][ uxSlot ] ), pcNameToQuery );
+					}
+				}
 
-			if( pxTCB == NULL )
+				if( pxTCB == NULL )
+				{
+					pxTCB = prvSearchForNameWithinSingleList( &xOverflowDelayedTaskList, pcNameToQuery );
+				}
+			}
+			#else
 			{
-				pxTCB = prvSearchForNameWithinSingleList( ( List_t * ) pxOverflowDelayedTaskList, pcNameToQuery );
+				if( pxTCB == NULL )
+				{
+					pxTCB = prvSearchForNameWithinSingleList( ( List_t * ) pxDelayedTaskList, pcNameToQuery );
+				}
+
+				if( pxTCB == NULL )
+				{
+					pxTCB = prvSearchForNameWithinSingleList( ( List_t * ) pxOverflowDelayedTaskList, pcNameToQuery );
+				}
 			}
+			#endif /* configUSE_TIMING_WHEEL */
 
 			#if ( INCLUDE_vTaskSuspend == 1 )
 			{
@@ -2419,8 +2579,26 @@ TCB_t *pxTCB;
 
 				/* Fill in an TaskStatus_t structure with information on each
 				task in the Blocked state. */
-				uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), ( List_t * ) pxDelayedTaskList, eBlocked );
-				uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), ( List_t * ) pxOverflowDelayedTaskList, eBlocked );
+				#if( configUSE_TIMING_WHEEL == 1 )
+				{
+				UBaseType_t uxLevel, uxSlot;
+
+					for( uxLevel = ( UBaseType_t ) 0U; uxLevel < ( UBaseType_t ) taskWHEEL_LEVELS; uxLevel++ )
+					{
+						for( uxSlot = ( UBaseType_t ) 0U; uxSlot < taskWHEEL_SLOTS; uxSlot++ )
+						{
+							uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), &( xDelayedTaskWheel[ uxLevel ][ uxSlot ] ), eBlocked );
+						}
+					}
+
+					uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), &xOverflowDelayedTaskList, eBlocked );
+				}
+				#else
+				{
+					uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), ( List_t * ) pxDelayedTaskList, eBlocked );
+					uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), ( List_t * ) pxOverflowDelayedTaskList, eBlocked );
+				}
+				#endif /* configUSE_TIMING_WHEEL */
 
 				#if( INCLUDE_vTaskDelete == 1 )
 				{
@@ -2582,7 +2760,11 @@ implementations require configUSE_TICKLESS_IDLE to be set to a value other than
 BaseType_t xTaskIncrementTick( void )
 {
 TCB_t * pxTCB;
-TickType_t xItemValue;
+#if( configUSE_TIMING_WHEEL == 1 )
+	List_t *pxDueList;
+#else
+	TickType_t xItemValue;
+#endif
 BaseType_t xSwitchRequired = pdFALSE;
 
 	/* Called by the portable layer each time a tick interrupt occurs.
@@ -2616,77 +2798,101 @@ BaseType_t xSwitchRequired = pdFALSE;
 		{
 			for( ;; )
 			{
-				if( listLIST_IS_EMPTY( pxDelayedTaskList ) != pdFALSE )
+				#if( configUSE_TIMING_WHEEL == 1 )
 				{
-					/* The delayed list is empty.  Set xNextTaskUnblockTime
-					to the maximum possible value so it is extremely
-					unlikely that the
-					if( xTickCount >= xNextTaskUnblockTime ) test will pass
-					next time through. */
-					xNextTaskUnblockTime = portMAX_DELAY; /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
-					break;
-				}
-				else
-				{
-					/* The delayed list is not empty, get the value of the
-					item at the head of the delayed list.  This is the time
-					at which the task at the head of the delayed list must
-					be removed from the Blocked state. */
-					pxTCB = ( TCB_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxDelayedTaskList );
-					xItemValue = listGET_LIST_ITEM_VALUE( &( pxTCB->xStateListItem ) );
-
-					if( xConstTickCount < xItemValue )
+					/* Bring the tasks due now to level 0 of the wheel, the
+					slot they are in is returned. */
+					pxDueList = prvWheelAdvance( xConstTickCount );
+
+					if( pxDueList == NULL )
 					{
-						/* It is not time to unblock this item yet, but the
-						item value is the time at which the task at the head
-						of the blocked list must be removed from the Blocked
-						state -	so record the item value in
-						xNextTaskUnblockTime. */
-						xNextTaskUnblockTime = xItemValue;
+						/* No task is due, the first slot holding tasks
+						starts after the tick count.  It is reached, and
+						spread over the lower levels if needed, at its start
+						time. */
+						xNextTaskUnblockTime = prvWheelGetNextUnblockTime();
 						break;
 					}
 					else
 					{
-						mtCOVERAGE_TEST_MARKER();
+						pxTCB = ( TCB_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxDueList );
 					}
-
-					/* It is time to remove the item from the Blocked state. */
-					( void ) uxListRemove( &( pxTCB->xStateListItem ) );
-
-					/* Is the task waiting on an event also?  If so remove
-					it from the event list. */
-					if( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) != NULL )
+				}
+				#else
+				{
+					if( listLIST_IS_EMPTY( pxDelayedTaskList ) != pdFALSE )
 					{
-						( void ) uxListRemove( &( pxTCB->xEventListItem ) );
+						/* The delayed list is empty.  Set xNextTaskUnblockTime
+						to the maximum possible value so it is extremely
+						unlikely that the
+						if( xTickCount >= xNextTaskUnblockTime ) test will pass
+						next time through. */
+						xNextTaskUnblockTime = portMAX_DELAY; /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+						break;
 					}
 					else
 					{
-						mtCOVERAGE_TEST_MARKER();
-					}
-
-					/* Place the unblocked task into the appropriate ready
-					list. */
-					prvAddTaskToReadyList( pxTCB );
-
-					/* A task being unblocked cannot cause an immediate
-					context switch if preemption is turned off. */
-					#if (  configUSE_PREEMPTION == 1 )
-					{
-						/* Preemption is on, but a context switch should
-						only be performed if the unblocked task has a
-						priority that is equal to or higher than the
-						currently executing task. */
-						if( pxTCB->uxPriority >= pxCurrentTCB->uxPriority )
+						/* The delayed list is not empty, get the value of the
+						item at the head of the delayed list.  This is the time
+						at which the task at the head of the delayed list must
+						be removed from the Blocked state. */
+						pxTCB = ( TCB_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxDelayedTaskList );
+						xItemValue = listGET_LIST_ITEM_VALUE( &( pxTCB->xStateListItem ) );
+
+						if( xConstTickCount < xItemValue )
 						{
-							xSwitchRequired = pdTRUE;
+							/* It is not time to unblock this item yet, but the
+							item value is the time at which the task at the head
+							of the blocked list must be removed from the Blocked
+							state -	so record the item value in
+							xNextTaskUnblockTime. */
+							xNextTaskUnblockTime = xItemValue;
+							break;
 						}
 						else
 						{
 							mtCOVERAGE_TEST_MARKER();
 						}
 					}
-					#endif /* configUSE_PREEMPTION */
 				}
+				#endif /* configUSE_TIMING_WHEEL */
+
+				/* It is time to remove the item from the Blocked state. */
+				( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+
+				/* Is the task waiting on an event also?  If so remove
+				it from the event list. */
+				if( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) != NULL )
+				{
+					( void ) uxListRemove( &( pxTCB->xEventListItem ) );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				/* Place the unblocked task into the appropriate ready
+				list. */
+				prvAddTaskToReadyList( pxTCB );
+
+				/* A task being unblocked cannot cause an immediate
+				context switch if preemption is turned off. */
+				#if (  configUSE_PREEMPTION == 1 )
+				{
+					/* Preemption is on, but a context switch should
+					only be performed if the unblocked task has a
+					priority that is equal to or higher than the
+					currently executing task. */
+					if( pxTCB->uxPriority >= pxCurrentTCB->uxPriority )
+					{
+						xSwitchRequired = pdTRUE;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				#endif /* configUSE_PREEMPTION */
 			}
 		}
 
@@ -2751,6 +2957,77 @@ BaseType_t xSwitchRequired = pdFALSE;
 }
 /*-----------------------------------------------------------*/
 
+#if( configUSE_HIGH_RES_TIMEBASE == 1 )
+
+	BaseType_t xTaskIncrementTickBy( TickType_t xTicks )
+	{
+	BaseType_t xSwitchRequired = pdFALSE;
+	TickType_t xJump;
+
+		/* Called by the portable layer with interrupts masked, xTicks ticks
+		passed since the last call. */
+		while( xTicks > ( TickType_t ) 0U )
+		{
+			/* Skip the ticks that cannot unblock a task.  The tick that
+			reaches xNextTaskUnblockTime, or that overflows the tick count, is
+			always processed by xTaskIncrementTick(). */
+			if( ( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE ) && ( xNextTaskUnblockTime > xTickCount ) )
+			{
+				xJump = xNextTaskUnblockTime - xTickCount - ( TickType_t ) 1U;
+				if( xJump > xTicks - ( TickType_t ) 1U )
+				{
+					xJump = xTicks - ( TickType_t ) 1U;
+				}
+
+				xTickCount += xJump;
+				traceINCREASE_TICK_COUNT( xJump );
+				xTicks -= xJump;
+			}
+			else if( uxSchedulerSuspended != ( UBaseType_t ) pdFALSE )
+			{
+				/* They are counted now and processed by xTaskResumeAll(). */
+				uxPendedTicks += xTicks - ( TickType_t ) 1U;
+				xTicks = ( TickType_t ) 1U;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			if( xTaskIncrementTick() != pdFALSE )
+			{
+				xSwitchRequired = pdTRUE;
+			}
+
+			xTicks--;
+		}
+
+		return xSwitchRequired;
+	}
+
+#endif /* configUSE_HIGH_RES_TIMEBASE */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_HIGH_RES_TIMEBASE == 1 )
+
+	TickType_t xTaskGetTicksToNextUnblock( void )
+	{
+	TickType_t xReturn = ( TickType_t ) 1U;
+
+		/* Called by the portable layer with interrupts masked to program the
+		next compare event.  While the scheduler is suspended the ticks are
+		only counted, one tick is as good as any other. */
+		if( ( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE ) && ( xNextTaskUnblockTime > xTickCount ) )
+		{
+			xReturn = xNextTaskUnblockTime - xTickCount;
+		}
+
+		return xReturn;
+	}
+
+#endif /* configUSE_HIGH_RES_TIMEBASE */
+/*-----------------------------------------------------------*/
+
 #if ( configUSE_APPLICATION_TASK_TAG == 1 )
 
 	void vTaskSetApplicationTaskTag( TaskHandle_t xTask, TaskHookFunction_t pxHookFunction )
@@ -3081,8 +3358,7 @@ void vTaskSetTimeOutState( TimeOut_t * const pxTimeOut )
 	configASSERT( pxTimeOut );
 	taskENTER_CRITICAL();
 	{
-		pxTimeOut->xOverflowCount = xNumOfOverflows;
-		pxTimeOut->xTimeOnEntering = xTickCount;
+		vTaskInternalSetTimeOutState( pxTimeOut );
 	}
 	taskEXIT_CRITICAL();
 }
@@ -3090,9 +3366,11 @@ void vTaskSetTimeOutState( TimeOut_t * const pxTimeOut )
 
 void vTaskInternalSetTimeOutState( TimeOut_t * const pxTimeOut )
 {
+const TickType_t xConstTickCount = prvGetTickCountNow();
+
 	/* For internal use only as it does not use a critical section. */
-	pxTimeOut->xOverflowCount = xNumOfOverflows;
-	pxTimeOut->xTimeOnEntering = xTickCount;
+	pxTimeOut->xOverflowCount = prvGetOverflowCountNow( xConstTickCount );
+	pxTimeOut->xTimeOnEntering = xConstTickCount;
 }
 /*-----------------------------------------------------------*/
 
@@ -3105,8 +3383,10 @@ BaseType_t xReturn;
 
 	taskENTER_CRITICAL();
 	{
-		/* Minor optimisation.  The tick count cannot change in this block. */
-		const TickType_t xConstTickCount = xTickCount;
+		/* Minor optimisation.  The tick count cannot change in this block,
+		the actual time is read once. */
+		const TickType_t xConstTickCount = prvGetTickCountNow();
+		const BaseType_t xConstOverflowCount = prvGetOverflowCountNow( xConstTickCount );
 		const TickType_t xElapsedTime = xConstTickCount - pxTimeOut->xTimeOnEntering;
 
 		#if( INCLUDE_xTaskAbortDelay == 1 )
@@ -3131,7 +3411,7 @@ BaseType_t xReturn;
 			else
 		#endif
 
-		if( ( xNumOfOverflows != pxTimeOut->xOverflowCount ) && ( xConstTickCount >= pxTimeOut->xTimeOnEntering ) ) /*lint !e525 Indentation preferred as is to make code within pre-processor directives clearer. */
+		if( ( xConstOverflowCount != pxTimeOut->xOverflowCount ) && ( xConstTickCount >= pxTimeOut->xTimeOnEntering ) ) /*lint !e525 Indentation preferred as is to make code within pre-processor directives clearer. */
 		{
 			/* The tick count is greater than the time at which
 			vTaskSetTimeout() was called, but has also overflowed since
@@ -3144,7 +3424,8 @@ BaseType_t xReturn;
 		{
 			/* Not a genuine timeout. Adjust parameters for time remaining. */
 			*pxTicksToWait -= xElapsedTime;
-			vTaskInternalSetTimeOutState( pxTimeOut );
+			pxTimeOut->xOverflowCount = xConstOverflowCount;
+			pxTimeOut->xTimeOnEntering = xConstTickCount;
 			xReturn = pdFALSE;
 		}
 		else
@@ -3349,6 +3630,12 @@ static portTASK_FUNCTION( prvIdleTask, pvParameters )
 			/* A yield was pended while the scheduler was suspended. */
 			eReturn = eAbortSleep;
 		}
+		else if( uxPendedTicks != ( UBaseType_t ) 0U )
+		{
+			/* A tick interrupt occurred while the scheduler was suspended, the
+			expected idle time no longer starts from the current tick count. */
+			eReturn = eAbortSleep;
+		}
 		else
 		{
 			/* If all the tasks are in the suspended list (which might mean they
@@ -3435,8 +3722,29 @@ UBaseType_t uxPriority;
 		vListInitialise( &( pxReadyTasksLists[ uxPriority ] ) );
 	}
 
-	vListInitialise( &xDelayedTaskList1 );
-	vListInitialise( &xDelayedTaskList2 );
+	#if( configUSE_TIMING_WHEEL == 1 )
+	{
+	UBaseType_t uxLevel, uxSlot;
+
+		for( uxLevel = ( UBaseType_t ) 0U; uxLevel < ( UBaseType_t ) taskWHEEL_LEVELS; uxLevel++ )
+		{
+			for( uxSlot = ( UBaseType_t ) 0U; uxSlot < taskWHEEL_SLOTS; uxSlot++ )
+			{
+				vListInitialise( &( xDelayedTaskWheel[ uxLevel ][ uxSlot ] ) );
+			}
+
+			ulDelayedTaskWheelMap[ uxLevel ] = 0UL;
+		}
+
+		xDelayedTaskWheelTime = xTickCount;
+		vListInitialise( &xOverflowDelayedTaskList );
+	}
+	#else
+	{
+		vListInitialise( &xDelayedTaskList1 );
+		vListInitialise( &xDelayedTaskList2 );
+	}
+	#endif /* configUSE_TIMING_WHEEL */
 	vListInitialise( &xPendingReadyList );
 
 	#if ( INCLUDE_vTaskDelete == 1 )
@@ -3451,10 +3759,14 @@ UBaseType_t uxPriority;
 	}
 	#endif /* INCLUDE_vTaskSuspend */
 
-	/* Start with pxDelayedTaskList using list1 and the pxOverflowDelayedTaskList
-	using list2. */
-	pxDelayedTaskList = &xDelayedTaskList1;
-	pxOverflowDelayedTaskList = &xDelayedTaskList2;
+	#if( configUSE_TIMING_WHEEL == 0 )
+	{
+		/* Start with pxDelayedTaskList using list1 and the
+		pxOverflowDelayedTaskList using list2. */
+		pxDelayedTaskList = &xDelayedTaskList1;
+		pxOverflowDelayedTaskList = &xDelayedTaskList2;
+	}
+	#endif /* configUSE_TIMING_WHEEL */
 }
 /*-----------------------------------------------------------*/
 
@@ -3720,28 +4032,174 @@ static void prvCheckTasksWaitingTermination( void )
 #endif /* INCLUDE_vTaskDelete */
 /*-----------------------------------------------------------*/
 
-static void prvResetNextTaskUnblockTime( void )
-{
-TCB_t *pxTCB;
+#if( configUSE_TIMING_WHEEL == 1 )
 
-	if( listLIST_IS_EMPTY( pxDelayedTaskList ) != pdFALSE )
+	static void prvResetNextTaskUnblockTime( void )
 	{
-		/* The new current delayed list is empty.  Set xNextTaskUnblockTime to
-		the maximum possible value so it is	extremely unlikely that the
-		if( xTickCount >= xNextTaskUnblockTime ) test will pass until
-		there is an item in the delayed list. */
-		xNextTaskUnblockTime = portMAX_DELAY;
+	TickType_t xNextUnblockTime;
+
+		/* The first slot holding tasks may have started before the tick
+		count if it is not in level 0.  The tick handler spreads it over the
+		lower levels on the next tick. */
+		xNextUnblockTime = prvWheelGetNextUnblockTime();
+
+		if( xNextUnblockTime < xTickCount )
+		{
+			xNextUnblockTime = xTickCount;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		xNextTaskUnblockTime = xNextUnblockTime;
 	}
-	else
+
+#else
+
+	static void prvResetNextTaskUnblockTime( void )
 	{
-		/* The new current delayed list is not empty, get the value of
-		the item at the head of the delayed list.  This is the time at
-		which the task at the head of the delayed list should be removed
-		from the Blocked state. */
-		( pxTCB ) = ( TCB_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxDelayedTaskList );
-		xNextTaskUnblockTime = listGET_LIST_ITEM_VALUE( &( ( pxTCB )->xStateListItem ) );
+	TCB_t *pxTCB;
+
+		if( listLIST_IS_EMPTY( pxDelayedTaskList ) != pdFALSE )
+		{
+			/* The new current delayed list is empty.  Set xNextTaskUnblockTime to
+			the maximum possible value so it is	extremely unlikely that the
+			if( xTickCount >= xNextTaskUnblockTime ) test will pass until
+			there is an item in the delayed list. */
+			xNextTaskUnblockTime = portMAX_DELAY;
+		}
+		else
+		{
+			/* The new current delayed list is not empty, get the value of
+			the item at the head of the delayed list.  This is the time at
+			which the task at the head of the delayed list should be removed
+			from the Blocked state. */
+			( pxTCB ) = ( TCB_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxDelayedTaskList );
+			xNextTaskUnblockTime = listGET_LIST_ITEM_VALUE( &( ( pxTCB )->xStateListItem ) );
+		}
 	}
-}
+
+#endif /* configUSE_TIMING_WHEEL */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_TIMING_WHEEL == 1 )
+
+	static void prvWheelInsert( ListItem_t * const pxItem )
+	{
+	const TickType_t xTimeToWake = listGET_LIST_ITEM_VALUE( pxItem );
+	TickType_t xDifference = xTimeToWake ^ xDelayedTaskWheelTime;
+	UBaseType_t uxLevel = ( UBaseType_t ) 0U, uxSlot;
+
+		/* The level is the highest group of bits in which the wake time
+		differs from the wheel time, the slot is the value of that group. */
+		while( xDifference >= ( TickType_t ) taskWHEEL_SLOTS )
+		{
+			xDifference >>= taskWHEEL_SLOT_BITS;
+			uxLevel++;
+		}
+
+		uxSlot = ( UBaseType_t ) ( xTimeToWake >> ( uxLevel * taskWHEEL_SLOT_BITS ) ) & ( taskWHEEL_SLOTS - 1U );
+
+		vListInsertEnd( &( xDelayedTaskWheel[ uxLevel ][ uxSlot ] ), pxItem );
+		ulDelayedTaskWheelMap[ uxLevel ] |= ( uint32_t ) 1U << uxSlot;
+	}
+	/*-----------------------------------------------------------*/
+
+	static List_t *prvWheelAdvance( const TickType_t xTime )
+	{
+	List_t *pxSlotList, *pxDueList = NULL;
+	ListItem_t *pxItem;
+	UBaseType_t uxLevel = ( UBaseType_t ) 0U, uxSlot;
+	TickType_t xSlotTime;
+
+		while( ( uxLevel < ( UBaseType_t ) taskWHEEL_LEVELS ) && ( pxDueList == NULL ) )
+		{
+			if( ulDelayedTaskWheelMap[ uxLevel ] == 0UL )
+			{
+				uxLevel++;
+			}
+			else
+			{
+				uxSlot = taskWHEEL_LOWEST_SET_BIT( ulDelayedTaskWheelMap[ uxLevel ] );
+				pxSlotList = &( xDelayedTaskWheel[ uxLevel ][ uxSlot ] );
+				xSlotTime = taskWHEEL_SLOT_TIME( uxLevel, uxSlot );
+
+				if( listLIST_IS_EMPTY( pxSlotList ) != pdFALSE )
+				{
+					/* The tasks left the slot before their timeout,
+					uxListRemove() does not clear the bit. */
+					ulDelayedTaskWheelMap[ uxLevel ] &= ~( ( uint32_t ) 1U << uxSlot );
+				}
+				else if( xSlotTime > xTime )
+				{
+					/* No task is due, the following slots start later. */
+					break;
+				}
+				else if( uxLevel == ( UBaseType_t ) 0U )
+				{
+					/* The slot time is the wake time of all its tasks. */
+					pxDueList = pxSlotList;
+				}
+				else
+				{
+					/* Nothing is left before the slot, so the wheel time can
+					move to its start.  Its tasks then differ from the wheel
+					time in the lower bit groups only, and are spread over the
+					lower levels. */
+					ulDelayedTaskWheelMap[ uxLevel ] &= ~( ( uint32_t ) 1U << uxSlot );
+					xDelayedTaskWheelTime = xSlotTime;
+
+					while( listLIST_IS_EMPTY( pxSlotList ) == pdFALSE )
+					{
+						pxItem = listGET_HEAD_ENTRY( pxSlotList );
+						( void ) uxListRemove( pxItem );
+						prvWheelInsert( pxItem );
+					}
+
+					uxLevel = ( UBaseType_t ) 0U;
+				}
+			}
+		}
+
+		return pxDueList;
+	}
+	/*-----------------------------------------------------------*/
+
+	static TickType_t prvWheelGetNextUnblockTime( void )
+	{
+	TickType_t xReturn = portMAX_DELAY;
+	UBaseType_t uxLevel, uxSlot;
+	uint32_t ulMap;
+
+		for( uxLevel = ( UBaseType_t ) 0U; uxLevel < ( UBaseType_t ) taskWHEEL_LEVELS; uxLevel++ )
+		{
+			ulMap = ulDelayedTaskWheelMap[ uxLevel ];
+
+			/* Skip the slots the tasks left before their timeout. */
+			while( ulMap != 0UL )
+			{
+				uxSlot = taskWHEEL_LOWEST_SET_BIT( ulMap );
+
+				if( listLIST_IS_EMPTY( &( xDelayedTaskWheel[ uxLevel ][ uxSlot ] ) ) == pdFALSE )
+				{
+					xReturn = taskWHEEL_SLOT_TIME( uxLevel, uxSlot );
+					break;
+				}
+
+				ulMap &= ulMap - 1UL;
+			}
+
+			if( ulMap != 0UL )
+			{
+				break;
+			}
+		}
+
+		return xReturn;
+	}
+
+#endif /* configUSE_TIMING_WHEEL */
 /*-----------------------------------------------------------*/
 
 #if ( ( INCLUDE_xTaskGetCurrentTaskHandle == 1 ) || ( configUSE_MUTEXES == 1 ) )
@@ -4402,17 +4860,19 @@ TickType_t uxReturn;
 
 #if( configUSE_TASK_NOTIFICATIONS == 1 )
 
-	uint32_t ulTaskNotifyTake( BaseType_t xClearCountOnExit, TickType_t xTicksToWait )
+	uint32_t ulTaskGenericNotifyTake( UBaseType_t uxIndexToWait, BaseType_t xClearCountOnExit, TickType_t xTicksToWait )
 	{
 	uint32_t ulReturn;
 
+		configASSERT( uxIndexToWait < configTASK_NOTIFICATION_ARRAY_ENTRIES );
+
 		taskENTER_CRITICAL();
 		{
 			/* Only block if the notification count is not already non-zero. */
-			if( pxCurrentTCB->ulNotifiedValue == 0UL )
+			if( pxCurrentTCB->ulNotifiedValue[ uxIndexToWait ] == 0UL )
 			{
 				/* Mark this task as waiting for a notification. */
-				pxCurrentTCB->ucNotifyState = taskWAITING_NOTIFICATION;
+				pxCurrentTCB->ucNotifyState[ uxIndexToWait ] = taskWAITING_NOTIFICATION;
 
 				if( xTicksToWait > ( TickType_t ) 0 )
 				{
@@ -4440,17 +4900,17 @@ TickType_t uxReturn;
 		taskENTER_CRITICAL();
 		{
 			traceTASK_NOTIFY_TAKE();
-			ulReturn = pxCurrentTCB->ulNotifiedValue;
+			ulReturn = pxCurrentTCB->ulNotifiedValue[ uxIndexToWait ];
 
 			if( ulReturn != 0UL )
 			{
 				if( xClearCountOnExit != pdFALSE )
 				{
-					pxCurrentTCB->ulNotifiedValue = 0UL;
+					pxCurrentTCB->ulNotifiedValue[ uxIndexToWait ] = 0UL;
 				}
 				else
 				{
-					pxCurrentTCB->ulNotifiedValue = ulReturn - ( uint32_t ) 1;
+					pxCurrentTCB->ulNotifiedValue[ uxIndexToWait ] = ulReturn - ( uint32_t ) 1;
 				}
 			}
 			else
@@ -4458,7 +4918,7 @@ TickType_t uxReturn;
 				mtCOVERAGE_TEST_MARKER();
 			}
 
-			pxCurrentTCB->ucNotifyState = taskNOT_WAITING_NOTIFICATION;
+			pxCurrentTCB->ucNotifyState[ uxIndexToWait ] = taskNOT_WAITING_NOTIFICATION;
 		}
 		taskEXIT_CRITICAL();
 
@@ -4470,22 +4930,24 @@ TickType_t uxReturn;
 
 #if( configUSE_TASK_NOTIFICATIONS == 1 )
 
-	BaseType_t xTaskNotifyWait( uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClearOnExit, uint32_t *pulNotificationValue, TickType_t xTicksToWait )
+	BaseType_t xTaskGenericNotifyWait( UBaseType_t uxIndexToWait, uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClearOnExit, uint32_t *pulNotificationValue, TickType_t xTicksToWait )
 	{
 	BaseType_t xReturn;
 
+		configASSERT( uxIndexToWait < configTASK_NOTIFICATION_ARRAY_ENTRIES );
+
 		taskENTER_CRITICAL();
 		{
 			/* Only block if a notification is not already pending. */
-			if( pxCurrentTCB->ucNotifyState != taskNOTIFICATION_RECEIVED )
+			if( pxCurrentTCB->ucNotifyState[ uxIndexToWait ] != taskNOTIFICATION_RECEIVED )
 			{
 				/* Clear bits in the task's notification value as bits may get
 				set	by the notifying task or interrupt.  This can be used to
 				clear the value to zero. */
-				pxCurrentTCB->ulNotifiedValue &= ~ulBitsToClearOnEntry;
+				pxCurrentTCB->ulNotifiedValue[ uxIndexToWait ] &= ~ulBitsToClearOnEntry;
 
 				/* Mark this task as waiting for a notification. */
-				pxCurrentTCB->ucNotifyState = taskWAITING_NOTIFICATION;
+				pxCurrentTCB->ucNotifyState[ uxIndexToWait ] = taskWAITING_NOTIFICATION;
 
 				if( xTicksToWait > ( TickType_t ) 0 )
 				{
@@ -4518,14 +4980,14 @@ TickType_t uxReturn;
 			{
 				/* Output the current notification value, which may or may not
 				have changed. */
-				*pulNotificationValue = pxCurrentTCB->ulNotifiedValue;
+				*pulNotificationValue = pxCurrentTCB->ulNotifiedValue[ uxIndexToWait ];
 			}
 
 			/* If ucNotifyValue is set then either the task never entered the
 			blocked state (because a notification was already pending) or the
 			task unblocked because of a notification.  Otherwise the task
 			unblocked because of a timeout. */
-			if( pxCurrentTCB->ucNotifyState != taskNOTIFICATION_RECEIVED )
+			if( pxCurrentTCB->ucNotifyState[ uxIndexToWait ] != taskNOTIFICATION_RECEIVED )
 			{
 				/* A notification was not received. */
 				xReturn = pdFALSE;
@@ -4534,11 +4996,11 @@ TickType_t uxReturn;
 			{
 				/* A notification was already pending or a notification was
 				received while the task was waiting. */
-				pxCurrentTCB->ulNotifiedValue &= ~ulBitsToClearOnExit;
+				pxCurrentTCB->ulNotifiedValue[ uxIndexToWait ] &= ~ulBitsToClearOnExit;
 				xReturn = pdTRUE;
 			}
 
-			pxCurrentTCB->ucNotifyState = taskNOT_WAITING_NOTIFICATION;
+			pxCurrentTCB->ucNotifyState[ uxIndexToWait ] = taskNOT_WAITING_NOTIFICATION;
 		}
 		taskEXIT_CRITICAL();
 
@@ -4550,44 +5012,45 @@ TickType_t uxReturn;
 
 #if( configUSE_TASK_NOTIFICATIONS == 1 )
 
-	BaseType_t xTaskGenericNotify( TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction, uint32_t *pulPreviousNotificationValue )
+	BaseType_t xTaskGenericNotify( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, uint32_t ulValue, eNotifyAction eAction, uint32_t *pulPreviousNotificationValue )
 	{
 	TCB_t * pxTCB;
 	BaseType_t xReturn = pdPASS;
 	uint8_t ucOriginalNotifyState;
 
 		configASSERT( xTaskToNotify );
+		configASSERT( uxIndexToNotify < configTASK_NOTIFICATION_ARRAY_ENTRIES );
 		pxTCB = ( TCB_t * ) xTaskToNotify;
 
 		taskENTER_CRITICAL();
 		{
 			if( pulPreviousNotificationValue != NULL )
 			{
-				*pulPreviousNotificationValue = pxTCB->ulNotifiedValue;
+				*pulPreviousNotificationValue = pxTCB->ulNotifiedValue[ uxIndexToNotify ];
 			}
 
-			ucOriginalNotifyState = pxTCB->ucNotifyState;
+			ucOriginalNotifyState = pxTCB->ucNotifyState[ uxIndexToNotify ];
 
-			pxTCB->ucNotifyState = taskNOTIFICATION_RECEIVED;
+			pxTCB->ucNotifyState[ uxIndexToNotify ] = taskNOTIFICATION_RECEIVED;
 
 			switch( eAction )
 			{
 				case eSetBits	:
-					pxTCB->ulNotifiedValue |= ulValue;
+					pxTCB->ulNotifiedValue[ uxIndexToNotify ] |= ulValue;
 					break;
 
 				case eIncrement	:
-					( pxTCB->ulNotifiedValue )++;
+					( pxTCB->ulNotifiedValue[ uxIndexToNotify ] )++;
 					break;
 
 				case eSetValueWithOverwrite	:
-					pxTCB->ulNotifiedValue = ulValue;
+					pxTCB->ulNotifiedValue[ uxIndexToNotify ] = ulValue;
 					break;
 
 				case eSetValueWithoutOverwrite :
 					if( ucOriginalNotifyState != taskNOTIFICATION_RECEIVED )
 					{
-						pxTCB->ulNotifiedValue = ulValue;
+						pxTCB->ulNotifiedValue[ uxIndexToNotify ] = ulValue;
 					}
 					else
 					{
@@ -4656,7 +5119,7 @@ TickType_t uxReturn;
 
 #if( configUSE_TASK_NOTIFICATIONS == 1 )
 
-	BaseType_t xTaskGenericNotifyFromISR( TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction, uint32_t *pulPreviousNotificationValue, BaseType_t *pxHigherPriorityTaskWoken )
+	BaseType_t xTaskGenericNotifyFromISR( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, uint32_t ulValue, eNotifyAction eAction, uint32_t *pulPreviousNotificationValue, BaseType_t *pxHigherPriorityTaskWoken )
 	{
 	TCB_t * pxTCB;
 	uint8_t ucOriginalNotifyState;
@@ -4664,6 +5127,7 @@ TickType_t uxReturn;
 	UBaseType_t uxSavedInterruptStatus;
 
 		configASSERT( xTaskToNotify );
+		configASSERT( uxIndexToNotify < configTASK_NOTIFICATION_ARRAY_ENTRIES );
 
 		/* RTOS ports that support interrupt nesting have the concept of a
 		maximum	system call (or maximum API call) interrupt priority.
@@ -4689,30 +5153,30 @@ TickType_t uxReturn;
 		{
 			if( pulPreviousNotificationValue != NULL )
 			{
-				*pulPreviousNotificationValue = pxTCB->ulNotifiedValue;
+				*pulPreviousNotificationValue = pxTCB->ulNotifiedValue[ uxIndexToNotify ];
 			}
 
-			ucOriginalNotifyState = pxTCB->ucNotifyState;
-			pxTCB->ucNotifyState = taskNOTIFICATION_RECEIVED;
+			ucOriginalNotifyState = pxTCB->ucNotifyState[ uxIndexToNotify ];
+			pxTCB->ucNotifyState[ uxIndexToNotify ] = taskNOTIFICATION_RECEIVED;
 
 			switch( eAction )
 			{
 				case eSetBits	:
-					pxTCB->ulNotifiedValue |= ulValue;
+					pxTCB->ulNotifiedValue[ uxIndexToNotify ] |= ulValue;
 					break;
 
 				case eIncrement	:
-					( pxTCB->ulNotifiedValue )++;
+					( pxTCB->ulNotifiedValue[ uxIndexToNotify ] )++;
 					break;
 
 				case eSetValueWithOverwrite	:
-					pxTCB->ulNotifiedValue = ulValue;
+					pxTCB->ulNotifiedValue[ uxIndexToNotify ] = ulValue;
 					break;
 
 				case eSetValueWithoutOverwrite :
 					if( ucOriginalNotifyState != taskNOTIFICATION_RECEIVED )
 					{
-						pxTCB->ulNotifiedValue = ulValue;
+						pxTCB->ulNotifiedValue[ uxIndexToNotify ] = ulValue;
 					}
 					else
 					{
@@ -4780,13 +5244,14 @@ TickType_t uxReturn;
 
 #if( configUSE_TASK_NOTIFICATIONS == 1 )
 
-	void vTaskNotifyGiveFromISR( TaskHandle_t xTaskToNotify, BaseType_t *pxHigherPriorityTaskWoken )
+	void vTaskGenericNotifyGiveFromISR( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, BaseType_t *pxHigherPriorityTaskWoken )
 	{
 	TCB_t * pxTCB;
 	uint8_t ucOriginalNotifyState;
 	UBaseType_t uxSavedInterruptStatus;
 
 		configASSERT( xTaskToNotify );
+		configASSERT( uxIndexToNotify < configTASK_NOTIFICATION_ARRAY_ENTRIES );
 
 		/* RTOS ports that support interrupt nesting have the concept of a
 		maximum	system call (or maximum API call) interrupt priority.
@@ -4810,12 +5275,12 @@ TickType_t uxReturn;
 
 		uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
 		{
-			ucOriginalNotifyState = pxTCB->ucNotifyState;
-			pxTCB->ucNotifyState = taskNOTIFICATION_RECEIVED;
+			ucOriginalNotifyState = pxTCB->ucNotifyState[ uxIndexToNotify ];
+			pxTCB->ucNotifyState[ uxIndexToNotify ] = taskNOTIFICATION_RECEIVED;
 
 			/* 'Giving' is equivalent to incrementing a count in a counting
 			semaphore. */
-			( pxTCB->ulNotifiedValue )++;
+			( pxTCB->ulNotifiedValue[ uxIndexToNotify ] )++;
 
 			traceTASK_NOTIFY_GIVE_FROM_ISR();
 
@@ -4869,20 +5334,22 @@ TickType_t uxReturn;
 
 #if( configUSE_TASK_NOTIFICATIONS == 1 )
 
-	BaseType_t xTaskNotifyStateClear( TaskHandle_t xTask )
+	BaseType_t xTaskGenericNotifyStateClear( TaskHandle_t xTask, UBaseType_t uxIndexToClear )
 	{
 	TCB_t *pxTCB;
 	BaseType_t xReturn;
 
+		configASSERT( uxIndexToClear < configTASK_NOTIFICATION_ARRAY_ENTRIES );
+
 		/* If null is passed in here then it is the calling task that is having
 		its notification state cleared. */
 		pxTCB = prvGetTCBFromHandle( xTask );
 
 		taskENTER_CRITICAL();
 		{
-			if( pxTCB->ucNotifyState == taskNOTIFICATION_RECEIVED )
+			if( pxTCB->ucNotifyState[ uxIndexToClear ] == taskNOTIFICATION_RECEIVED )
 			{
-				pxTCB->ucNotifyState = taskNOT_WAITING_NOTIFICATION;
+				pxTCB->ucNotifyState[ uxIndexToClear ] = taskNOT_WAITING_NOTIFICATION;
 				xReturn = pdPASS;
 			}
 			else
@@ -4940,7 +5407,7 @@ const TickType_t xConstTickCount = xTickCount;
 			/* Calculate the time at which the task should be woken if the event
 			does not occur.  This may overflow but this doesn't matter, the
 			kernel will manage it correctly. */
-			xTimeToWake = xConstTickCount + xTicksToWait;
+			xTimeToWake = prvGetTickCountNow() + xTicksToWait;
 
 			/* The list item will be inserted in wake time order. */
 			listSET_LIST_ITEM_VALUE( &( pxCurrentTCB->xStateListItem ), xTimeToWake );
@@ -4949,13 +5416,13 @@ const TickType_t xConstTickCount = xTickCount;
 			{
 				/* Wake time has overflowed.  Place this item in the overflow
 				list. */
-				vListInsert( pxOverflowDelayedTaskList, &( pxCurrentTCB->xStateListItem ) );
+				taskINSERT_OVERFLOWED_DELAYED_TASK( &( pxCurrentTCB->xStateListItem ) );
 			}
 			else
 			{
 				/* The wake time has not overflowed, so the current block list
 				is used. */
-				vListInsert( pxDelayedTaskList, &( pxCurrentTCB->xStateListItem ) );
+				taskINSERT_DELAYED_TASK( &( pxCurrentTCB->xStateListItem ) );
 
 				/* If the task entering the blocked state was placed at the
 				head of the list of blocked tasks then xNextTaskUnblockTime
@@ -4976,7 +5443,7 @@ const TickType_t xConstTickCount = xTickCount;
 		/* Calculate the time at which the task should be woken if the event
 		does not occur.  This may overflow but this doesn't matter, the kernel
 		will manage it correctly. */
-		xTimeToWake = xConstTickCount + xTicksToWait;
+		xTimeToWake = prvGetTickCountNow() + xTicksToWait;
 
 		/* The list item will be inserted in wake time order. */
 		listSET_LIST_ITEM_VALUE( &( pxCurrentTCB->xStateListItem ), xTimeToWake );
@@ -4984,12 +5451,12 @@ const TickType_t xConstTickCount = xTickCount;
 		if( xTimeToWake < xConstTickCount )
 		{
 			/* Wake time has overflowed.  Place this item in the overflow list. */
-			vListInsert( pxOverflowDelayedTaskList, &( pxCurrentTCB->xStateListItem ) );
+			taskINSERT_OVERFLOWED_DELAYED_TASK( &( pxCurrentTCB->xStateListItem ) );
 		}
 		else
 		{
 			/* The wake time has not overflowed, so the current block list is used. */
-			vListInsert( pxDelayedTaskList, &( pxCurrentTCB->xStateListItem ) );
+			taskINSERT_DELAYED_TASK( &( pxCurrentTCB->xStateListItem ) );
 
 			/* If the task entering the blocked state was placed at the head of the
 			list of blocked tasks then xNextTaskUnblockTime needs to be updated
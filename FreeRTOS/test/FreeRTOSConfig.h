@@ -0,0 +1,80 @@
+/*
+ * FreeRTOS Kernel V10.0.0
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software. If you wish to use our Amazon
+ * FreeRTOS name, please do so in a fair use way that does not cause confusion.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Configuration of the host test programs in this directory.  They include
+ * tasks.c and drive it directly, without a running scheduler, so the port is
+ * replaced by the stubs of port_stubs.c.  The settings under test can be
+ * overridden from the command line.
+ */
+
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+#define configUSE_PREEMPTION			1
+#define configUSE_IDLE_HOOK				0
+#define configUSE_TICK_HOOK				0
+#define configCPU_CLOCK_HZ				( 48000000UL )
+#define configTICK_RATE_HZ				( ( TickType_t ) 1000 )
+#define configMINIMAL_STACK_SIZE		( ( unsigned short ) 64 )
+#define configMAX_TASK_NAME_LEN			( 16 )
+#define configUSE_TRACE_FACILITY		1
+#define configUSE_MUTEXES				1
+#define configSUPPORT_STATIC_ALLOCATION	1
+#define configUSE_TIMERS				0
+
+#ifndef configMAX_PRIORITIES
+	#define configMAX_PRIORITIES		( 5 )
+#endif
+
+#ifndef configUSE_16_BIT_TICKS
+	#define configUSE_16_BIT_TICKS		0
+#endif
+
+#ifndef configSUPPORT_DYNAMIC_ALLOCATION
+	#define configSUPPORT_DYNAMIC_ALLOCATION 0
+#endif
+
+#ifndef configTLSF_MAX_BLOCK_SIZE_LOG2
+	#define configTLSF_MAX_BLOCK_SIZE_LOG2 17
+#endif
+
+#ifndef configUSE_TIMING_WHEEL
+	#define configUSE_TIMING_WHEEL		1
+#endif
+
+#define INCLUDE_vTaskSuspend			1
+#define INCLUDE_vTaskDelete				1
+#define INCLUDE_vTaskDelay				1
+#define INCLUDE_xTaskAbortDelay			1
+#define INCLUDE_eTaskGetState			1
+
+void errorAssertCalled(const char*, unsigned long, const char*);
+#define configASSERT(x) if( (x) == 0 ) errorAssertCalled( __FILE__, __LINE__, NULL )
+
+#endif /* FREERTOS_CONFIG_H */
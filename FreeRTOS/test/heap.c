@@ -0,0 +1,337 @@
+/*
+ * FreeRTOS Kernel V10.0.0
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software. If you wish to use our Amazon
+ * FreeRTOS name, please do so in a fair use way that does not cause confusion.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host check and benchmark of the heap, built once with heap.c and once with
+ * heap_tlsf.c (configUSE_TLSF_HEAP set to 1).  The heap space is a block of
+ * bss of testHEAP_SIZE bytes, and suspending the scheduler does nothing since
+ * there is a single thread.
+ *
+ * heap check [operations]
+ *     Random allocations and frees of random sizes.  Each block is filled with
+ *     a pattern checked when it is freed, and must be aligned and inside the
+ *     heap space.  Allocations that can not be satisfied must return NULL.
+ *     Freeing everything must give back the initial free size, also after
+ *     allocating until the heap is full.
+ *
+ * heap bench [operations]
+ *     Average time of an allocation or a free in the same random sequence.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#ifndef testHEAP_SIZE
+	#define testHEAP_SIZE		( 1024 * 1024 )
+#endif
+
+#define testSLOTS				4096
+
+#define testSTRINGIFY_( x )		#x
+#define testSTRINGIFY( x )		testSTRINGIFY_( x )
+
+__asm__(
+	"	.bss							\n"
+	"	.balign 16						\n"
+	"	.globl __heap_base__			\n"
+	"__heap_base__:						\n"
+	"	.space " testSTRINGIFY( testHEAP_SIZE ) "\n"
+	"	.globl __heap_end__				\n"
+	"__heap_end__:						\n"
+	"	.text							\n"
+);
+
+extern uint8_t __heap_base__[];
+extern uint8_t __heap_end__[];
+extern size_t chHeapStatus( void *ignore, size_t *memFree, size_t *largestBlock );
+
+typedef struct
+{
+	uint8_t *pucBlock;
+	size_t xSize;
+} Slot_t;
+
+static Slot_t xSlots[ testSLOTS ];
+
+static uint64_t ullRandomState = 88172645463325252ULL;
+
+/*-----------------------------------------------------------*/
+
+void vTaskSuspendAll( void )
+{
+}
+
+BaseType_t xTaskResumeAll( void )
+{
+	return pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvRandom( void )
+{
+	ullRandomState ^= ullRandomState << 13;
+	ullRandomState ^= ullRandomState >> 7;
+	ullRandomState ^= ullRandomState << 17;
+	return ( uint32_t ) ullRandomState;
+}
+/*-----------------------------------------------------------*/
+
+static double prvNanoseconds( void )
+{
+struct timespec xNow;
+
+	clock_gettime( CLOCK_MONOTONIC, &xNow );
+	return xNow.tv_sec * 1e9 + xNow.tv_nsec;
+}
+/*-----------------------------------------------------------*/
+
+/* Mostly small blocks, some of a few KB and a few large ones. */
+static size_t prvRandomSize( void )
+{
+uint32_t ulClass = prvRandom() % 100;
+
+	if( ulClass < 80 )
+	{
+		return 1 + prvRandom() % 256;
+	}
+	else if( ulClass < 99 )
+	{
+		return 1 + prvRandom() % 4096;
+	}
+
+	return 1 + prvRandom() % ( testHEAP_SIZE / 16 );
+}
+/*-----------------------------------------------------------*/
+
+static uint8_t prvPattern( const Slot_t *pxSlot, size_t x )
+{
+	return ( uint8_t ) ( ( ( size_t ) pxSlot + x ) * 31 );
+}
+/*-----------------------------------------------------------*/
+
+static int prvAllocate( Slot_t *pxSlot, size_t xSize, BaseType_t xCheck )
+{
+size_t x;
+
+	pxSlot->pucBlock = pvPortMalloc( xSize );
+	pxSlot->xSize = xSize;
+	if( ( pxSlot->pucBlock == NULL ) || ( xCheck == pdFALSE ) )
+	{
+		return 0;
+	}
+
+	if( ( ( ( size_t ) pxSlot->pucBlock & portBYTE_ALIGNMENT_MASK ) != 0 ) ||
+		( pxSlot->pucBlock < __heap_base__ ) || ( pxSlot->pucBlock + xSize > __heap_end__ ) )
+	{
+		printf( "block %p of %lu bytes misaligned or outside the heap\n", ( void * ) pxSlot->pucBlock, ( unsigned long ) xSize );
+		return 1;
+	}
+
+	for( x = 0; x < xSize; x++ )
+	{
+		pxSlot->pucBlock[ x ] = prvPattern( pxSlot, x );
+	}
+
+	return 0;
+}
+/*-----------------------------------------------------------*/
+
+static int prvFree( Slot_t *pxSlot, BaseType_t xCheck )
+{
+size_t x;
+
+	if( xCheck != pdFALSE )
+	{
+		for( x = 0; x < pxSlot->xSize; x++ )
+		{
+			if( pxSlot->pucBlock[ x ] != prvPattern( pxSlot, x ) )
+			{
+				printf( "block %p of %lu bytes overwritten at %lu\n", ( void * ) pxSlot->pucBlock, ( unsigned long ) pxSlot->xSize, ( unsigned long ) x );
+				return 1;
+			}
+		}
+	}
+
+	vPortFree( pxSlot->pucBlock );
+	pxSlot->pucBlock = NULL;
+	return 0;
+}
+/*-----------------------------------------------------------*/
+
+static int prvFreeAll( BaseType_t xCheck )
+{
+int i;
+
+	for( i = 0; i < testSLOTS; i++ )
+	{
+		if( ( xSlots[ i ].pucBlock != NULL ) && ( prvFree( &xSlots[ i ], xCheck ) != 0 ) )
+		{
+			return 1;
+		}
+	}
+
+	return 0;
+}
+/*-----------------------------------------------------------*/
+
+/* Allocates or frees a random slot, returns the number of failed
+allocations. */
+static long prvRandomOperations( long lOperations, BaseType_t xCheck, int *piError )
+{
+long lOperation, lFailed = 0;
+Slot_t *pxSlot;
+
+	for( lOperation = 0; lOperation < lOperations; lOperation++ )
+	{
+		pxSlot = &xSlots[ prvRandom() % testSLOTS ];
+		if( pxSlot->pucBlock != NULL )
+		{
+			*piError |= prvFree( pxSlot, xCheck );
+		}
+		else
+		{
+			*piError |= prvAllocate( pxSlot, prvRandomSize(), xCheck );
+			lFailed += ( pxSlot->pucBlock == NULL ) ? 1 : 0;
+		}
+
+		if( *piError != 0 )
+		{
+			break;
+		}
+	}
+
+	return lFailed;
+}
+/*-----------------------------------------------------------*/
+
+static int prvCheck( long lOperations )
+{
+size_t xInitialFree, xMemFree, xLargest, xInitialBlocks;
+long lFailed;
+int iError = 0, i;
+
+	/* The first allocation initialises the heap. */
+	if( pvPortMalloc( 0 ) != NULL )
+	{
+		printf( "a zero size allocation did not fail\n" );
+		return 1;
+	}
+	xInitialFree = xPortGetFreeHeapSize();
+	xInitialBlocks = chHeapStatus( NULL, &xMemFree, &xLargest );
+	if( ( xInitialFree == 0 ) || ( xInitialFree > testHEAP_SIZE ) || ( xMemFree != xInitialFree ) )
+	{
+		printf( "initial free size %lu, status %lu, for a heap of %lu bytes\n", ( unsigned long ) xInitialFree, ( unsigned long ) xMemFree, ( unsigned long ) testHEAP_SIZE );
+		return 1;
+	}
+
+	/* Too large for the heap, or for the TLSF free lists. */
+	#if( configUSE_TLSF_HEAP == 1 )
+	{
+		if( pvPortMalloc( ( size_t ) 1 << configTLSF_MAX_BLOCK_SIZE_LOG2 ) != NULL )
+		{
+			printf( "an allocation larger than the free lists did not fail\n" );
+			return 1;
+		}
+	}
+	#endif
+	if( pvPortMalloc( testHEAP_SIZE ) != NULL )
+	{
+		printf( "an allocation larger than the heap did not fail\n" );
+		return 1;
+	}
+
+	lFailed = prvRandomOperations( lOperations, pdTRUE, &iError );
+	iError |= prvFreeAll( pdTRUE );
+	if( ( iError != 0 ) || ( xPortGetFreeHeapSize() != xInitialFree ) )
+	{
+		printf( "free size %lu after freeing everything, initially %lu\n", ( unsigned long ) xPortGetFreeHeapSize(), ( unsigned long ) xInitialFree );
+		return 1;
+	}
+
+	/* Fill the heap until allocations fail, with random sizes then with
+	small ones, and free everything again. */
+	for( i = 0; i < testSLOTS; i++ )
+	{
+		iError |= prvAllocate( &xSlots[ i ], ( i < testSLOTS / 2 ) ? prvRandomSize() * 8 : 1 + prvRandom() % 64, pdTRUE );
+	}
+	if( xPortGetFreeHeapSize() > testHEAP_SIZE / 8 )
+	{
+		printf( "the heap is not full, %lu bytes free\n", ( unsigned long ) xPortGetFreeHeapSize() );
+		return 1;
+	}
+	iError |= prvFreeAll( pdTRUE );
+	if( ( iError != 0 ) || ( xPortGetFreeHeapSize() != xInitialFree ) || ( chHeapStatus( NULL, &xMemFree, &xLargest ) != xInitialBlocks ) )
+	{
+		printf( "free size %lu after filling the heap, initially %lu\n", ( unsigned long ) xPortGetFreeHeapSize(), ( unsigned long ) xInitialFree );
+		return 1;
+	}
+
+	printf( "%s ok: %ld operations, %ld failed allocations, %lu free bytes in %lu blocks, minimum ever %lu\n",
+			( configUSE_TLSF_HEAP == 1 ) ? "heap_tlsf.c" : "heap.c", lOperations, lFailed, ( unsigned long ) xInitialFree,
+			( unsigned long ) xInitialBlocks, ( unsigned long ) xPortGetMinimumEverFreeHeapSize() );
+	return 0;
+}
+/*-----------------------------------------------------------*/
+
+static void prvBenchmark( long lOperations )
+{
+double dStart;
+int iError = 0;
+
+	/* Reach a fragmented steady state first. */
+	( void ) prvRandomOperations( lOperations / 4, pdFALSE, &iError );
+
+	dStart = prvNanoseconds();
+	( void ) prvRandomOperations( lOperations, pdFALSE, &iError );
+	printf( "%-11s %7.1f ns per operation\n", ( configUSE_TLSF_HEAP == 1 ) ? "heap_tlsf.c" : "heap.c", ( prvNanoseconds() - dStart ) / lOperations );
+}
+/*-----------------------------------------------------------*/
+
+int main( int argc, char *argv[] )
+{
+long lOperations = ( argc > 2 ) ? atol( argv[ 2 ] ) : 2000000L;
+
+	if( ( argc > 1 ) && ( strcmp( argv[ 1 ], "check" ) == 0 ) )
+	{
+		return prvCheck( lOperations );
+	}
+
+	if( ( argc > 1 ) && ( strcmp( argv[ 1 ], "bench" ) == 0 ) )
+	{
+		prvBenchmark( lOperations );
+		return 0;
+	}
+
+	fprintf( stderr, "usage: %s check|bench [operations]\n", argv[ 0 ] );
+	return 2;
+}
@@ -0,0 +1,126 @@
+/*
+ * FreeRTOS Kernel V10.0.0
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software. If you wish to use our Amazon
+ * FreeRTOS name, please do so in a fair use way that does not cause confusion.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host check of uxPortGetHighestPriority(), the highest set bit search of the
+ * ports that have no CLZ instruction, against __builtin_clz().  The search
+ * depends on configMAX_PRIORITIES, so the check is built for each setting
+ * under test, with configSIMULATOR_NO_CLZ set to 1 so that
+ * portGET_HIGHEST_PRIORITY() uses it.  Every non zero bit map is checked up
+ * to 24 priorities, beyond that every map of one or two bits and a random
+ * sample.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#if( configUSE_PORT_OPTIMISED_TASK_SELECTION != 1 ) || ( configSIMULATOR_NO_CLZ != 1 )
+	#error The check needs configUSE_PORT_OPTIMISED_TASK_SELECTION and configSIMULATOR_NO_CLZ set to 1
+#endif
+
+#define testEXHAUSTIVE_BITS		24
+#define testSAMPLES				( 1UL << testEXHAUSTIVE_BITS )
+
+static uint64_t ullRandomState = 88172645463325252ULL;
+static unsigned long ulChecked;
+
+/*-----------------------------------------------------------*/
+
+static uint32_t prvRandom( void )
+{
+	ullRandomState ^= ullRandomState << 13;
+	ullRandomState ^= ullRandomState >> 7;
+	ullRandomState ^= ullRandomState << 17;
+	return ( uint32_t ) ullRandomState;
+}
+/*-----------------------------------------------------------*/
+
+static int prvCheckMap( uint32_t ulReadyPriorities )
+{
+UBaseType_t uxTopPriority;
+
+	portGET_HIGHEST_PRIORITY( uxTopPriority, ulReadyPriorities );
+	ulChecked++;
+	if( uxTopPriority != ( UBaseType_t ) ( 31 - __builtin_clz( ulReadyPriorities ) ) )
+	{
+		printf( "%d priorities: map %08lX gives %lu, expected %d\n", configMAX_PRIORITIES, ( unsigned long ) ulReadyPriorities, ( unsigned long ) uxTopPriority, 31 - __builtin_clz( ulReadyPriorities ) );
+		return 1;
+	}
+
+	return 0;
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+const uint32_t ulMask = ( configMAX_PRIORITIES >= 32 ) ? 0xFFFFFFFFUL : ( ( 1UL << configMAX_PRIORITIES ) - 1UL );
+uint32_t ulMap, ulHigh, ulLow;
+unsigned long ulSample;
+
+	if( configMAX_PRIORITIES <= testEXHAUSTIVE_BITS )
+	{
+		for( ulMap = 1; ulMap <= ulMask; ulMap++ )
+		{
+			if( prvCheckMap( ulMap ) != 0 )
+			{
+				return 1;
+			}
+		}
+	}
+	else
+	{
+		for( ulHigh = 0; ulHigh < ( uint32_t ) configMAX_PRIORITIES; ulHigh++ )
+		{
+			for( ulLow = 0; ulLow <= ulHigh; ulLow++ )
+			{
+				if( prvCheckMap( ( 1UL << ulHigh ) | ( 1UL << ulLow ) ) != 0 )
+				{
+					return 1;
+				}
+			}
+		}
+
+		for( ulSample = 0; ulSample < testSAMPLES; ulSample++ )
+		{
+			ulMap = prvRandom() & ulMask;
+
+			/* Spread the highest bit evenly over the range. */
+			ulMap >>= prvRandom() % ( uint32_t ) configMAX_PRIORITIES;
+			if( ( ulMap != 0 ) && ( prvCheckMap( ulMap ) != 0 ) )
+			{
+				return 1;
+			}
+		}
+	}
+
+	printf( "%2d priorities: %lu maps ok\n", configMAX_PRIORITIES, ulChecked );
+	return 0;
+}
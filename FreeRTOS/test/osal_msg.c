@@ -0,0 +1,235 @@
+/*
+ * FreeRTOS Kernel V10.0.0
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software. If you wish to use our Amazon
+ * FreeRTOS name, please do so in a fair use way that does not cause confusion.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host check of the OSAL synchronous messages and of the priority donation
+ * to the server, on the Posix port with configUSE_OSAL_MESSAGES set to 1.
+ *
+ * - Requests and replies: the server runs at the priority of the sender and
+ *   is back to its base priority when idle.
+ * - Queued senders are served in priority order.
+ * - A server blocked on a queue when a message arrives is raised to the
+ *   priority of the sender, and moves ahead of the lower priority task
+ *   blocked on the same queue, so it receives the next item.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ch.h"
+
+#if( configUSE_OSAL_MESSAGES != 1 )
+	#error The check needs configUSE_OSAL_MESSAGES set to 1
+#endif
+
+#define testREQUESTS			10000
+#define testSERVER_PRIORITY		1
+#define testCLIENT_PRIORITY		3
+#define testHIGH_PRIORITY		4
+#define testBLOCKED_MSG			200000
+#define testITEM				42
+
+static TaskHandle_t xServer;
+static QueueHandle_t xQueue;
+static int iErrors;
+
+/* What the server saw while serving. */
+static volatile UBaseType_t uxServedPriorityMin = configMAX_PRIORITIES, uxServedPriorityMax;
+static volatile msg_t xOrder[ 2 ];
+static volatile int iOrdered;
+static const char * volatile pcItemReceiver;
+
+/*-----------------------------------------------------------*/
+
+static void prvCheck( int iCondition, const char *pcWhat )
+{
+	if( iCondition == 0 )
+	{
+		printf( "FAILED: %s\n", pcWhat );
+		iErrors++;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvServerTask( void *pvParameters )
+{
+thread_t *tp;
+msg_t xMsg;
+UBaseType_t uxPriority;
+int iItem;
+
+	( void ) pvParameters;
+
+	/* Blocked on the queue first, see prvBlockedDonee(). */
+	if( xQueueReceive( xQueue, &iItem, portMAX_DELAY ) == pdPASS )
+	{
+		pcItemReceiver = "server";
+	}
+
+	for( ;; )
+	{
+		tp = chMsgWait();
+		xMsg = chMsgGet( tp );
+		uxPriority = uxTaskPriorityGet( NULL );
+		if( xMsg < testBLOCKED_MSG )
+		{
+			if( uxPriority < uxServedPriorityMin )
+			{
+				uxServedPriorityMin = uxPriority;
+			}
+			if( uxPriority > uxServedPriorityMax )
+			{
+				uxServedPriorityMax = uxPriority;
+			}
+		}
+		else if( ( xMsg > testBLOCKED_MSG ) && ( iOrdered < 2 ) )
+		{
+			xOrder[ iOrdered++ ] = xMsg;
+		}
+		chMsgRelease( tp, xMsg * 2 );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvWaiterTask( void *pvParameters )
+{
+int iItem;
+
+	( void ) pvParameters;
+
+	if( xQueueReceive( xQueue, &iItem, portMAX_DELAY ) == pdPASS )
+	{
+		pcItemReceiver = "waiter";
+	}
+	vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvSenderTask( void *pvParameters )
+{
+msg_t xMsg = ( msg_t ) ( intptr_t ) pvParameters;
+
+	prvCheck( chMsgSend( ( thread_t * ) xServer, xMsg ) == xMsg * 2, "queued sender reply" );
+	vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvBlockedDonee( void )
+{
+int iItem = testITEM;
+
+	/* The waiter has a higher priority than the server, both block on the
+	queue and the waiter is ahead in its event list. */
+	xTaskCreate( prvWaiterTask, "waiter", configMINIMAL_STACK_SIZE * 8, NULL, testSERVER_PRIORITY + 1, NULL );
+	vTaskDelay( 2 );
+
+	/* The sender donates its priority to the blocked server. */
+	xTaskCreate( prvSenderTask, "high", configMINIMAL_STACK_SIZE * 8, ( void * ) ( intptr_t ) testBLOCKED_MSG, testHIGH_PRIORITY, NULL );
+	prvCheck( uxTaskPriorityGet( xServer ) == testHIGH_PRIORITY, "blocked server raised to the sender priority" );
+
+	/* The server is now the highest priority waiter. */
+	xQueueSend( xQueue, &iItem, portMAX_DELAY );
+	vTaskDelay( 2 );
+	prvCheck( pcItemReceiver != NULL && pcItemReceiver[ 0 ] == 's', "item received by the donee" );
+
+	/* Unblocks the waiter. */
+	xQueueSend( xQueue, &iItem, portMAX_DELAY );
+	vTaskDelay( 2 );
+	prvCheck( uxTaskPriorityGet( xServer ) == testSERVER_PRIORITY, "server back to its base priority" );
+}
+/*-----------------------------------------------------------*/
+
+static void prvClientTask( void *pvParameters )
+{
+msg_t i;
+bool bPending;
+
+	( void ) pvParameters;
+
+	prvBlockedDonee();
+
+	for( i = 0; i < testREQUESTS; i++ )
+	{
+		if( chMsgSend( ( thread_t * ) xServer, i ) != i * 2 )
+		{
+			prvCheck( 0, "reply" );
+			break;
+		}
+	}
+	prvCheck( uxServedPriorityMin == testCLIENT_PRIORITY && uxServedPriorityMax == testCLIENT_PRIORITY, "served at the sender priority" );
+	prvCheck( uxTaskPriorityGet( xServer ) == testSERVER_PRIORITY, "idle server at its base priority" );
+
+	/* Two senders queued while the server is suspended, the higher priority
+	one is served first. */
+	vTaskSuspend( xServer );
+	xTaskCreate( prvSenderTask, "low1", configMINIMAL_STACK_SIZE * 8, ( void * ) ( intptr_t ) ( testBLOCKED_MSG + 1 ), 1, NULL );
+	vTaskDelay( 2 );
+	xTaskCreate( prvSenderTask, "low2", configMINIMAL_STACK_SIZE * 8, ( void * ) ( intptr_t ) ( testBLOCKED_MSG + 2 ), 2, NULL );
+	vTaskDelay( 2 );
+	osalSysLock();
+	bPending = chMsgIsPendingI( ( thread_t * ) xServer );
+	osalSysUnlock();
+	prvCheck( bPending, "message pending" );
+	prvCheck( uxTaskPriorityGet( xServer ) == 2, "suspended server raised to the highest sender" );
+	vTaskResume( xServer );
+	vTaskDelay( 5 );
+	prvCheck( iOrdered == 2 && xOrder[ 0 ] == testBLOCKED_MSG + 2 && xOrder[ 1 ] == testBLOCKED_MSG + 1, "senders served in priority order" );
+	prvCheck( uxTaskPriorityGet( xServer ) == testSERVER_PRIORITY, "server back to its base priority after the queue" );
+
+	if( iErrors == 0 )
+	{
+		printf( "osal messages ok: %d requests\n", testREQUESTS );
+	}
+	exit( iErrors != 0 );
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+	xQueue = xQueueCreate( 1, sizeof( int ) );
+	xTaskCreate( prvServerTask, "server", configMINIMAL_STACK_SIZE * 8, NULL, testSERVER_PRIORITY, &xServer );
+	xTaskCreate( prvClientTask, "client", configMINIMAL_STACK_SIZE * 8, NULL, testCLIENT_PRIORITY, NULL );
+	vTaskStartScheduler();
+
+	return 1;
+}
+/*-----------------------------------------------------------*/
+
+void errorAssertCalled( const char *pcFile, unsigned long ulLine, const char *pcReason )
+{
+	printf( "Assertion failed: %s:%lu %s\n", pcFile, ulLine, pcReason ? pcReason : "" );
+	abort();
+}
+/*-----------------------------------------------------------*/
+
+void vApplicationStackOverflowHook( TaskHandle_t xTask, char *pcTaskName )
+{
+	( void ) xTask;
+	printf( "Stack overflow in task %s\n", pcTaskName );
+	abort();
+}
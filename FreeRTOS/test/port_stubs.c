@@ -0,0 +1,110 @@
+/*
+ * FreeRTOS Kernel V10.0.0
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software. If you wish to use our Amazon
+ * FreeRTOS name, please do so in a fair use way that does not cause confusion.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Port layer of the host test programs.  The programs call the kernel
+ * functions from a single thread, without a scheduler, so entering a critical
+ * section and yielding do nothing.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+UBaseType_t uxCriticalNesting;
+volatile BaseType_t xPortInterruptActive;
+
+void vPortEnterCritical( void )
+{
+}
+
+void vPortExitCritical( void )
+{
+}
+
+uint32_t ulPortEnterCriticalFromISR( void )
+{
+	return 0;
+}
+
+void vPortExitCriticalFromISR( uint32_t ulNesting )
+{
+	( void ) ulNesting;
+}
+
+void vPortYield( void )
+{
+}
+
+void vPortYieldFromISR( void )
+{
+}
+
+void vPortCleanUpTCB( void *pxTCB )
+{
+	( void ) pxTCB;
+}
+
+TickType_t xPortGetUnprocessedTicks( void )
+{
+	return 0;
+}
+
+StackType_t *pxPortInitialiseStack( StackType_t *pxTopOfStack, TaskFunction_t pxCode, void *pvParameters )
+{
+	( void ) pxCode;
+	( void ) pvParameters;
+	return pxTopOfStack;
+}
+
+BaseType_t xPortStartScheduler( void )
+{
+	return pdFALSE;
+}
+
+void vPortEndScheduler( void )
+{
+}
+
+void vApplicationGetIdleTaskMemory( StaticTask_t **ppxIdleTaskTCBBuffer, StackType_t **ppxIdleTaskStackBuffer, uint32_t *pulIdleTaskStackSize )
+{
+static StaticTask_t xIdleTaskTCB;
+static StackType_t uxIdleTaskStack[ configMINIMAL_STACK_SIZE ];
+
+	*ppxIdleTaskTCBBuffer = &xIdleTaskTCB;
+	*ppxIdleTaskStackBuffer = uxIdleTaskStack;
+	*pulIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
+
+void errorAssertCalled( const char *pcFile, unsigned long ulLine, const char *pcReason )
+{
+	fprintf( stderr, "Assertion failed: %s:%lu %s\n", pcFile, ulLine, pcReason ? pcReason : "" );
+	abort();
+}
@@ -0,0 +1,137 @@
+/*
+ * FreeRTOS Kernel V10.0.0
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software. If you wish to use our Amazon
+ * FreeRTOS name, please do so in a fair use way that does not cause confusion.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host microbenchmark of vTaskSwitchContext().  A low priority task runs, an
+ * interrupt readies the top priority task, which runs and blocks again: two
+ * context switches per cycle.  tasks.c is included so the ready lists can be
+ * driven directly.  It is built with the generic task selection
+ * (configUSE_PORT_OPTIMISED_TASK_SELECTION set to 0), with the search used by
+ * the ports that have no CLZ instruction (configSIMULATOR_NO_CLZ set to 1) and
+ * with CLZ.
+ *
+ * switch_bench [priority of the low task]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "tasks.c"
+
+/* tasks.c calls it whether configINCLUDE_FREERTOS_TASK_C_ADDITIONS_H is set or
+not. */
+static void freertos_tasks_c_additions_init( void )
+{
+}
+
+#define testCYCLES		20000000L
+#define testRUNS		5
+
+#if( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 )
+	#define testSELECTION	"generic"
+#elif( configSIMULATOR_NO_CLZ == 1 )
+	#define testSELECTION	"de Bruijn"
+#else
+	#define testSELECTION	"clz"
+#endif
+
+static StaticTask_t xLowTCB, xHighTCB;
+static StackType_t uxLowStack[ configMINIMAL_STACK_SIZE ], uxHighStack[ configMINIMAL_STACK_SIZE ];
+
+/*-----------------------------------------------------------*/
+
+static double prvNanoseconds( void )
+{
+struct timespec xNow;
+
+	clock_gettime( CLOCK_MONOTONIC, &xNow );
+	return xNow.tv_sec * 1e9 + xNow.tv_nsec;
+}
+/*-----------------------------------------------------------*/
+
+static void prvTaskFunction( void *pvParameters )
+{
+	( void ) pvParameters;
+}
+/*-----------------------------------------------------------*/
+
+int main( int argc, char *argv[] )
+{
+UBaseType_t uxLowPriority = ( argc > 1 ) ? ( UBaseType_t ) strtoul( argv[ 1 ], NULL, 0 ) : 0;
+double dStart, dTime, dBest = 1e30;
+TCB_t *pxLow, *pxHigh;
+long lCycle;
+int iRun;
+
+	if( uxLowPriority >= ( UBaseType_t ) configMAX_PRIORITIES - 1 )
+	{
+		fprintf( stderr, "the low task priority must be below %d\n", configMAX_PRIORITIES - 1 );
+		return 2;
+	}
+
+	pxLow = ( TCB_t * ) xTaskCreateStatic( prvTaskFunction, "low", configMINIMAL_STACK_SIZE, NULL, uxLowPriority, uxLowStack, &xLowTCB );
+	pxHigh = ( TCB_t * ) xTaskCreateStatic( prvTaskFunction, "high", configMINIMAL_STACK_SIZE, NULL, configMAX_PRIORITIES - 1, uxHighStack, &xHighTCB );
+
+	/* The high priority task starts blocked. */
+	if( uxListRemove( &( pxHigh->xStateListItem ) ) == ( UBaseType_t ) 0 )
+	{
+		portRESET_READY_PRIORITY( pxHigh->uxPriority, uxTopReadyPriority );
+	}
+	xSchedulerRunning = pdTRUE;
+	pxCurrentTCB = pxLow;
+
+	for( iRun = 0; iRun < testRUNS; iRun++ )
+	{
+		dStart = prvNanoseconds();
+		for( lCycle = 0; lCycle < testCYCLES; lCycle++ )
+		{
+			prvAddTaskToReadyList( pxHigh );
+			vTaskSwitchContext();
+			if( uxListRemove( &( pxHigh->xStateListItem ) ) == ( UBaseType_t ) 0 )
+			{
+				portRESET_READY_PRIORITY( pxHigh->uxPriority, uxTopReadyPriority );
+			}
+			vTaskSwitchContext();
+		}
+		dTime = ( prvNanoseconds() - dStart ) / testCYCLES / 2;
+		if( dTime < dBest )
+		{
+			dBest = dTime;
+		}
+	}
+
+	if( pxCurrentTCB != pxLow )
+	{
+		printf( "the low priority task is not running\n" );
+		return 1;
+	}
+
+	printf( "%-10s %2d priorities, low task at %2lu: %6.2f ns per switch\n", testSELECTION, configMAX_PRIORITIES, ( unsigned long ) uxLowPriority, dBest );
+	return 0;
+}
@@ -0,0 +1,308 @@
+/*
+ * FreeRTOS Kernel V10.0.0
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software. If you wish to use our Amazon
+ * FreeRTOS name, please do so in a fair use way that does not cause confusion.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host check and benchmark of the delayed task list, built once with the
+ * sorted list (configUSE_TIMING_WHEEL set to 0) and once with the timing
+ * wheel.  tasks.c is included so its internals can be driven directly: the
+ * "current" task is delayed with prvAddCurrentTaskToDelayedList() and the
+ * ticks are counted with xTaskIncrementTick().
+ *
+ * timing_wheel check <tasks> <max delay> <ticks>
+ *     Random delays, aborted delays, suspensions and ticks, checked after each
+ *     tick against a model of the wake times.  The summary it prints is the
+ *     same for the list and the wheel.
+ *
+ * timing_wheel bench <tasks>
+ *     Time to block a task and time of a tick, including blocking the woken
+ *     tasks again, with <tasks> delayed tasks.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "tasks.c"
+
+/* tasks.c calls it whether configINCLUDE_FREERTOS_TASK_C_ADDITIONS_H is set or
+not. */
+static void freertos_tasks_c_additions_init( void )
+{
+}
+
+#define testMAX_TASKS		20000
+#define testREPETITIONS		20000
+
+static StaticTask_t xTCBs[ testMAX_TASKS + 1 ];
+static StackType_t uxStacks[ testMAX_TASKS + 1 ][ configMINIMAL_STACK_SIZE ];
+static TaskHandle_t xHandles[ testMAX_TASKS + 1 ];
+static TickType_t xWakeTimes[ testMAX_TASKS + 1 ];
+static BaseType_t xDelayed[ testMAX_TASKS + 1 ];
+
+/* The task that runs when none of the others is delayed. */
+static int iRunning;
+
+static uint64_t ullRandomState = 88172645463325252ULL;
+
+/*-----------------------------------------------------------*/
+
+static uint32_t prvRandom( void )
+{
+	ullRandomState ^= ullRandomState << 13;
+	ullRandomState ^= ullRandomState >> 7;
+	ullRandomState ^= ullRandomState << 17;
+	return ( uint32_t ) ullRandomState;
+}
+/*-----------------------------------------------------------*/
+
+static double prvNanoseconds( void )
+{
+struct timespec xNow;
+
+	clock_gettime( CLOCK_MONOTONIC, &xNow );
+	return xNow.tv_sec * 1e9 + xNow.tv_nsec;
+}
+/*-----------------------------------------------------------*/
+
+static void prvTaskFunction( void *pvParameters )
+{
+	( void ) pvParameters;
+}
+/*-----------------------------------------------------------*/
+
+static void prvCreateTasks( int iTasks )
+{
+char cName[ configMAX_TASK_NAME_LEN ];
+int i;
+
+	/* The last task is never delayed. */
+	for( i = 0; i <= iTasks; i++ )
+	{
+		snprintf( cName, sizeof( cName ), "t%d", i );
+		xHandles[ i ] = xTaskCreateStatic( prvTaskFunction, cName, configMINIMAL_STACK_SIZE, NULL, 1, uxStacks[ i ], &xTCBs[ i ] );
+	}
+
+	iRunning = iTasks;
+	xSchedulerRunning = pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+static void prvDelayTask( int i, TickType_t xTicksToDelay )
+{
+	pxCurrentTCB = ( TCB_t * ) xHandles[ i ];
+	prvAddCurrentTaskToDelayedList( xTicksToDelay, pdFALSE );
+	xWakeTimes[ i ] = xTickCount + xTicksToDelay;
+	xDelayed[ i ] = pdTRUE;
+	pxCurrentTCB = ( TCB_t * ) xHandles[ iRunning ];
+}
+/*-----------------------------------------------------------*/
+
+static int prvCheck( int iTasks, TickType_t xMaxDelay, long lTicks )
+{
+long lTick, lTimeouts = 0, lRemovals = 0;
+UBaseType_t uxCount, uxBlocked = 0, uxExpected = 0, x;
+TaskStatus_t *pxStatus;
+eTaskState eState;
+int i, k;
+
+	prvCreateTasks( iTasks );
+
+	for( lTick = 0; lTick < lTicks; lTick++ )
+	{
+		/* Block a few ready tasks. */
+		for( k = 0; k < 4; k++ )
+		{
+			i = ( int ) ( prvRandom() % ( uint32_t ) iTasks );
+			if( xDelayed[ i ] == pdFALSE )
+			{
+				prvDelayTask( i, ( TickType_t ) ( 1 + prvRandom() % xMaxDelay ) );
+			}
+		}
+
+		/* Remove a delayed task from its list for another reason than its
+		timeout. */
+		if( prvRandom() % 8 == 0 )
+		{
+			i = ( int ) ( prvRandom() % ( uint32_t ) iTasks );
+			if( xDelayed[ i ] != pdFALSE )
+			{
+				if( prvRandom() % 2 != 0 )
+				{
+					( void ) xTaskAbortDelay( xHandles[ i ] );
+				}
+				else
+				{
+					vTaskSuspend( xHandles[ i ] );
+					vTaskResume( xHandles[ i ] );
+				}
+				xDelayed[ i ] = pdFALSE;
+				lRemovals++;
+			}
+		}
+
+		/* The next unblock time must never be after a wake time. */
+		for( i = 0; i < iTasks; i++ )
+		{
+			if( ( xDelayed[ i ] != pdFALSE ) && ( xWakeTimes[ i ] >= xTickCount ) && ( xNextTaskUnblockTime > xWakeTimes[ i ] ) )
+			{
+				printf( "tick %lu: next unblock time %lu after the wake time %lu of task %d\n", ( unsigned long ) xTickCount, ( unsigned long ) xNextTaskUnblockTime, ( unsigned long ) xWakeTimes[ i ], i );
+				return 1;
+			}
+		}
+
+		( void ) xTaskIncrementTick();
+
+		/* The tasks are woken exactly at their wake time. */
+		for( i = 0; i < iTasks; i++ )
+		{
+			eState = eTaskGetState( xHandles[ i ] );
+			if( ( xDelayed[ i ] != pdFALSE ) && ( xWakeTimes[ i ] == xTickCount ) )
+			{
+				if( eState != eReady )
+				{
+					printf( "tick %lu: task %d not woken\n", ( unsigned long ) xTickCount, i );
+					return 1;
+				}
+				xDelayed[ i ] = pdFALSE;
+				lTimeouts++;
+			}
+			else if( ( xDelayed[ i ] != pdFALSE ) && ( eState != eBlocked ) )
+			{
+				printf( "tick %lu: task %d woken before %lu\n", ( unsigned long ) xTickCount, i, ( unsigned long ) xWakeTimes[ i ] );
+				return 1;
+			}
+			else if( ( xDelayed[ i ] == pdFALSE ) && ( eState != eReady ) )
+			{
+				printf( "tick %lu: task %d in state %d\n", ( unsigned long ) xTickCount, i, ( int ) eState );
+				return 1;
+			}
+		}
+	}
+
+	/* uxTaskGetSystemState() walks the delayed tasks too. */
+	pxStatus = malloc( sizeof( TaskStatus_t ) * ( size_t ) ( iTasks + 2 ) );
+	uxCount = uxTaskGetSystemState( pxStatus, ( UBaseType_t ) iTasks + 2, NULL );
+	for( x = 0; x < uxCount; x++ )
+	{
+		uxBlocked += ( pxStatus[ x ].eCurrentState == eBlocked ) ? 1 : 0;
+	}
+	for( i = 0; i < iTasks; i++ )
+	{
+		uxExpected += ( xDelayed[ i ] != pdFALSE ) ? 1 : 0;
+	}
+	free( pxStatus );
+	if( uxBlocked != uxExpected )
+	{
+		printf( "%lu blocked tasks in the system state, expected %lu\n", ( unsigned long ) uxBlocked, ( unsigned long ) uxExpected );
+		return 1;
+	}
+
+	printf( "ok: %d tasks, start tick %lu, %ld ticks, %ld timeouts, %ld removals, end tick %lu, %lu blocked\n",
+			iTasks, ( unsigned long ) configINITIAL_TICK_COUNT, lTicks, lTimeouts, lRemovals, ( unsigned long ) xTickCount, ( unsigned long ) uxExpected );
+	return 0;
+}
+/*-----------------------------------------------------------*/
+
+static void prvBenchmark( int iTasks )
+{
+double dStart, dTime, dBlock = 0, dWorstBlock = 0, dTick;
+long lTimeouts = 0;
+TCB_t *pxTCB;
+int i, r;
+
+	/* One task more than the delayed ones is blocked and woken again. */
+	prvCreateTasks( iTasks + 1 );
+	for( i = 0; i < iTasks; i++ )
+	{
+		prvDelayTask( i, ( TickType_t ) ( 1000 + prvRandom() % 100000 ) );
+	}
+
+	for( r = 0; r < testREPETITIONS; r++ )
+	{
+		TickType_t xTicksToDelay = ( TickType_t ) ( 1 + prvRandom() % 100000 );
+
+		dStart = prvNanoseconds();
+		prvDelayTask( iTasks, xTicksToDelay );
+		dTime = prvNanoseconds() - dStart;
+		dBlock += dTime;
+		if( dTime > dWorstBlock )
+		{
+			dWorstBlock = dTime;
+		}
+
+		/* Take it out again, as an event would. */
+		pxTCB = ( TCB_t * ) xHandles[ iTasks ];
+		( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+		prvAddTaskToReadyList( pxTCB );
+		xDelayed[ iTasks ] = pdFALSE;
+	}
+
+	/* The tasks that time out are delayed again. */
+	dStart = prvNanoseconds();
+	for( r = 0; r < testREPETITIONS; r++ )
+	{
+		( void ) xTaskIncrementTick();
+		while( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ 1 ] ) ) > 2 )
+		{
+			pxTCB = listGET_OWNER_OF_HEAD_ENTRY( &( pxReadyTasksLists[ 1 ] ) );
+			i = ( int ) ( ( ( StaticTask_t * ) pxTCB ) - xTCBs );
+			if( i >= iTasks )
+			{
+				/* Move the tasks that stay ready to the end. */
+				( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+				vListInsertEnd( &( pxReadyTasksLists[ 1 ] ), &( pxTCB->xStateListItem ) );
+				continue;
+			}
+			prvDelayTask( i, ( TickType_t ) ( 1000 + prvRandom() % 100000 ) );
+			lTimeouts++;
+		}
+	}
+	dTick = prvNanoseconds() - dStart;
+
+	printf( "%s %6d delayed tasks: block %7.1f ns (worst %7.0f), tick %7.1f ns (%ld timeouts)\n",
+			( configUSE_TIMING_WHEEL == 1 ) ? "wheel" : "list ", iTasks, dBlock / testREPETITIONS, dWorstBlock, dTick / testREPETITIONS, lTimeouts );
+}
+/*-----------------------------------------------------------*/
+
+int main( int argc, char *argv[] )
+{
+	if( ( argc == 5 ) && ( strcmp( argv[ 1 ], "check" ) == 0 ) && ( atoi( argv[ 2 ] ) <= testMAX_TASKS ) )
+	{
+		return prvCheck( atoi( argv[ 2 ] ), ( TickType_t ) strtoul( argv[ 3 ], NULL, 0 ), atol( argv[ 4 ] ) );
+	}
+
+	if( ( argc == 3 ) && ( strcmp( argv[ 1 ], "bench" ) == 0 ) && ( atoi( argv[ 2 ] ) < testMAX_TASKS ) )
+	{
+		prvBenchmark( atoi( argv[ 2 ] ) );
+		return 0;
+	}
+
+	fprintf( stderr, "usage: %s check <tasks> <max delay> <ticks> | bench <tasks>\n", argv[ 0 ] );
+	return 2;
+}
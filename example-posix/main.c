@@ -0,0 +1,88 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "hal.h"
+#include "FreeRTOS.h" /* Must come first. */
+#include "task.h"     /* RTOS task related API prototypes. */
+#include "shell.h"
+#include "console.h"
+
+static const ShellCommand commands[] = {
+    {NULL, NULL}
+};
+
+static const ShellConfig shell_cfg_console = {
+    (BaseSequentialStream *)&CD1,
+    commands
+};
+
+static const ShellConfig shell_cfg_serial = {
+    (BaseSequentialStream *)&SD1,
+    commands
+};
+
+void vTaskLed( void * pvParameters )
+{
+    (void)pvParameters;
+
+    for( ;; ){
+        chnWrite(&SD2, (uint8_t*)"Test\r\n", 6);
+        osalThreadSleepMilliseconds(500);
+    }
+}
+
+int main(void) {
+
+	/*
+	 * System initializations.
+	 * - HAL initialization, this also initializes the configured device drivers
+	 *   and performs the board-specific initializations.
+	 */
+	halInit();
+	conInit();
+	shellInit();
+
+	/* SD1 runs a shell, SD2 prints a heartbeat. Connect with telnet to
+	   localhost:29001 and localhost:29002. */
+	sdStart(&SD1, NULL);
+	sdStart(&SD2, NULL);
+
+	TaskHandle_t xHandle;
+	xTaskCreate(shellThread, "CONSOLE", 1024, (void*)&shell_cfg_console, 2, &xHandle );
+	xTaskCreate(shellThread, "SERIAL", 1024, (void*)&shell_cfg_serial, 2, &xHandle );
+	xTaskCreate(vTaskLed, "LED", 1024, NULL, 1, &xHandle );
+
+	/*
+	 * Enabling interrupts, initialization done.
+	 */
+	osalSysEnable();
+
+	return 0;
+}
+
+void errorAssertCalled(const char* file, unsigned long line, const char* reason){
+    fprintf(stderr, "Assertion failed: %s:%lu %s\n", file, line, reason ? reason : "");
+    abort();
+}
+
+void vApplicationStackOverflowHook( TaskHandle_t xTask, char *pcTaskName ){
+    (void)xTask;
+    fprintf(stderr, "Stack overflow in task %s\n", pcTaskName);
+    abort();
+}
@@ -0,0 +1,194 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/*
+ * BLOG() records drained to a file, for binlog_decode.py.
+ *
+ * Usage: binlog_check log.bin expected.txt
+ *
+ * The records are logged with BLOG() and drained to log.bin. Each record
+ * that made it into the ring is also formatted with chsnprintf() into
+ * expected.txt, the decoder output without the time column must match it.
+ * The first pass drains often, the records wrap around the ring end. The
+ * second pass fills the ring without draining, the records that do not fit
+ * are dropped and reported by a lost record.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hal.h"
+#include "chprintf.h"
+#include "binlog.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+static FILE *log_file, *expected_file;
+static unsigned logged, dropped, split_drains;
+
+/* Logs a record, the expected text is written if it was not dropped.*/
+#define LOG(fmt, ...) do {                                                  \
+  uint32_t lost = binlog.lost;                                              \
+  char line[128];                                                           \
+                                                                            \
+  BLOG(fmt, __VA_ARGS__);                                                   \
+  if (binlog.lost == lost) {                                                \
+    chsnprintf(line, sizeof line, fmt, __VA_ARGS__);                        \
+    line[strcspn(line, "\r\n")] = '\0';                                     \
+    fprintf(expected_file, "%s\n", line);                                   \
+    logged++;                                                               \
+  }                                                                         \
+  else {                                                                    \
+    dropped++;                                                              \
+  }                                                                         \
+} while (false)
+
+static size_t file_write(void *ip, const uint8_t *bp, size_t n) {
+
+  (void)ip;
+  return fwrite(bp, 1U, n, log_file);
+}
+
+static size_t file_read(void *ip, uint8_t *bp, size_t n) {
+
+  (void)ip;
+  (void)bp;
+  (void)n;
+  return 0;
+}
+
+static msg_t file_put(void *ip, uint8_t b) {
+
+  return file_write(ip, &b, 1U) == 1U ? MSG_OK : MSG_RESET;
+}
+
+static msg_t file_get(void *ip) {
+
+  (void)ip;
+  return MSG_RESET;
+}
+
+static const struct BaseSequentialStreamVMT file_vmt = {
+  file_write, file_read, file_put, file_get
+};
+
+static BaseSequentialStream file_stream = {&file_vmt};
+
+static void drain(void) {
+  uint32_t tail = binlog.tail;
+
+  /* Records crossing the ring end are written in two parts.*/
+  if ((tail & (BINLOG_BUFFER_SIZE - 1U)) + (binlog.head - tail) >
+      BINLOG_BUFFER_SIZE) {
+    split_drains++;
+  }
+  blogDrain(&file_stream);
+}
+
+static void log_records(int i) {
+
+  switch (i % 5) {
+  case 0:
+    LOG("plain %d\r\n", i);
+    break;
+  case 1:
+    LOG("%5d|%-5d|%05d|%x|%X\r\n", -i, i, -i, (unsigned)i * 2654435761U, i);
+    break;
+  case 2:
+    LOG("%u %o %c%c 100%%\r\n", (unsigned)i * 40503U, i, 'a' + i % 26, 'Z');
+    break;
+  case 3:
+    LOG("eight %d %d %d %d %d %d %d %d\r\n",
+        i, i + 1, i + 2, i + 3, i + 4, i + 5, i + 6, i + 7);
+    break;
+  default:
+    LOG("%*d|%-*u|\r\n", i % 7 + 1, i, i % 5 + 2, (unsigned)i);
+    break;
+  }
+}
+
+static void check_task(void *arg) {
+  unsigned wrap_logged;
+  int i;
+
+  (void)arg;
+  blogInit();
+
+  /* Drained every three records, the ring wraps many times.*/
+  for (i = 0; i < 300; i++) {
+    log_records(i);
+    if (i % 3 == 2) {
+      drain();
+    }
+  }
+  drain();
+  wrap_logged = logged;
+  if ((dropped != 0U) || (split_drains == 0U) ||
+      (binlog.head < 10U * BINLOG_BUFFER_SIZE)) {
+    printf("wrap pass: %u dropped, %u split drains\n", dropped, split_drains);
+    exit(1);
+  }
+
+  /* Not drained, the ring fills up.*/
+  for (i = 0; i < 60; i++) {
+    log_records(i);
+  }
+  if (dropped == 0U) {
+    printf("full pass: nothing dropped\n");
+    exit(1);
+  }
+  drain();
+  fprintf(expected_file, "*** %u records lost\n", dropped);
+
+  /* The loss is only reported once.*/
+  LOG("after %d\r\n", 1);
+  drain();
+
+  printf("binlog: %u records wrapping, %u filling, %u dropped\n",
+         wrap_logged, logged - wrap_logged, dropped);
+  fclose(log_file);
+  fclose(expected_file);
+  exit(0);
+}
+
+int main(int argc, char *argv[]) {
+
+  if (argc != 3) {
+    printf("usage: %s log.bin expected.txt\n", argv[0]);
+    return 1;
+  }
+  log_file = fopen(argv[1], "wb");
+  expected_file = fopen(argv[2], "w");
+  if ((log_file == NULL) || (expected_file == NULL)) {
+    perror("fopen");
+    return 1;
+  }
+  xTaskCreate(check_task, "check", 1024, NULL, 1, NULL);
+  vTaskStartScheduler();
+  return 1;
+}
+
+void errorAssertCalled(const char* file, unsigned long line, const char* reason){
+    fprintf(stderr, "Assertion failed: %s:%lu %s\n", file, line, reason ? reason : "");
+    abort();
+}
+
+void vApplicationStackOverflowHook( TaskHandle_t xTask, char *pcTaskName ){
+    (void)xTask;
+    fprintf(stderr, "Stack overflow in task %s\n", pcTaskName);
+    abort();
+}
@@ -0,0 +1,217 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/*
+ * Buffers queues borrow and return functions.
+ *
+ * Data lent by ibqBorrowTimeout() and obqBorrowTimeout() is returned in
+ * parts, mixed with the copying reads and writes. The output queue is
+ * flushed while a buffer is lent, which must not post it. Borrowing from an
+ * empty input queue or a full output queue times out, or waits for another
+ * task to post or release a buffer.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hal.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define BQ_SIZE         16U
+#define BQ_NUM          2U
+#define WAIT_TICKS      5
+
+static uint8_t ibq_buffers[BQ_BUFFER_SIZE(BQ_NUM, BQ_SIZE)];
+static uint8_t obq_buffers[BQ_BUFFER_SIZE(BQ_NUM, BQ_SIZE)];
+static input_buffers_queue_t ibq;
+static output_buffers_queue_t obq;
+static unsigned checks;
+
+static void check(bool ok, const char *what) {
+
+  checks++;
+  if (!ok) {
+    printf("FAILED: %s\n", what);
+    exit(1);
+  }
+}
+
+static void ibq_post(const char *s) {
+
+  osalSysLock();
+  memcpy(ibqGetEmptyBufferI(&ibq), s, strlen(s));
+  ibqPostFullBufferI(&ibq, strlen(s));
+  osalSysUnlock();
+}
+
+/* Takes the next posted output buffer, as a transmitter would.*/
+static size_t obq_take(uint8_t *bp) {
+  uint8_t *p;
+  size_t n = 0U;
+
+  osalSysLock();
+  p = obqGetFullBufferI(&obq, &n);
+  if (p != NULL) {
+    memcpy(bp, p, n);
+    obqReleaseEmptyBufferI(&obq);
+  }
+  osalSysUnlock();
+
+  return p != NULL ? n : 0U;
+}
+
+static void check_ibq(void) {
+  uint8_t buf[BQ_SIZE], *bp, *first;
+  size_t n;
+
+  ibq_post("0123456789");
+
+  /* Partial returns, the remaining data is lent again.*/
+  n = ibqBorrowTimeout(&ibq, &first, TIME_IMMEDIATE);
+  check((n == 10U) && (memcmp(first, "0123456789", 10) == 0), "ibq borrow");
+  ibqReturn(&ibq, 4U);
+  n = ibqBorrowTimeout(&ibq, &bp, TIME_IMMEDIATE);
+  check((n == 6U) && (bp == first + 4), "ibq borrow after a partial return");
+  ibqReturn(&ibq, 0U);
+
+  /* A copying read takes over where the returned data ends.*/
+  check((ibqReadTimeout(&ibq, buf, 3U, TIME_IMMEDIATE) == 3U) &&
+        (memcmp(buf, "456", 3) == 0), "ibq read after a return");
+  n = ibqBorrowTimeout(&ibq, &bp, TIME_IMMEDIATE);
+  check((n == 3U) && (memcmp(bp, "789", 3) == 0), "ibq borrow after a read");
+
+  /* Returning the last byte releases the buffer.*/
+  ibqReturn(&ibq, n);
+  osalSysLock();
+  check(ibqIsEmptyI(&ibq), "ibq buffer released");
+  osalSysUnlock();
+  check(ibqBorrowTimeout(&ibq, &bp, TIME_IMMEDIATE) == 0U, "ibq borrow when empty");
+}
+
+static void check_obq(void) {
+  uint8_t buf[BQ_SIZE], *bp, *first;
+  size_t n;
+  bool flushed;
+
+  /* Partial returns, the remaining space is lent again.*/
+  n = obqBorrowTimeout(&obq, &first, TIME_IMMEDIATE);
+  check(n == BQ_SIZE, "obq borrow");
+  memcpy(first, "abcde", 5);
+  obqReturn(&obq, 5U);
+  n = obqBorrowTimeout(&obq, &bp, TIME_IMMEDIATE);
+  check((n == BQ_SIZE - 5U) && (bp == first + 5), "obq borrow after a partial return");
+
+  /* A lent buffer is not flushed.*/
+  memcpy(bp, "fgh", 3);
+  osalSysLock();
+  flushed = obqTryFlushI(&obq);
+  osalSysUnlock();
+  check(!flushed, "obqTryFlushI() while lent");
+  obqFlush(&obq);
+  check(obq_take(buf) == 0U, "obqFlush() while lent");
+
+  /* Once returned it is.*/
+  obqReturn(&obq, 3U);
+  check(obqWriteTimeout(&obq, (const uint8_t *)"ij", 2U, TIME_IMMEDIATE) == 2U,
+        "obq write after a return");
+  obqFlush(&obq);
+  n = obq_take(buf);
+  check((n == 10U) && (memcmp(buf, "abcdefghij", 10) == 0), "obq flush after a return");
+
+  /* Returning the whole space posts the buffer.*/
+  n = obqBorrowTimeout(&obq, &bp, TIME_IMMEDIATE);
+  memset(bp, 'x', n);
+  obqReturn(&obq, n);
+  check(obq_take(buf) == BQ_SIZE, "obq buffer posted when full");
+}
+
+static void ibq_poster(void *arg) {
+
+  (void)arg;
+  vTaskDelay(WAIT_TICKS);
+  ibq_post("late");
+  vTaskDelete(NULL);
+}
+
+static void obq_taker(void *arg) {
+  uint8_t buf[BQ_SIZE];
+
+  (void)arg;
+  vTaskDelay(WAIT_TICKS);
+  (void)obq_take(buf);
+  vTaskDelete(NULL);
+}
+
+static void check_timeouts(void) {
+  uint8_t *bp;
+  systime_t start;
+  size_t n;
+
+  /* Empty input queue.*/
+  start = osalOsGetSystemTimeX();
+  n = ibqBorrowTimeout(&ibq, &bp, WAIT_TICKS);
+  check((n == 0U) && (osalOsGetSystemTimeX() - start >= WAIT_TICKS),
+        "ibq borrow timeout");
+  xTaskCreate(ibq_poster, "poster", 1024, NULL, 1, NULL);
+  n = ibqBorrowTimeout(&ibq, &bp, TIME_INFINITE);
+  check((n == 4U) && (memcmp(bp, "late", 4) == 0), "ibq borrow woken by a post");
+  ibqReturn(&ibq, n);
+
+  /* Full output queue.*/
+  while ((n = obqBorrowTimeout(&obq, &bp, TIME_IMMEDIATE)) != 0U) {
+    obqReturn(&obq, n);
+  }
+  start = osalOsGetSystemTimeX();
+  n = obqBorrowTimeout(&obq, &bp, WAIT_TICKS);
+  check((n == 0U) && (osalOsGetSystemTimeX() - start >= WAIT_TICKS),
+        "obq borrow timeout");
+  xTaskCreate(obq_taker, "taker", 1024, NULL, 1, NULL);
+  n = obqBorrowTimeout(&obq, &bp, TIME_INFINITE);
+  check(n == BQ_SIZE, "obq borrow woken by a release");
+  obqReturn(&obq, 0U);
+}
+
+static void check_task(void *arg) {
+
+  (void)arg;
+  ibqObjectInit(&ibq, false, ibq_buffers, BQ_SIZE, BQ_NUM, NULL, NULL);
+  obqObjectInit(&obq, false, obq_buffers, BQ_SIZE, BQ_NUM, NULL, NULL);
+  check_ibq();
+  check_obq();
+  check_timeouts();
+  printf("buffers ok: %u checks\n", checks);
+  exit(0);
+}
+
+int main(void) {
+
+  xTaskCreate(check_task, "check", 1024, NULL, 2, NULL);
+  vTaskStartScheduler();
+  return 1;
+}
+
+void errorAssertCalled(const char* file, unsigned long line, const char* reason){
+    fprintf(stderr, "Assertion failed: %s:%lu %s\n", file, line, reason ? reason : "");
+    abort();
+}
+
+void vApplicationStackOverflowHook( TaskHandle_t xTask, char *pcTaskName ){
+    (void)xTask;
+    fprintf(stderr, "Stack overflow in task %s\n", pcTaskName);
+    abort();
+}
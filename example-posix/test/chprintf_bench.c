@@ -0,0 +1,206 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/*
+ * Buffered chvprintf() against the per character path.
+ *
+ * chprintf.c is linked a second time built with CHPRINTF_BUFFER_SIZE set to
+ * zero, its functions renamed with an _unbuffered suffix. Both versions
+ * format the same lines to a sink that takes a critical section per call,
+ * like a serial output queue. The output is checked to be identical, then
+ * the throughput and the number of stream calls per line are printed.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "hal.h"
+#include "chprintf.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define LINES       200000
+#define RING_SIZE   4096
+
+int chvprintf_unbuffered(BaseSequentialStream *chp, const char *fmt, va_list ap);
+
+typedef int (*vprintf_t)(BaseSequentialStream *chp, const char *fmt, va_list ap);
+
+static uint8_t ring[RING_SIZE];
+static size_t ring_wr, sink_calls;
+
+static size_t sink_write(void *ip, const uint8_t *bp, size_t n) {
+  size_t i;
+
+  (void)ip;
+  osalSysLock();
+  for (i = 0; i < n; i++) {
+    ring[ring_wr++ % RING_SIZE] = bp[i];
+  }
+  sink_calls++;
+  osalSysUnlock();
+  return n;
+}
+
+static size_t sink_read(void *ip, uint8_t *bp, size_t n) {
+
+  (void)ip;
+  (void)bp;
+  (void)n;
+  return 0;
+}
+
+static msg_t sink_put(void *ip, uint8_t b) {
+
+  (void)ip;
+  osalSysLock();
+  ring[ring_wr++ % RING_SIZE] = b;
+  sink_calls++;
+  osalSysUnlock();
+  return MSG_OK;
+}
+
+static msg_t sink_get(void *ip) {
+
+  (void)ip;
+  return MSG_RESET;
+}
+
+static const struct BaseSequentialStreamVMT sink_vmt = {
+  sink_write, sink_read, sink_put, sink_get
+};
+
+static BaseSequentialStream sink = {&sink_vmt};
+
+static int print(vprintf_t fn, const char *fmt, ...) {
+  va_list ap;
+  int n;
+
+  va_start(ap, fmt);
+  n = fn(&sink, fmt, ap);
+  va_end(ap);
+  return n;
+}
+
+static double now(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static const char *const formats[] = {
+  "sensor %s: temp=%d raw=%04x t=%lu\r\n",
+  "%-10s|%5d|%-5d|%08X|%c\r\n",
+  "plain log line without arguments\r\n"
+};
+
+static const char *const names[] = {
+  "sensor line, 4 args",
+  "padded fields, 5 args",
+  "plain text"
+};
+
+static void fail(const char *what, int i) {
+
+  printf("%s differs at %d\n", what, i);
+  exit(1);
+}
+
+static void check(void) {
+  static const char fmt[] = "%d %5d %-5d|%05d %x %X %o %lu %U %c %s %.3s "
+                            "%10s %-10s| %% %*d %ld\r\n";
+  static char big[300];
+  uint8_t a[200];
+  size_t na;
+  int ra, rb, i;
+
+  for (i = -3000; i < 3000; i += 7) {
+    ring_wr = 0;
+    ra = print(chvprintf_unbuffered, fmt, i, i, i, i, i, (unsigned)i,
+               (unsigned)i, (unsigned long)i, (unsigned long)i, 'q', "str",
+               "abcdef", "right", "left", 6, i, (long)i);
+    na = ring_wr;
+    memcpy(a, ring, na);
+    ring_wr = 0;
+    rb = print(chvprintf, fmt, i, i, i, i, i, (unsigned)i,
+               (unsigned)i, (unsigned long)i, (unsigned long)i, 'q', "str",
+               "abcdef", "right", "left", 6, i, (long)i);
+    if ((ra != rb) || (na != ring_wr) || (memcmp(a, ring, na) != 0)) {
+      fail("output", i);
+    }
+  }
+
+  /* A string longer than the buffer.*/
+  memset(big, 'x', sizeof big - 1U);
+  ring_wr = 0;
+  ra = print(chvprintf_unbuffered, "%s%s", big, big);
+  na = ring_wr;
+  ring_wr = 0;
+  rb = print(chvprintf, "%s%s", big, big);
+  if ((ra != rb) || (na != ring_wr) || (ring_wr != 2U * (sizeof big - 1U))) {
+    fail("long string output", 0);
+  }
+  printf("output identical\n");
+}
+
+static void run(int k, vprintf_t fn, const char *name) {
+  size_t bytes = 0;
+  double t;
+  int i;
+
+  sink_calls = 0;
+  t = now();
+  for (i = 0; i < LINES; i++) {
+    bytes += print(fn, formats[k], "imu0", -i, i, (unsigned long)i * 7U, 'z');
+  }
+  t = now() - t;
+  printf("  %-10s %8.1f Mchar/s %6.1f calls/line\n",
+         name, bytes / t / 1e6, (double)sink_calls / LINES);
+}
+
+static void bench_task(void *arg) {
+  unsigned k;
+
+  (void)arg;
+  check();
+  for (k = 0; k < sizeof formats / sizeof formats[0]; k++) {
+    printf("%s\n", names[k]);
+    run(k, chvprintf_unbuffered, "unbuffered");
+    run(k, chvprintf, "buffered");
+  }
+  exit(0);
+}
+
+int main(void) {
+
+  xTaskCreate(bench_task, "bench", 1024, NULL, 1, NULL);
+  vTaskStartScheduler();
+  return 1;
+}
+
+void errorAssertCalled(const char* file, unsigned long line, const char* reason){
+    fprintf(stderr, "Assertion failed: %s:%lu %s\n", file, line, reason ? reason : "");
+    abort();
+}
+
+void vApplicationStackOverflowHook( TaskHandle_t xTask, char *pcTaskName ){
+    (void)xTask;
+    fprintf(stderr, "Stack overflow in task %s\n", pcTaskName);
+    abort();
+}
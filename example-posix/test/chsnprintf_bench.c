@@ -0,0 +1,101 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/*
+ * Time per chsnprintf() call for integer and float conversions.
+ *
+ * The reference is the C library snprintf(). Built with CHSNPRINTF_REF
+ * defined, it is chsnprintf_ref() instead, from another chprintf.c built
+ * with its functions renamed, for example the version before a change:
+ *   git show <commit>:ChibiOS/os/hal/lib/streams/chprintf.c > /tmp/old.c
+ *   make bench CHPRINTF_REF=/tmp/old.c
+ */
+
+#include <stdio.h>
+#include <time.h>
+
+#include "hal.h"
+#include "chprintf.h"
+
+#define CALLS       3000000
+
+#if defined(CHSNPRINTF_REF)
+int chsnprintf_ref(char *str, size_t size, const char *fmt, ...);
+#define REF_NAME    "ref"
+#define REF_FN      chsnprintf_ref
+#else
+#define REF_NAME    "libc"
+#define REF_FN      snprintf
+#endif
+
+typedef int (*snprintf_t)(char *str, size_t size, const char *fmt, ...);
+
+static volatile int sink;
+
+static double now(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static double time_integer(snprintf_t fn, const char *fmt) {
+  char buf[64];
+  double t;
+  int i;
+
+  t = now();
+  for (i = 0; i < CALLS; i++) {
+    sink += fn(buf, sizeof buf, fmt, (int)((unsigned)i * 7919U),
+               (unsigned)i * 2654435761U, i);
+  }
+  return (now() - t) * 1e9 / CALLS;
+}
+
+static double time_float(snprintf_t fn, const char *fmt) {
+  char buf[64];
+  double t;
+  int i;
+
+  t = now();
+  for (i = 0; i < CALLS; i++) {
+    sink += fn(buf, sizeof buf, fmt, (double)((float)i * 0.37f - 1000.0f),
+               (double)((float)i * 1e-5f));
+  }
+  return (now() - t) * 1e9 / CALLS;
+}
+
+int main(void) {
+  static const char *const integer_formats[] = {
+    "%d", "%u", "%x", "%d %u %x"
+  };
+  unsigned k;
+
+  printf("ns per call      %8s chsnprintf\n", REF_NAME);
+  for (k = 0; k < sizeof integer_formats / sizeof integer_formats[0]; k++) {
+    printf("%-16s %8.1f %10.1f\n", integer_formats[k],
+           time_integer(REF_FN, integer_formats[k]),
+           time_integer(chsnprintf, integer_formats[k]));
+  }
+#if CHPRINTF_USE_FLOAT
+  printf("%-16s %8.1f %10.1f\n", "%.3f %.6f",
+         time_float(REF_FN, "%.3f %.6f"),
+         time_float(chsnprintf, "%.3f %.6f"));
+#else
+  (void)time_float;
+#endif
+  return 0;
+}
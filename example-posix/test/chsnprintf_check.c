@@ -0,0 +1,129 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/*
+ * chsnprintf() number conversions against the C library snprintf().
+ *
+ * Usage: chsnprintf_check [float_step]
+ *
+ * Integers: every value below 2e7, then every 9973rd up to 2^32, with all
+ * the integer conversions, plus edge values and field widths.
+ * Floats: every float_step-th float bit pattern (default 1, all 2^32 of
+ * them, which takes about an hour), the precision rotating from 1 to 9.
+ *
+ * Built with __ARM_ARCH_6M__ defined, chprintf.c uses the subtract only
+ * decimal conversion. Its table covers 32 bit longs, as on ARMv6-M, so the
+ * 64 bit edge values are skipped.
+ */
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hal.h"
+#include "chprintf.h"
+
+#define DENSE_LIMIT     20000000U
+#define SPARSE_STEP     9973U
+
+static char a[128], b[128];
+
+static void fail(void) {
+
+  printf("MISMATCH chsnprintf \"%s\" snprintf \"%s\"\n", a, b);
+  exit(1);
+}
+
+static void check_integers(void) {
+  static const unsigned long edges[] = {
+    0UL, 1UL, 9UL, 10UL, 99UL, 100UL, 999999999UL, 1000000000UL,
+    0x7FFFFFFFUL, 0x80000000UL, 0xFFFFFFFFUL,
+#if ULONG_MAX > 0xFFFFFFFFUL
+    10000000000UL, 9999999999999999999UL, 10000000000000000000UL,
+    ULONG_MAX / 10U, ULONG_MAX
+#endif
+  };
+  unsigned long long u, count = 0;
+  unsigned i;
+
+  for (u = 0; u <= 0xFFFFFFFFULL; u += (u < DENSE_LIMIT) ? 1U : SPARSE_STEP) {
+    uint32_t v = (uint32_t)u;
+    long sv = (long)(int32_t)v;
+
+    chsnprintf(a, sizeof a, "%u %d %x %o %D %U %X",
+               v, (int)v, v, v, sv, (unsigned long)v, (unsigned long)v);
+    snprintf(b, sizeof b, "%u %d %X %o %ld %lu %lX",
+             v, (int)v, v, v, sv, (unsigned long)v, (unsigned long)v);
+    if (strcmp(a, b) != 0) {
+      fail();
+    }
+    count++;
+  }
+
+  for (i = 0; i < sizeof edges / sizeof edges[0]; i++) {
+    unsigned long v = edges[i];
+
+#if defined(__ARM_ARCH_6M__) && (ULONG_MAX > 0xFFFFFFFFUL)
+    if (v > 0xFFFFFFFFUL) {
+      continue;
+    }
+#endif
+    chsnprintf(a, sizeof a, "%U|%X|%O|%D|%5d|%-5d|%05d|%08lx",
+               v, v, v, (long)v, -42, -42, -42, 0xABCUL);
+    snprintf(b, sizeof b, "%lu|%lX|%lo|%ld|%5d|%-5d|%05d|%08lX",
+             v, v, v, (long)v, -42, -42, -42, 0xABCUL);
+    if (strcmp(a, b) != 0) {
+      fail();
+    }
+    count++;
+  }
+  printf("integers ok: %llu\n", count);
+}
+
+static void check_floats(unsigned long long step) {
+  unsigned long long u, count = 0;
+
+  for (u = 0; u <= 0xFFFFFFFFULL; u += step) {
+    uint32_t bits = (uint32_t)u;
+    int prec = (int)(u % 9U) + 1;
+    float f;
+
+    memcpy(&f, &bits, sizeof f);
+    chsnprintf(a, sizeof a, "%.*f", prec, f);
+    snprintf(b, sizeof b, "%.*f", prec, (double)f);
+    if (strcmp(a, b) != 0) {
+      printf("bits %08X precision %d\n", (unsigned)bits, prec);
+      fail();
+    }
+    count++;
+  }
+  printf("floats ok: %llu\n", count);
+}
+
+int main(int argc, char *argv[]) {
+  unsigned long long step = 1U;
+
+  if (argc > 1) {
+    step = strtoull(argv[1], NULL, 0);
+    if (step == 0U) {
+      step = 1U;
+    }
+  }
+  check_integers();
+  check_floats(step);
+  return 0;
+}
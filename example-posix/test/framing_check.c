@@ -0,0 +1,553 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/*
+ * framing.c round trips in the three framing modes.
+ *
+ * The frames cover the COBS block boundaries (253, 254, 255 and 508 bytes,
+ * zeros at the end of a block, runs of zeros), the SLIP END and ESC bytes
+ * and the empty frame. Each frame is encoded to memory and decoded in
+ * chunks of several sizes, then sent through a channel and through the
+ * buffers queues. Oversized frames, truncated frames and a full sink are
+ * also checked.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hal.h"
+#include "framing.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define MAX_FRAME       600U
+#define MAX_ENCODED     FRM_MAX_ENCODED_SIZE(MAX_FRAME)
+#define STREAM_SIZE     (16U * MAX_ENCODED)
+#define BQ_SIZE         48U
+#define BQ_NUM          3U
+
+static const char *const mode_names[] = {"COBS", "SLIP", "length"};
+
+/* Frame under test and the decoder output.*/
+static uint8_t frame[MAX_FRAME];
+static size_t frame_len;
+static uint8_t rx[MAX_FRAME];
+static size_t rx_len;
+static unsigned rx_frames;
+static const char *what;
+
+/* Byte stream behind the test channel.*/
+static uint8_t stream[STREAM_SIZE];
+static size_t stream_wr, stream_rd, stream_room;
+
+static uint8_t ibq_buffers[BQ_BUFFER_SIZE(BQ_NUM, BQ_SIZE)];
+static uint8_t obq_buffers[BQ_BUFFER_SIZE(BQ_NUM, BQ_SIZE)];
+static input_buffers_queue_t ibq;
+static output_buffers_queue_t obq;
+static FrameDecoder *obq_decoder;
+
+static void fail(frmmode_t mode, const char *why) {
+
+  printf("%s, %s frame of %u bytes: %s\n",
+         what, mode_names[mode], (unsigned)frame_len, why);
+  exit(1);
+}
+
+static void received(FrameDecoder *fdp, const uint8_t *fp, size_t n) {
+
+  (void)fdp;
+  memcpy(rx, fp, n);
+  rx_len = n;
+  rx_frames++;
+}
+
+static void check_received(frmmode_t mode, unsigned frames) {
+
+  if ((rx_frames != frames) || (rx_len != frame_len) ||
+      (memcmp(rx, frame, frame_len) != 0)) {
+    fail(mode, "decoded frame differs");
+  }
+}
+
+/*
+ * Test channel, writes append to the stream while there is room, reads
+ * consume it.
+ */
+static size_t chn_writet(void *ip, const uint8_t *bp, size_t n, systime_t time) {
+
+  (void)ip;
+  (void)time;
+  if (n > stream_room - stream_wr) {
+    n = stream_room - stream_wr;
+  }
+  memcpy(stream + stream_wr, bp, n);
+  stream_wr += n;
+  return n;
+}
+
+static size_t chn_readt(void *ip, uint8_t *bp, size_t n, systime_t time) {
+
+  (void)ip;
+  (void)time;
+  if (n > stream_wr - stream_rd) {
+    n = stream_wr - stream_rd;
+  }
+  memcpy(bp, stream + stream_rd, n);
+  stream_rd += n;
+  return n;
+}
+
+static msg_t chn_putt(void *ip, uint8_t b, systime_t time) {
+
+  return chn_writet(ip, &b, 1U, time) == 1U ? MSG_OK : MSG_TIMEOUT;
+}
+
+static msg_t chn_gett(void *ip, systime_t time) {
+  uint8_t b;
+
+  return chn_readt(ip, &b, 1U, time) == 1U ? (msg_t)b : MSG_TIMEOUT;
+}
+
+static size_t chn_write(void *ip, const uint8_t *bp, size_t n) {
+
+  return chn_writet(ip, bp, n, TIME_INFINITE);
+}
+
+static size_t chn_read(void *ip, uint8_t *bp, size_t n) {
+
+  return chn_readt(ip, bp, n, TIME_INFINITE);
+}
+
+static msg_t chn_put(void *ip, uint8_t b) {
+
+  return chn_putt(ip, b, TIME_INFINITE);
+}
+
+static msg_t chn_get(void *ip) {
+
+  return chn_gett(ip, TIME_INFINITE);
+}
+
+static const struct BaseChannelVMT chn_vmt = {
+  chn_write, chn_read, chn_put, chn_get,
+  chn_putt, chn_gett, chn_writet, chn_readt
+};
+
+static BaseChannel chn = {&chn_vmt};
+
+static void stream_reset(size_t room) {
+
+  stream_wr   = 0U;
+  stream_rd   = 0U;
+  stream_room = room;
+}
+
+/*
+ * Output queue notification, plays the transmitter and decodes every
+ * posted buffer.
+ */
+static void obq_notify(io_buffers_queue_t *bqp) {
+  uint8_t *bp;
+  size_t n;
+
+  (void)bqp;
+  if (obq_decoder == NULL) {
+    return;
+  }
+  while ((bp = obqGetFullBufferI(&obq, &n)) != NULL) {
+    frmDecode(obq_decoder, bp, n);
+    obqReleaseEmptyBufferI(&obq);
+  }
+}
+
+static void make_frame(unsigned kind, size_t n) {
+  static uint32_t seed = 1U;
+  size_t i;
+
+  frame_len = n;
+  for (i = 0; i < n; i++) {
+    seed = seed * 1103515245U + 12345U;
+    switch (kind) {
+    case 0:
+      /* Random, with the special bytes of all the modes.*/
+      frame[i] = (uint8_t)(seed >> 16);
+      if ((seed & 0x700U) == 0U) {
+        frame[i] = (seed & 0x800U) != 0U ? 0U : FRM_SLIP_END;
+      }
+      else if ((seed & 0x7000U) == 0U) {
+        frame[i] = FRM_SLIP_ESC;
+      }
+      break;
+    case 1:
+      /* No zeros, the COBS blocks are full.*/
+      frame[i] = (uint8_t)(i % 255U + 1U);
+      break;
+    case 2:
+      /* A zero ending each COBS block.*/
+      frame[i] = (i % 254U == 253U) ? 0U : 0x55U;
+      break;
+    case 3:
+      frame[i] = 0U;
+      break;
+    default:
+      /* Only SLIP special characters.*/
+      frame[i] = (i & 1U) != 0U ? FRM_SLIP_END : FRM_SLIP_ESC;
+      break;
+    }
+  }
+}
+
+static void check_encoding(frmmode_t mode, const uint8_t *ep, size_t n) {
+  size_t i;
+
+  if ((n == 0U) || (n > FRM_MAX_ENCODED_SIZE(frame_len))) {
+    fail(mode, "bad encoded size");
+  }
+  switch (mode) {
+  case FRM_COBS:
+    for (i = 0; i < n - 1U; i++) {
+      if (ep[i] == 0U) {
+        fail(mode, "zero inside a COBS frame");
+      }
+    }
+    if (ep[n - 1U] != 0U) {
+      fail(mode, "COBS frame not terminated");
+    }
+    break;
+  case FRM_SLIP:
+    for (i = 1; i < n - 1U; i++) {
+      if (ep[i] == FRM_SLIP_END) {
+        fail(mode, "END inside a SLIP frame");
+      }
+    }
+    if ((ep[0] != FRM_SLIP_END) || (ep[n - 1U] != FRM_SLIP_END)) {
+      fail(mode, "SLIP frame not delimited");
+    }
+    break;
+  default:
+    if ((n != frame_len + 2U) ||
+        ((size_t)ep[0] + ((size_t)ep[1] << 8) != frame_len)) {
+      fail(mode, "bad length prefix");
+    }
+    break;
+  }
+}
+
+/* Empty SLIP frames are not delivered.*/
+static unsigned expected_frames(frmmode_t mode, unsigned frames) {
+
+  return (mode == FRM_SLIP) && (frame_len == 0U) ? 0U : frames;
+}
+
+static void roundtrip_mem(frmmode_t mode) {
+  static const size_t chunks[] = {1U, 2U, 3U, 7U, 64U, 255U, MAX_ENCODED};
+  uint8_t enc[MAX_ENCODED], buf[MAX_FRAME];
+  FrameDecoder fd;
+  size_t n, i, k;
+
+  what = "mem";
+  n = frmEncode(mode, frame, frame_len, enc, sizeof enc);
+  check_encoding(mode, enc, n);
+  if ((frmEncode(mode, frame, frame_len, enc, n - 1U) != 0U) ||
+      (frmEncode(mode, frame, frame_len, enc, n) != n)) {
+    fail(mode, "output buffer size not honoured");
+  }
+
+  for (k = 0; k < sizeof chunks / sizeof chunks[0]; k++) {
+    frmObjectInit(&fd, mode, buf, sizeof buf, received, NULL);
+    rx_frames = 0U;
+    rx_len = 0U;
+    /* Twice, the decoder must be ready for the next frame.*/
+    for (i = 0; i < 2U * n; i += chunks[k]) {
+      size_t m = 2U * n - i < chunks[k] ? 2U * n - i : chunks[k];
+      size_t j = i % n;
+
+      /* Chunks crossing the end of the first copy are split.*/
+      if (j + m > n) {
+        frmDecode(&fd, enc + j, n - j);
+        frmDecode(&fd, enc, j + m - n);
+      }
+      else {
+        frmDecode(&fd, enc + j, m);
+      }
+    }
+    check_received(mode, expected_frames(mode, 2U));
+    if (frmGetErrorsX(&fd) != 0U) {
+      fail(mode, "unexpected decoder error");
+    }
+  }
+}
+
+static void roundtrip_chn(frmmode_t mode) {
+  uint8_t buf[MAX_FRAME];
+  FrameDecoder fd;
+  size_t n;
+
+  what = "chn";
+  frmObjectInit(&fd, mode, buf, sizeof buf, received, NULL);
+  rx_frames = 0U;
+  rx_len = 0U;
+  stream_reset(STREAM_SIZE);
+  if ((frmWriteTimeout(mode, &chn, frame, frame_len, TIME_IMMEDIATE) != MSG_OK) ||
+      (frmWriteTimeout(mode, &chn, frame, frame_len, TIME_IMMEDIATE) != MSG_OK)) {
+    fail(mode, "channel write failed");
+  }
+  n = stream_wr / 2U;
+  check_encoding(mode, stream, n);
+  while (stream_rd < stream_wr) {
+    frmReadTimeout(&fd, &chn, TIME_IMMEDIATE);
+  }
+  check_received(mode, expected_frames(mode, 2U));
+
+  /* A channel accepting one byte less than the frame.*/
+  stream_reset(n - 1U);
+  if (frmWriteTimeout(mode, &chn, frame, frame_len, TIME_IMMEDIATE) != MSG_TIMEOUT) {
+    fail(mode, "channel full not reported");
+  }
+}
+
+static void roundtrip_obq(frmmode_t mode) {
+  uint8_t buf[MAX_FRAME];
+  FrameDecoder fd;
+
+  what = "obq";
+  frmObjectInit(&fd, mode, buf, sizeof buf, received, NULL);
+  rx_frames = 0U;
+  rx_len = 0U;
+  osalSysLock();
+  obqResetI(&obq);
+  osalSysUnlock();
+  obq_decoder = &fd;
+  if ((frmWriteBuffers(mode, &obq, frame, frame_len, TIME_IMMEDIATE) != MSG_OK) ||
+      (frmWriteBuffers(mode, &obq, frame, frame_len, TIME_IMMEDIATE) != MSG_OK)) {
+    fail(mode, "buffers write failed");
+  }
+  obqFlush(&obq);
+  check_received(mode, expected_frames(mode, 2U));
+
+  /* Nobody draining the queue, the frame does not fit its buffers.*/
+  if (frame_len + 2U > BQ_NUM * BQ_SIZE) {
+    osalSysLock();
+    obqResetI(&obq);
+    osalSysUnlock();
+    obq_decoder = NULL;
+    if (frmWriteBuffers(mode, &obq, frame, frame_len, TIME_IMMEDIATE) != MSG_TIMEOUT) {
+      fail(mode, "buffers full not reported");
+    }
+  }
+}
+
+static void roundtrip_ibq(frmmode_t mode) {
+  uint8_t enc[MAX_ENCODED], buf[MAX_FRAME];
+  FrameDecoder fd;
+  size_t n, i;
+
+  what = "ibq";
+  frmObjectInit(&fd, mode, buf, sizeof buf, received, NULL);
+  rx_frames = 0U;
+  rx_len = 0U;
+  osalSysLock();
+  ibqResetI(&ibq);
+  osalSysUnlock();
+  n = frmEncode(mode, frame, frame_len, enc, sizeof enc);
+  for (i = 0; i < n; i += BQ_SIZE) {
+    size_t m = n - i < BQ_SIZE ? n - i : BQ_SIZE;
+
+    osalSysLock();
+    memcpy(ibqGetEmptyBufferI(&ibq), enc + i, m);
+    ibqPostFullBufferI(&ibq, m);
+    osalSysUnlock();
+    frmReadBuffers(&fd, &ibq, TIME_IMMEDIATE);
+  }
+  if (frmReadBuffers(&fd, &ibq, TIME_IMMEDIATE) != 0U) {
+    fail(mode, "data left in the queue");
+  }
+  check_received(mode, expected_frames(mode, 1U));
+}
+
+static void check_cobs_blocks(void) {
+  uint8_t enc[MAX_ENCODED];
+  size_t n;
+
+  what = "COBS blocks";
+  make_frame(1U, 254U);
+  n = frmEncode(FRM_COBS, frame, frame_len, enc, sizeof enc);
+  if ((n != 256U) || (enc[0] != 0xFFU) || (enc[255] != 0U)) {
+    fail(FRM_COBS, "254 bytes must be one full block");
+  }
+  make_frame(1U, 255U);
+  n = frmEncode(FRM_COBS, frame, frame_len, enc, sizeof enc);
+  if ((n != 258U) || (enc[255] != 2U) || (enc[256] != 255U)) {
+    fail(FRM_COBS, "255 bytes must be a full block and a one byte block");
+  }
+  make_frame(3U, 1U);
+  n = frmEncode(FRM_COBS, frame, frame_len, enc, sizeof enc);
+  if ((n != 3U) || (enc[0] != 1U) || (enc[1] != 1U) || (enc[2] != 0U)) {
+    fail(FRM_COBS, "a zero must be two empty blocks");
+  }
+  frame_len = 0U;
+  n = frmEncode(FRM_COBS, frame, frame_len, enc, sizeof enc);
+  if ((n != 2U) || (enc[0] != 1U) || (enc[1] != 0U)) {
+    fail(FRM_COBS, "the empty frame must be an empty block");
+  }
+}
+
+static void check_slip_escapes(void) {
+  static const uint8_t escaped[] = {
+    FRM_SLIP_END, FRM_SLIP_ESC, FRM_SLIP_ESC_END, 0x01U,
+    FRM_SLIP_ESC, FRM_SLIP_ESC_ESC, FRM_SLIP_END
+  };
+  static const uint8_t invalid[] = {
+    FRM_SLIP_END, 0x01U, FRM_SLIP_ESC, 0x02U, 0x03U, FRM_SLIP_END
+  };
+  uint8_t enc[16], buf[16];
+  FrameDecoder fd;
+
+  what = "SLIP escapes";
+  frame[0] = FRM_SLIP_END;
+  frame[1] = 0x01U;
+  frame[2] = FRM_SLIP_ESC;
+  frame_len = 3U;
+  if ((frmEncode(FRM_SLIP, frame, frame_len, enc, sizeof enc) != sizeof escaped) ||
+      (memcmp(enc, escaped, sizeof escaped) != 0)) {
+    fail(FRM_SLIP, "bad escape sequences");
+  }
+
+  /* An invalid escape drops the frame.*/
+  frmObjectInit(&fd, FRM_SLIP, buf, sizeof buf, received, NULL);
+  rx_frames = 0U;
+  frmDecode(&fd, invalid, sizeof invalid);
+  frmDecode(&fd, escaped, sizeof escaped);
+  if (frmGetErrorsX(&fd) != 1U) {
+    fail(FRM_SLIP, "invalid escape not dropped");
+  }
+  check_received(FRM_SLIP, 1U);
+}
+
+static void check_oversize(frmmode_t mode) {
+  uint8_t enc[MAX_ENCODED], buf[100];
+  FrameDecoder fd;
+  size_t n;
+
+  what = "oversize";
+  frmObjectInit(&fd, mode, buf, sizeof buf, received, NULL);
+  rx_frames = 0U;
+  make_frame(0U, sizeof buf + 1U);
+  n = frmEncode(mode, frame, frame_len, enc, sizeof enc);
+  frmDecode(&fd, enc, n);
+  if ((rx_frames != 0U) || (frmGetErrorsX(&fd) != 1U)) {
+    fail(mode, "oversized frame not dropped");
+  }
+  make_frame(0U, sizeof buf);
+  n = frmEncode(mode, frame, frame_len, enc, sizeof enc);
+  frmDecode(&fd, enc, n);
+  check_received(mode, 1U);
+}
+
+static void check_truncated(frmmode_t mode) {
+  uint8_t a[MAX_ENCODED], b[MAX_ENCODED], buf[MAX_FRAME];
+  FrameDecoder fd;
+  size_t na, nb;
+
+  what = "truncated";
+  make_frame(1U, 100U);
+  na = frmEncode(mode, frame, frame_len, a, sizeof a);
+  make_frame(0U, 40U);
+  nb = frmEncode(mode, frame, frame_len, b, sizeof b);
+
+  /* After a reset the rest of the interrupted frame is skipped.*/
+  frmObjectInit(&fd, mode, buf, sizeof buf, received, NULL);
+  rx_frames = 0U;
+  frmDecode(&fd, a, na / 2U);
+  frmReset(&fd);
+  if (mode != FRM_LENGTH) {
+    frmDecode(&fd, a + na / 2U, na - na / 2U);
+  }
+  frmDecode(&fd, b, nb);
+  check_received(mode, 1U);
+
+  /* Without a reset, the delimiters resynchronize the decoder.*/
+  if (mode == FRM_COBS) {
+    /* The next frame lands inside the truncated block, its delimiter drops
+       both, the frame after is received.*/
+    frmObjectInit(&fd, mode, buf, sizeof buf, received, NULL);
+    rx_frames = 0U;
+    frmDecode(&fd, a, na / 2U);
+    frmDecode(&fd, b, nb);
+    frmDecode(&fd, b, nb);
+    if (frmGetErrorsX(&fd) != 1U) {
+      fail(mode, "truncated frame not dropped");
+    }
+    check_received(mode, 1U);
+  }
+  else if (mode == FRM_SLIP) {
+    /* The leading END of the next frame ends the truncated one.*/
+    frmObjectInit(&fd, mode, buf, sizeof buf, received, NULL);
+    rx_frames = 0U;
+    frmDecode(&fd, a, na / 2U);
+    frmDecode(&fd, b, nb);
+    check_received(mode, 2U);
+  }
+}
+
+static void check_task(void *arg) {
+  static const size_t sizes[] = {
+    0U, 1U, 2U, 253U, 254U, 255U, 256U, 507U, 508U, 509U, MAX_FRAME
+  };
+  unsigned mode, kind, i, count = 0U;
+
+  (void)arg;
+  ibqObjectInit(&ibq, false, ibq_buffers, BQ_SIZE, BQ_NUM, NULL, NULL);
+  obqObjectInit(&obq, false, obq_buffers, BQ_SIZE, BQ_NUM, obq_notify, NULL);
+
+  check_cobs_blocks();
+  check_slip_escapes();
+  for (mode = FRM_COBS; mode <= FRM_LENGTH; mode++) {
+    for (kind = 0U; kind < 5U; kind++) {
+      for (i = 0; i < sizeof sizes / sizeof sizes[0]; i++) {
+        make_frame(kind, sizes[i]);
+        roundtrip_mem((frmmode_t)mode);
+        roundtrip_chn((frmmode_t)mode);
+        roundtrip_obq((frmmode_t)mode);
+        roundtrip_ibq((frmmode_t)mode);
+        count++;
+      }
+    }
+    check_oversize((frmmode_t)mode);
+    check_truncated((frmmode_t)mode);
+  }
+  printf("framing ok: %u frames\n", count);
+  exit(0);
+}
+
+int main(void) {
+
+  xTaskCreate(check_task, "check", 1024, NULL, 1, NULL);
+  vTaskStartScheduler();
+  return 1;
+}
+
+void errorAssertCalled(const char* file, unsigned long line, const char* reason){
+    fprintf(stderr, "Assertion failed: %s:%lu %s\n", file, line, reason ? reason : "");
+    abort();
+}
+
+void vApplicationStackOverflowHook( TaskHandle_t xTask, char *pcTaskName ){
+    (void)xTask;
+    fprintf(stderr, "Stack overflow in task %s\n", pcTaskName);
+    abort();
+}